@@ -398,6 +398,66 @@ static void test_hashes(void)
         test_hash(tests+i);
 }
 
+static void test_hash_large(void)
+{
+    static const struct
+    {
+        const WCHAR *alg;
+        ULONG        hash_size;
+        const char  *hash;
+    }
+    tests[] =
+    {
+        { L"SHA1", 20, "e3f92a7f0d923c8e43352f9cea7da0c26fb7829b" },
+        { L"SHA256", 32, "d24ac44c83cce842b67a82d2f77bcbe5e41dbd555605c92832d609e29c5a997c" },
+        { L"SHA512", 64,
+        "e8574e3b7110d918577432c13a1dac79fcbd908ad97f3e77ea4135fa14c2d8cb"
+        "35918cd109ba424862c7f24e3e0c51e41e9d609f6dd52ee494105148c6649731" },
+    };
+    static const ULONG chunks[] = { 4096, 64, 37, 1 };
+    BCRYPT_ALG_HANDLE alg;
+    BCRYPT_HASH_HANDLE hash;
+    UCHAR data[4096], hash_buf[64];
+    char str[129];
+    NTSTATUS ret;
+    ULONG i, j, k, len;
+
+    for (i = 0; i < sizeof(data); i++) data[i] = i * 7 + (i >> 8);
+
+    for (i = 0; i < ARRAY_SIZE(tests); i++)
+    {
+        alg = NULL;
+        ret = BCryptOpenAlgorithmProvider(&alg, tests[i].alg, MS_PRIMITIVE_PROVIDER, 0);
+        ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+
+        for (j = 0; j < ARRAY_SIZE(chunks); j++)
+        {
+            hash = NULL;
+            ret = BCryptCreateHash(alg, &hash, NULL, 0, NULL, 0, 0);
+            ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+
+            for (k = 0; k < sizeof(data); k += len)
+            {
+                len = min(chunks[j], sizeof(data) - k);
+                ret = BCryptHashData(hash, data + k, len, 0);
+                ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+            }
+
+            memset(hash_buf, 0, sizeof(hash_buf));
+            ret = BCryptFinishHash(hash, hash_buf, tests[i].hash_size, 0);
+            ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+            format_hash( hash_buf, tests[i].hash_size, str );
+            ok(!strcmp(str, tests[i].hash), "%s chunk %lu: got %s\n", wine_dbgstr_w(tests[i].alg), chunks[j], str);
+
+            ret = BCryptDestroyHash(hash);
+            ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+        }
+
+        ret = BCryptCloseAlgorithmProvider(alg, 0);
+        ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+    }
+}
+
 static void test_BcryptHash(void)
 {
     static const char expected[] =
@@ -3469,6 +3529,7 @@ START_TEST(bcrypt)
     test_BCryptGenRandom();
     test_BCryptGetFipsAlgorithmMode();
     test_hashes();
+    test_hash_large();
     test_BcryptHash();
     test_BcryptDeriveKeyPBKDF2();
     test_rng();
@@ -845,6 +845,15 @@ BOOL WINAPI CertSetCertificateContextProperty(PCCERT_CONTEXT pCertContext,
     }
     ret = CertContext_SetProperty(cert_from_ptr(pCertContext), dwPropId, dwFlags,
      pvData);
+    if (ret)
+    {
+        context_t *context;
+
+        /* Properties are shared with linked contexts, so all their stores
+         * have changed as far as indexes and cached chains are concerned. */
+        for (context = &cert_from_ptr(pCertContext)->base; context; context = context->linked)
+            InterlockedIncrement(&context->store->generation);
+    }
     TRACE("returning %d\n", ret);
     return ret;
 }
@@ -1620,6 +1629,43 @@ static inline PCCERT_CONTEXT cert_compare_certs_in_store(HCERTSTORE store,
 typedef PCCERT_CONTEXT (*CertFindFunc)(HCERTSTORE store, DWORD dwType,
  DWORD dwFlags, const void *pvPara, PCCERT_CONTEXT prev);
 
+/* Looks up the first certificate in the store matching a subject name or key
+ * identifier through the store's index.  Returns FALSE if the store can't
+ * answer the query this way, in which case the caller must enumerate it.
+ */
+static BOOL find_cert_in_index(HCERTSTORE hCertStore, DWORD dwType,
+ const void *pvPara, PCCERT_CONTEXT *ret)
+{
+    WINECRYPT_CERTSTORE *store = hCertStore;
+    const CRYPT_DATA_BLOB *key;
+    CertIndexType type;
+    context_t *found;
+
+    if (dwType == CERT_FIND_SUBJECT_NAME)
+    {
+        type = CertIndexSubject;
+        key = pvPara;
+    }
+    else if ((dwType >> CERT_COMPARE_SHIFT) == CERT_COMPARE_CERT_ID ||
+     (dwType >> CERT_COMPARE_SHIFT) == CERT_COMPARE_KEY_IDENTIFIER)
+    {
+        const CERT_ID *id = pvPara;
+
+        if (id->dwIdChoice != CERT_ID_KEY_IDENTIFIER)
+            return FALSE;
+        type = CertIndexKeyId;
+        key = &id->u.KeyId;
+    }
+    else
+        return FALSE;
+
+    if (!store || store->dwMagic != WINE_CRYPTCERTSTORE_MAGIC ||
+     !store->vtbl->findCert || !store->vtbl->findCert(store, type, key, &found))
+        return FALSE;
+    *ret = found ? context_ptr(found) : NULL;
+    return TRUE;
+}
+
 static PCCERT_CONTEXT find_cert_any(HCERTSTORE store, DWORD dwType,
  DWORD dwFlags, const void *pvPara, PCCERT_CONTEXT prev)
 {
@@ -1872,8 +1918,11 @@ PCCERT_CONTEXT WINAPI CertFindCertificateInStore(HCERTSTORE hCertStore,
     if (find)
         ret = find(hCertStore, dwType, dwFlags, pvPara, pPrevCertContext);
     else if (compare)
-        ret = cert_compare_certs_in_store(hCertStore, pPrevCertContext,
-         compare, dwType, dwFlags, pvPara);
+    {
+        if (pPrevCertContext || !find_cert_in_index(hCertStore, dwType, pvPara, &ret))
+            ret = cert_compare_certs_in_store(hCertStore, pPrevCertContext,
+             compare, dwType, dwFlags, pvPara);
+    }
     else
         ret = NULL;
     if (!ret)
@@ -34,6 +34,7 @@ WINE_DEFAULT_DEBUG_CHANNEL(crypt);
 WINE_DECLARE_DEBUG_CHANNEL(chain);
 
 #define DEFAULT_CYCLE_MODULUS 7
+#define DEFAULT_MAX_CACHED_CHAINS 64
 
 /* This represents a subset of a certificate chain engine:  it doesn't include
  * the "hOther" store described by MSDN, because I'm not sure how that's used.
@@ -49,8 +50,31 @@ typedef struct _CertificateChainEngine
     DWORD      dwUrlRetrievalTimeout;
     DWORD      MaximumCachedCertificates;
     DWORD      CycleDetectionModulus;
+    CRITICAL_SECTION cs;
+    struct list chain_cache;
+    DWORD      chain_cache_count;
 } CertificateChainEngine;
 
+/* Chains built at the current time are cached in their engine, most recently
+ * used first.  An entry is keyed on everything the chain was built from: the
+ * end certificate, the flags, the requested usage and the certificates in the
+ * additional store.  It's dropped once the engine's stores change or the
+ * first certificate in the chain expires.
+ * The cached chain has no end certificate, and its issuers are the engine's
+ * own contexts, so it doesn't keep the caller's certificates or stores alive.
+ * Chains with issuers that aren't in the engine's stores aren't cached.  A
+ * cache hit returns a copy of the chain with the caller's end certificate.
+ */
+struct chain_cache_entry
+{
+    struct list          entry;
+    BYTE                *key;
+    DWORD                key_size;
+    LONG                 generation;
+    FILETIME             expires;
+    PCCERT_CHAIN_CONTEXT chain;
+};
+
 static inline void CRYPT_AddStoresToCollection(HCERTSTORE collection,
  DWORD cStores, HCERTSTORE *stores)
 {
@@ -136,6 +160,10 @@ HCERTCHAINENGINE CRYPT_CreateChainEngine(HCERTSTORE root, DWORD system_store, co
 
     engine->ref = 1;
     engine->hRoot = root;
+    InitializeCriticalSection(&engine->cs);
+    engine->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": CertificateChainEngine.cs");
+    list_init(&engine->chain_cache);
+    engine->chain_cache_count = 0;
     engine->hWorld = CertOpenStore(CERT_STORE_PROV_COLLECTION, 0, 0, CERT_STORE_CREATE_NEW_FLAG, NULL);
     worldStores[0] = CertDuplicateStore(engine->hRoot);
     worldStores[1] = CertOpenStore(CERT_STORE_PROV_SYSTEM_W, 0, 0, system_store, L"CA");
@@ -194,11 +222,25 @@ static CertificateChainEngine *get_chain_engine(HCERTCHAINENGINE handle, BOOL al
     return (CertificateChainEngine*)handle;
 }
 
+static void free_chain_cache_entry(struct chain_cache_entry *entry)
+{
+    list_remove(&entry->entry);
+    CertFreeCertificateChain(entry->chain);
+    CryptMemFree(entry->key);
+    CryptMemFree(entry);
+}
+
 static void free_chain_engine(CertificateChainEngine *engine)
 {
+    struct chain_cache_entry *entry, *next;
+
     if(!engine || InterlockedDecrement(&engine->ref))
         return;
 
+    LIST_FOR_EACH_ENTRY_SAFE(entry, next, &engine->chain_cache, struct chain_cache_entry, entry)
+        free_chain_cache_entry(entry);
+    engine->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection(&engine->cs);
     CertCloseStore(engine->hWorld, 0);
     CertCloseStore(engine->hRoot, 0);
     CryptMemFree(engine);
@@ -2872,6 +2914,271 @@ static void dump_chain_para(const CERT_CHAIN_PARA *pChainPara)
     }
 }
 
+struct chain_cache_key
+{
+    BYTE *data;
+    DWORD size;
+    DWORD alloc;
+};
+
+static BOOL chain_cache_key_append(struct chain_cache_key *key, const void *data, DWORD size)
+{
+    if (key->size + size > key->alloc)
+    {
+        DWORD alloc = max(key->alloc * 2, key->size + size);
+        BYTE *buf = CryptMemRealloc(key->data, alloc);
+
+        if (!buf)
+            return FALSE;
+        key->data = buf;
+        key->alloc = alloc;
+    }
+    memcpy(key->data + key->size, data, size);
+    key->size += size;
+    return TRUE;
+}
+
+static BOOL chain_cache_key_append_cert(struct chain_cache_key *key, PCCERT_CONTEXT cert)
+{
+    BYTE hash[20];
+    DWORD size = sizeof(hash);
+
+    return CertGetCertificateContextProperty(cert, CERT_HASH_PROP_ID, hash, &size) &&
+     chain_cache_key_append(key, hash, size);
+}
+
+/* Builds the key a chain is cached under, or returns FALSE if the chain
+ * mustn't be cached.
+ */
+static BOOL chain_cache_make_key(struct chain_cache_key *key, PCCERT_CONTEXT cert,
+ LPFILETIME pTime, HCERTSTORE hAdditionalStore, const CERT_CHAIN_PARA *pChainPara,
+ DWORD dwFlags)
+{
+    static const DWORD revocation_flags = CERT_CHAIN_REVOCATION_CHECK_END_CERT |
+     CERT_CHAIN_REVOCATION_CHECK_CHAIN | CERT_CHAIN_REVOCATION_CHECK_CHAIN_EXCLUDE_ROOT;
+    BOOL ret;
+
+    memset(key, 0, sizeof(*key));
+    if (pTime || (dwFlags & (revocation_flags | CERT_CHAIN_RETURN_LOWER_QUALITY_CONTEXTS)))
+        return FALSE;
+
+    ret = chain_cache_key_append_cert(key, cert) &&
+     chain_cache_key_append(key, &dwFlags, sizeof(dwFlags));
+    if (ret && pChainPara->cbSize >= sizeof(CERT_CHAIN_PARA_NO_EXTRA_FIELDS))
+    {
+        const CERT_USAGE_MATCH *usage = &pChainPara->RequestedUsage;
+        DWORD i;
+
+        ret = chain_cache_key_append(key, &usage->dwType, sizeof(usage->dwType)) &&
+         chain_cache_key_append(key, &usage->Usage.cUsageIdentifier,
+         sizeof(usage->Usage.cUsageIdentifier));
+        for (i = 0; ret && i < usage->Usage.cUsageIdentifier; i++)
+            ret = chain_cache_key_append(key, usage->Usage.rgpszUsageIdentifier[i],
+             strlen(usage->Usage.rgpszUsageIdentifier[i]) + 1);
+    }
+    if (ret && hAdditionalStore)
+    {
+        PCCERT_CONTEXT additional = NULL;
+
+        while (ret && (additional = CertEnumCertificatesInStore(hAdditionalStore, additional)))
+            ret = chain_cache_key_append_cert(key, additional);
+        if (additional)
+            CertFreeCertificateContext(additional);
+    }
+    if (!ret)
+    {
+        CryptMemFree(key->data);
+        key->data = NULL;
+    }
+    return ret;
+}
+
+static LONG chain_engine_generation(const CertificateChainEngine *engine)
+{
+    WINECRYPT_CERTSTORE *world = engine->hWorld;
+
+    return world ? world->vtbl->generation(world) : 0;
+}
+
+static PCCERT_CHAIN_CONTEXT chain_cache_lookup(CertificateChainEngine *engine,
+ const struct chain_cache_key *key, LONG generation)
+{
+    struct chain_cache_entry *entry, *next;
+    PCCERT_CHAIN_CONTEXT ret = NULL;
+    FILETIME now;
+
+    GetSystemTimeAsFileTime(&now);
+    EnterCriticalSection(&engine->cs);
+    LIST_FOR_EACH_ENTRY_SAFE(entry, next, &engine->chain_cache, struct chain_cache_entry, entry)
+    {
+        if (entry->generation != generation || CompareFileTime(&now, &entry->expires) > 0)
+        {
+            free_chain_cache_entry(entry);
+            engine->chain_cache_count--;
+            continue;
+        }
+        if (entry->key_size == key->size && !memcmp(entry->key, key->data, key->size))
+        {
+            list_remove(&entry->entry);
+            list_add_head(&engine->chain_cache, &entry->entry);
+            ret = CertDuplicateCertificateChain(entry->chain);
+            break;
+        }
+    }
+    LeaveCriticalSection(&engine->cs);
+    return ret;
+}
+
+/* Makes a copy of chain, trust status included, using contexts[i] as the
+ * certificate of element i.
+ */
+static PCERT_SIMPLE_CHAIN chain_cache_copy_simple_chain(const CERT_SIMPLE_CHAIN *chain,
+ const PCCERT_CONTEXT *contexts)
+{
+    PCERT_SIMPLE_CHAIN copy = CryptMemAlloc(sizeof(CERT_SIMPLE_CHAIN));
+    DWORD i;
+
+    if (!copy)
+        return NULL;
+    *copy = *chain;
+    copy->cElement = 0;
+    if (!(copy->rgpElement = CryptMemAlloc(chain->cElement * sizeof(PCERT_CHAIN_ELEMENT))))
+    {
+        CryptMemFree(copy);
+        return NULL;
+    }
+    for (i = 0; i < chain->cElement; i++)
+    {
+        PCERT_CHAIN_ELEMENT element = CryptMemAlloc(sizeof(CERT_CHAIN_ELEMENT));
+
+        if (!element)
+        {
+            CRYPT_FreeSimpleChain(copy);
+            return NULL;
+        }
+        *element = *chain->rgpElement[i];
+        element->pCertContext = CertDuplicateCertificateContext(contexts[i]);
+        copy->rgpElement[copy->cElement++] = element;
+    }
+    return copy;
+}
+
+static CertificateChain *chain_cache_copy_chain(const CERT_CHAIN_CONTEXT *chain,
+ const PCCERT_CONTEXT *contexts)
+{
+    CertificateChain *copy = CryptMemAlloc(sizeof(CertificateChain));
+
+    if (!copy)
+        return NULL;
+    copy->ref = 1;
+    copy->world = NULL;
+    copy->context = *chain;
+    copy->context.cChain = 0;
+    copy->context.cLowerQualityChainContext = 0;
+    copy->context.rgpLowerQualityChainContext = NULL;
+    if (!(copy->context.rgpChain = CryptMemAlloc(sizeof(PCERT_SIMPLE_CHAIN))) ||
+     !(copy->context.rgpChain[0] = chain_cache_copy_simple_chain(chain->rgpChain[0], contexts)))
+    {
+        CRYPT_FreeChainContext(copy);
+        return NULL;
+    }
+    copy->context.cChain = 1;
+    return copy;
+}
+
+/* Returns the engine's own context for cert, or NULL if it's not in the
+ * engine's stores.
+ */
+static PCCERT_CONTEXT chain_cache_find_engine_cert(CertificateChainEngine *engine,
+ PCCERT_CONTEXT cert)
+{
+    BYTE hash[20];
+    CRYPT_HASH_BLOB blob = { sizeof(hash), hash };
+
+    if (!engine->hWorld ||
+     !CertGetCertificateContextProperty(cert, CERT_HASH_PROP_ID, hash, &blob.cbData))
+        return NULL;
+    return CertFindCertificateInStore(engine->hWorld, cert->dwCertEncodingType, 0,
+     CERT_FIND_SHA1_HASH, &blob, NULL);
+}
+
+/* Returns a copy of the cached chain, with cert as its end certificate. */
+static PCCERT_CHAIN_CONTEXT chain_cache_instantiate(PCCERT_CHAIN_CONTEXT cached,
+ PCCERT_CONTEXT cert)
+{
+    const CERT_SIMPLE_CHAIN *simple = cached->rgpChain[0];
+    CertificateChain *chain = NULL;
+    PCCERT_CONTEXT *contexts;
+    DWORD i;
+
+    if ((contexts = CryptMemAlloc(simple->cElement * sizeof(PCCERT_CONTEXT))))
+    {
+        contexts[0] = cert;
+        for (i = 1; i < simple->cElement; i++)
+            contexts[i] = simple->rgpElement[i]->pCertContext;
+        chain = chain_cache_copy_chain(cached, contexts);
+        CryptMemFree(contexts);
+    }
+    return chain ? &chain->context : NULL;
+}
+
+static void chain_cache_add(CertificateChainEngine *engine, struct chain_cache_key *key,
+ LONG generation, PCCERT_CHAIN_CONTEXT chain)
+{
+    DWORD max_count = engine->MaximumCachedCertificates ? engine->MaximumCachedCertificates : DEFAULT_MAX_CACHED_CHAINS;
+    const CERT_SIMPLE_CHAIN *simple;
+    struct chain_cache_entry *entry;
+    CertificateChain *cached = NULL;
+    PCCERT_CONTEXT *contexts;
+    DWORD i;
+
+    if (chain->cChain != 1 || chain->cLowerQualityChainContext ||
+     (chain->TrustStatus.dwErrorStatus & (CERT_TRUST_IS_NOT_TIME_VALID | CERT_TRUST_IS_PARTIAL_CHAIN)))
+        return;
+    simple = chain->rgpChain[0];
+    if (!(contexts = CryptMemAlloc(simple->cElement * sizeof(PCCERT_CONTEXT))))
+        return;
+    contexts[0] = NULL;
+    for (i = 1; i < simple->cElement; i++)
+        if (!(contexts[i] = chain_cache_find_engine_cert(engine, simple->rgpElement[i]->pCertContext)))
+            break;
+    if (i == simple->cElement)
+        cached = chain_cache_copy_chain(chain, contexts);
+    while (--i)
+        CertFreeCertificateContext(contexts[i]);
+    CryptMemFree(contexts);
+    if (!cached)
+        return;
+    if (!(entry = CryptMemAlloc(sizeof(*entry))))
+    {
+        CertFreeCertificateChain(&cached->context);
+        return;
+    }
+
+    entry->key = key->data;
+    entry->key_size = key->size;
+    key->data = NULL;
+    entry->generation = generation;
+    entry->expires.dwLowDateTime = entry->expires.dwHighDateTime = ~0u;
+    for (i = 0; i < simple->cElement; i++)
+    {
+        const FILETIME *not_after = &simple->rgpElement[i]->pCertContext->pCertInfo->NotAfter;
+
+        if (CompareFileTime(not_after, &entry->expires) < 0)
+            entry->expires = *not_after;
+    }
+    entry->chain = &cached->context;
+
+    EnterCriticalSection(&engine->cs);
+    list_add_head(&engine->chain_cache, &entry->entry);
+    if (++engine->chain_cache_count > max_count)
+    {
+        free_chain_cache_entry(LIST_ENTRY(list_tail(&engine->chain_cache), struct chain_cache_entry, entry));
+        engine->chain_cache_count--;
+    }
+    LeaveCriticalSection(&engine->cs);
+}
+
 BOOL WINAPI CertGetCertificateChain(HCERTCHAINENGINE hChainEngine,
  PCCERT_CONTEXT pCertContext, LPFILETIME pTime, HCERTSTORE hAdditionalStore,
  PCERT_CHAIN_PARA pChainPara, DWORD dwFlags, LPVOID pvReserved,
@@ -2880,6 +3187,9 @@ BOOL WINAPI CertGetCertificateChain(HCERTCHAINENGINE hChainEngine,
     CertificateChainEngine *engine;
     BOOL ret;
     CertificateChain *chain = NULL;
+    struct chain_cache_key key;
+    PCCERT_CHAIN_CONTEXT cached;
+    LONG generation = 0;
 
     TRACE("(%p, %p, %s, %p, %p, %08lx, %p, %p)\n", hChainEngine, pCertContext,
      debugstr_filetime(pTime), hAdditionalStore, pChainPara, dwFlags,
@@ -2904,6 +3214,26 @@ BOOL WINAPI CertGetCertificateChain(HCERTCHAINENGINE hChainEngine,
 
     if (TRACE_ON(chain))
         dump_chain_para(pChainPara);
+    if (chain_cache_make_key(&key, pCertContext, pTime, hAdditionalStore, pChainPara, dwFlags))
+    {
+        generation = chain_engine_generation(engine);
+        if ((cached = chain_cache_lookup(engine, &key, generation)))
+        {
+            PCCERT_CHAIN_CONTEXT copy = chain_cache_instantiate(cached, pCertContext);
+
+            CertFreeCertificateChain(cached);
+            if (copy)
+            {
+                TRACE_(chain)("using cached chain %p\n", cached);
+                CryptMemFree(key.data);
+                if (ppChainContext)
+                    *ppChainContext = copy;
+                else
+                    CertFreeCertificateChain(copy);
+                return TRUE;
+            }
+        }
+    }
     /* FIXME: what about HCCE_LOCAL_MACHINE? */
     ret = CRYPT_BuildCandidateChainFromCert(engine, pCertContext, pTime,
      hAdditionalStore, dwFlags, &chain);
@@ -2932,11 +3262,14 @@ BOOL WINAPI CertGetCertificateChain(HCERTCHAINENGINE hChainEngine,
         CRYPT_CheckUsages(pChain, pChainPara);
         TRACE_(chain)("error status: %08lx\n",
          pChain->TrustStatus.dwErrorStatus);
+        if (key.data)
+            chain_cache_add(engine, &key, generation, pChain);
         if (ppChainContext)
             *ppChainContext = pChain;
         else
             CertFreeCertificateChain(pChain);
     }
+    CryptMemFree(key.data);
     TRACE("returning %d\n", ret);
     return ret;
 }
@@ -441,6 +441,51 @@ static BOOL Collection_control(WINECRYPT_CERTSTORE *cert_store, DWORD dwFlags,
     return ret;
 }
 
+static BOOL Collection_findCert(WINECRYPT_CERTSTORE *store, CertIndexType type,
+ const CRYPT_DATA_BLOB *key, context_t **ret)
+{
+    WINE_COLLECTIONSTORE *cs = (WINE_COLLECTIONSTORE*)store;
+    WINE_STORE_LIST_ENTRY *entry;
+    context_t *child = NULL;
+    BOOL supported = TRUE;
+
+    TRACE("(%p, %d, %p)\n", store, type, key);
+
+    *ret = NULL;
+    EnterCriticalSection(&cs->cs);
+    LIST_FOR_EACH_ENTRY(entry, &cs->stores, WINE_STORE_LIST_ENTRY, entry)
+    {
+        if (!entry->store->vtbl->findCert ||
+         !entry->store->vtbl->findCert(entry->store, type, key, &child))
+        {
+            supported = FALSE;
+            break;
+        }
+        if (child)
+        {
+            *ret = CRYPT_CollectionCreateContextFromChild(cs, entry, child);
+            Context_Release(child);
+            supported = *ret != NULL;
+            break;
+        }
+    }
+    LeaveCriticalSection(&cs->cs);
+    return supported;
+}
+
+static LONG Collection_generation(WINECRYPT_CERTSTORE *store)
+{
+    WINE_COLLECTIONSTORE *cs = (WINE_COLLECTIONSTORE*)store;
+    WINE_STORE_LIST_ENTRY *entry;
+    LONG ret = store->generation;
+
+    EnterCriticalSection(&cs->cs);
+    LIST_FOR_EACH_ENTRY(entry, &cs->stores, WINE_STORE_LIST_ENTRY, entry)
+        ret += entry->store->vtbl->generation(entry->store);
+    LeaveCriticalSection(&cs->cs);
+    return ret;
+}
+
 static const store_vtbl_t CollectionStoreVtbl = {
     Collection_addref,
     Collection_release,
@@ -458,7 +503,9 @@ static const store_vtbl_t CollectionStoreVtbl = {
         Collection_addCTL,
         Collection_enumCTL,
         Collection_deleteCTL
-    }
+    },
+    Collection_findCert,
+    Collection_generation
 };
 
 WINECRYPT_CERTSTORE *CRYPT_CollectionOpenStore(HCRYPTPROV hCryptProv,
@@ -545,6 +592,7 @@ BOOL WINAPI CertAddStoreToCollection(HCERTSTORE hCollectionStore,
         }
         else
             list_add_tail(&collection->stores, &entry->entry);
+        InterlockedIncrement(&collection->hdr.generation);
         LeaveCriticalSection(&collection->cs);
         ret = TRUE;
     }
@@ -581,6 +629,10 @@ void WINAPI CertRemoveStoreFromCollection(HCERTSTORE hCollectionStore,
     {
         if (store->store == sibling)
         {
+            /* Fold the sibling's generation in, so that the collection's
+             * generation keeps increasing after the sibling is gone. */
+            InterlockedExchangeAdd(&collection->hdr.generation,
+             sibling->vtbl->generation(sibling) + 1);
             list_remove(&store->entry);
             CertCloseStore(store->store, 0);
             CryptMemFree(store);
@@ -294,6 +294,11 @@ typedef enum _CertStoreType {
     StoreTypeEmpty
 } CertStoreType;
 
+typedef enum _CertIndexType {
+    CertIndexSubject,
+    CertIndexKeyId
+} CertIndexType;
+
 #define WINE_CRYPTCERTSTORE_MAGIC 0x74726563
 
 /* A cert store is polymorphic through the use of function pointers.  A type
@@ -302,6 +307,11 @@ typedef enum _CertStoreType {
  * - closeStore is called when the store's ref count becomes 0
  * - control is optional, but should be implemented by any store that supports
  *   persistence
+ * - findCert returns in *ret the first certificate, in enumeration order,
+ *   whose subject name or key identifier matches key.  It returns FALSE if the
+ *   store can't answer the query without being enumerated.
+ * - generation returns a value that changes whenever the contents of the store
+ *   or of any store it contains change
  */
 
 typedef struct {
@@ -312,6 +322,8 @@ typedef struct {
     CONTEXT_FUNCS certs;
     CONTEXT_FUNCS crls;
     CONTEXT_FUNCS ctls;
+    BOOL (*findCert)(struct WINE_CRYPTCERTSTORE*,CertIndexType,const CRYPT_DATA_BLOB*,context_t**);
+    LONG (*generation)(struct WINE_CRYPTCERTSTORE*);
 } store_vtbl_t;
 
 typedef struct WINE_CRYPTCERTSTORE
@@ -322,6 +334,7 @@ typedef struct WINE_CRYPTCERTSTORE
     CertStoreType               type;
     const store_vtbl_t         *vtbl;
     CONTEXT_PROPERTY_LIST      *properties;
+    LONG                        generation;
 } WINECRYPT_CERTSTORE;
 
 void CRYPT_InitStore(WINECRYPT_CERTSTORE *store, DWORD dwFlags,
@@ -284,6 +284,31 @@ static BOOL ProvStore_control(WINECRYPT_CERTSTORE *cert_store, DWORD dwFlags, DW
     return ret;
 }
 
+static BOOL ProvStore_findCert(WINECRYPT_CERTSTORE *store, CertIndexType type,
+ const CRYPT_DATA_BLOB *key, context_t **ret)
+{
+    WINE_PROVIDERSTORE *ps = (WINE_PROVIDERSTORE*)store;
+
+    if (!ps->memStore || !ps->memStore->vtbl->findCert ||
+     !ps->memStore->vtbl->findCert(ps->memStore, type, key, ret))
+        return FALSE;
+
+    /* same dirty trick as ProvStore_enumCert */
+    if (*ret)
+        ((cert_t*)*ret)->ctx.hCertStore = store;
+    return TRUE;
+}
+
+static LONG ProvStore_generation(WINECRYPT_CERTSTORE *store)
+{
+    WINE_PROVIDERSTORE *ps = (WINE_PROVIDERSTORE*)store;
+    LONG ret = store->generation;
+
+    if (ps->memStore)
+        ret += ps->memStore->vtbl->generation(ps->memStore);
+    return ret;
+}
+
 static const store_vtbl_t ProvStoreVtbl = {
     ProvStore_addref,
     ProvStore_release,
@@ -301,7 +326,9 @@ static const store_vtbl_t ProvStoreVtbl = {
         ProvStore_addCTL,
         ProvStore_enumCTL,
         ProvStore_deleteCTL
-    }
+    },
+    ProvStore_findCert,
+    ProvStore_generation
 };
 
 WINECRYPT_CERTSTORE *CRYPT_ProvCreateStore(DWORD dwFlags,
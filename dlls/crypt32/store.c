@@ -76,6 +76,27 @@ static const WINE_CONTEXT_INTERFACE gCTLInterface = {
 };
 const WINE_CONTEXT_INTERFACE *pCTLInterface = &gCTLInterface;
 
+/* An index of a memory store's certificates by subject name and by key
+ * identifier.  Each bucket chains 1-based entry indices in enumeration order,
+ * so the first match found is the one enumeration would have returned.  The
+ * index is rebuilt lazily when the store's generation moves on.
+ */
+typedef struct _cert_index_entry
+{
+    DWORD      hash;
+    unsigned   next;
+    context_t *context;
+} cert_index_entry;
+
+typedef struct _cert_index
+{
+    LONG              generation;
+    BOOL              valid;
+    unsigned          mask;
+    unsigned         *buckets[2];
+    cert_index_entry *entries[2];
+} cert_index;
+
 typedef struct _WINE_MEMSTORE
 {
     WINECRYPT_CERTSTORE hdr;
@@ -83,6 +104,7 @@ typedef struct _WINE_MEMSTORE
     struct list certs;
     struct list crls;
     struct list ctls;
+    cert_index index;
 } WINE_MEMSTORE;
 
 void CRYPT_InitStore(WINECRYPT_CERTSTORE *store, DWORD dwFlags, CertStoreType type, const store_vtbl_t *vtbl)
@@ -93,6 +115,7 @@ void CRYPT_InitStore(WINECRYPT_CERTSTORE *store, DWORD dwFlags, CertStoreType ty
     store->dwOpenFlags = dwFlags;
     store->vtbl = vtbl;
     store->properties = NULL;
+    store->generation = 0;
 }
 
 void CRYPT_FreeStore(WINECRYPT_CERTSTORE *store)
@@ -162,6 +185,7 @@ static BOOL MemStore_addContext(WINE_MEMSTORE *store, struct list *list, context
     }else {
         list_add_head(list, &context->u.entry);
     }
+    InterlockedIncrement(&store->hdr.generation);
     LeaveCriticalSection(&store->cs);
 
     if(ret_context)
@@ -203,6 +227,7 @@ static BOOL MemStore_deleteContext(WINE_MEMSTORE *store, context_t *context)
     if (!list_empty(&context->u.entry)) {
         list_remove(&context->u.entry);
         list_init(&context->u.entry);
+        InterlockedIncrement(&store->hdr.generation);
         in_list = TRUE;
     }
     LeaveCriticalSection(&store->cs);
@@ -258,6 +283,167 @@ static BOOL MemStore_deleteCert(WINECRYPT_CERTSTORE *store, context_t *context)
     return MemStore_deleteContext(ms, context);
 }
 
+static DWORD cert_index_hash(const BYTE *data, DWORD size)
+{
+    DWORD hash = 2166136261u, i;
+
+    for (i = 0; i < size; i++)
+        hash = (hash ^ data[i]) * 16777619;
+    return hash;
+}
+
+/* Returns the certificate's key identifier in buf, or in a newly allocated
+ * buffer if it doesn't fit, or NULL if the certificate doesn't have one.
+ */
+static BYTE *cert_index_get_key_id(const CERT_CONTEXT *cert, BYTE *buf, DWORD *size)
+{
+    BYTE *ret = buf;
+
+    if (!CertGetCertificateContextProperty(cert, CERT_KEY_IDENTIFIER_PROP_ID, NULL, size))
+        return NULL;
+    if (*size > 64 && !(ret = CryptMemAlloc(*size)))
+        return NULL;
+    if (!CertGetCertificateContextProperty(cert, CERT_KEY_IDENTIFIER_PROP_ID, ret, size))
+    {
+        if (ret != buf)
+            CryptMemFree(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+static BOOL cert_index_matches(context_t *context, CertIndexType type, const CRYPT_DATA_BLOB *key)
+{
+    const CERT_CONTEXT *cert = context_ptr(context);
+    BYTE buf[64], *id;
+    DWORD size;
+    BOOL ret;
+
+    if (type == CertIndexSubject)
+        return cert->pCertInfo->Subject.cbData == key->cbData &&
+         !memcmp(cert->pCertInfo->Subject.pbData, key->pbData, key->cbData);
+
+    if (!(id = cert_index_get_key_id(cert, buf, &size)))
+        return FALSE;
+    ret = size == key->cbData && !memcmp(id, key->pbData, size);
+    if (id != buf)
+        CryptMemFree(id);
+    return ret;
+}
+
+static void cert_index_free(cert_index *index)
+{
+    unsigned i;
+
+    for (i = 0; i < ARRAY_SIZE(index->buckets); i++)
+    {
+        CryptMemFree(index->buckets[i]);
+        CryptMemFree(index->entries[i]);
+        index->buckets[i] = NULL;
+        index->entries[i] = NULL;
+    }
+    index->valid = FALSE;
+}
+
+/* Called with the store's critical section held. */
+static BOOL cert_index_build(WINE_MEMSTORE *store)
+{
+    cert_index *index = &store->index;
+    unsigned count = 0, size = 16, i, n[2] = { 0 };
+    context_t *context;
+
+    cert_index_free(index);
+    index->generation = store->hdr.generation;
+
+    LIST_FOR_EACH_ENTRY(context, &store->certs, context_t, u.entry)
+        count++;
+    while (size < count * 2)
+        size *= 2;
+    index->mask = size - 1;
+    for (i = 0; i < ARRAY_SIZE(index->buckets); i++)
+    {
+        index->buckets[i] = CryptMemAlloc(size * sizeof(*index->buckets[i]));
+        index->entries[i] = CryptMemAlloc(max(count, 1) * sizeof(*index->entries[i]));
+        if (!index->buckets[i] || !index->entries[i])
+        {
+            cert_index_free(index);
+            return FALSE;
+        }
+        memset(index->buckets[i], 0, size * sizeof(*index->buckets[i]));
+    }
+
+    /* Walk the list backwards, pushing each entry on its bucket's head. */
+    LIST_FOR_EACH_ENTRY_REV(context, &store->certs, context_t, u.entry)
+    {
+        const CERT_CONTEXT *cert = context_ptr(context);
+        cert_index_entry *entry;
+        BYTE buf[64], *id;
+        DWORD id_size;
+
+        entry = &index->entries[CertIndexSubject][n[CertIndexSubject]++];
+        entry->hash = cert_index_hash(cert->pCertInfo->Subject.pbData, cert->pCertInfo->Subject.cbData);
+        entry->context = context;
+        entry->next = index->buckets[CertIndexSubject][entry->hash & index->mask];
+        index->buckets[CertIndexSubject][entry->hash & index->mask] = n[CertIndexSubject];
+
+        if ((id = cert_index_get_key_id(cert, buf, &id_size)))
+        {
+            entry = &index->entries[CertIndexKeyId][n[CertIndexKeyId]++];
+            entry->hash = cert_index_hash(id, id_size);
+            entry->context = context;
+            entry->next = index->buckets[CertIndexKeyId][entry->hash & index->mask];
+            index->buckets[CertIndexKeyId][entry->hash & index->mask] = n[CertIndexKeyId];
+            if (id != buf)
+                CryptMemFree(id);
+        }
+    }
+    index->valid = TRUE;
+    return TRUE;
+}
+
+static BOOL MemStore_findCert(WINECRYPT_CERTSTORE *store, CertIndexType type,
+ const CRYPT_DATA_BLOB *key, context_t **ret)
+{
+    WINE_MEMSTORE *ms = (WINE_MEMSTORE *)store;
+    cert_index *index = &ms->index;
+    context_t *found = NULL;
+    DWORD hash;
+    unsigned i;
+
+    TRACE("(%p, %d, %p)\n", store, type, key);
+
+    EnterCriticalSection(&ms->cs);
+    if (!index->valid || index->generation != ms->hdr.generation)
+    {
+        if (!cert_index_build(ms))
+        {
+            LeaveCriticalSection(&ms->cs);
+            return FALSE;
+        }
+    }
+    hash = cert_index_hash(key->pbData, key->cbData);
+    for (i = index->buckets[type][hash & index->mask]; i; i = index->entries[type][i - 1].next)
+    {
+        const cert_index_entry *entry = &index->entries[type][i - 1];
+
+        if (entry->hash == hash && cert_index_matches(entry->context, type, key))
+        {
+            found = entry->context;
+            Context_AddRef(found);
+            break;
+        }
+    }
+    LeaveCriticalSection(&ms->cs);
+
+    *ret = found;
+    return TRUE;
+}
+
+static LONG MemStore_generation(WINECRYPT_CERTSTORE *store)
+{
+    return store->generation;
+}
+
 static BOOL MemStore_addCRL(WINECRYPT_CERTSTORE *store, context_t *crl,
  context_t *toReplace, context_t **ppStoreContext, BOOL use_link)
 {
@@ -336,6 +522,7 @@ static DWORD MemStore_release(WINECRYPT_CERTSTORE *cert_store, DWORD flags)
     free_contexts(&store->certs);
     free_contexts(&store->crls);
     free_contexts(&store->ctls);
+    cert_index_free(&store->index);
     store->cs.DebugInfo->Spare[0] = 0;
     DeleteCriticalSection(&store->cs);
     CRYPT_FreeStore(&store->hdr);
@@ -366,7 +553,9 @@ static const store_vtbl_t MemStoreVtbl = {
         MemStore_addCTL,
         MemStore_enumCTL,
         MemStore_deleteCTL
-    }
+    },
+    MemStore_findCert,
+    MemStore_generation
 };
 
 static WINECRYPT_CERTSTORE *CRYPT_MemOpenStore(HCRYPTPROV hCryptProv,
@@ -1480,6 +1669,18 @@ static BOOL EmptyStore_control(WINECRYPT_CERTSTORE *store, DWORD flags, DWORD ct
     return FALSE;
 }
 
+static BOOL EmptyStore_findCert(WINECRYPT_CERTSTORE *store, CertIndexType type,
+ const CRYPT_DATA_BLOB *key, context_t **ret)
+{
+    *ret = NULL;
+    return TRUE;
+}
+
+static LONG EmptyStore_generation(WINECRYPT_CERTSTORE *store)
+{
+    return 0;
+}
+
 static const store_vtbl_t EmptyStoreVtbl = {
     EmptyStore_addref,
     EmptyStore_release,
@@ -1497,7 +1698,9 @@ static const store_vtbl_t EmptyStoreVtbl = {
         EmptyStore_add,
         EmptyStore_enum,
         EmptyStore_delete
-    }
+    },
+    EmptyStore_findCert,
+    EmptyStore_generation
 };
 
 WINECRYPT_CERTSTORE empty_store;
@@ -1295,6 +1295,76 @@ static void testFindCert(void)
     CertCloseStore(store, 0);
 }
 
+/* The subject name and key identifier lookups go through an index of the
+ * store, check that it follows the changes made to the store.
+ */
+static void testFindCertIndex(void)
+{
+    HCERTSTORE store;
+    PCCERT_CONTEXT context, found;
+    CERT_NAME_BLOB name = { sizeof(subjectName2), subjectName2 };
+    BYTE keyId[] = { 0x11, 0x22, 0x33, 0x44 };
+    CRYPT_HASH_BLOB blob = { sizeof(keyId), keyId };
+    BOOL ret;
+
+    store = CertOpenStore(CERT_STORE_PROV_MEMORY, 0, 0,
+     CERT_STORE_CREATE_NEW_FLAG, NULL);
+    ok(store != NULL, "CertOpenStore failed: %ld\n", GetLastError());
+    if (!store)
+        return;
+
+    ret = CertAddEncodedCertificateToStore(store, X509_ASN_ENCODING,
+     bigCert, sizeof(bigCert), CERT_STORE_ADD_NEW, NULL);
+    ok(ret, "CertAddEncodedCertificateToStore failed: %08lx\n", GetLastError());
+    ret = CertAddEncodedCertificateToStore(store, X509_ASN_ENCODING,
+     bigCert2, sizeof(bigCert2), CERT_STORE_ADD_NEW, NULL);
+    ok(ret, "CertAddEncodedCertificateToStore failed: %08lx\n",
+     GetLastError());
+
+    /* Lookups by key identifier see property changes */
+    found = CertFindCertificateInStore(store, X509_ASN_ENCODING, 0,
+     CERT_FIND_KEY_IDENTIFIER, &blob, NULL);
+    ok(!found, "Expected no cert\n");
+    context = CertFindCertificateInStore(store, X509_ASN_ENCODING, 0,
+     CERT_FIND_SUBJECT_NAME, &name, NULL);
+    ok(context != NULL, "CertFindCertificateInStore failed: %08lx\n",
+     GetLastError());
+    ret = CertSetCertificateContextProperty(context,
+     CERT_KEY_IDENTIFIER_PROP_ID, 0, &blob);
+    ok(ret, "CertSetCertificateContextProperty failed: %08lx\n",
+     GetLastError());
+    found = CertFindCertificateInStore(store, X509_ASN_ENCODING, 0,
+     CERT_FIND_KEY_IDENTIFIER, &blob, NULL);
+    ok(found == context, "Expected %p, got %p\n", context, found);
+    CertFreeCertificateContext(found);
+
+    /* and lookups by subject name see deletions */
+    ret = CertDeleteCertificateFromStore(context);
+    ok(ret, "CertDeleteCertificateFromStore failed: %08lx\n", GetLastError());
+    SetLastError(0xdeadbeef);
+    context = CertFindCertificateInStore(store, X509_ASN_ENCODING, 0,
+     CERT_FIND_SUBJECT_NAME, &name, NULL);
+    ok(!context, "Expected no cert\n");
+    ok(GetLastError() == CRYPT_E_NOT_FOUND,
+     "expected CRYPT_E_NOT_FOUND, got %08lx\n", GetLastError());
+    found = CertFindCertificateInStore(store, X509_ASN_ENCODING, 0,
+     CERT_FIND_KEY_IDENTIFIER, &blob, NULL);
+    ok(!found, "Expected no cert\n");
+
+    /* and additions */
+    ret = CertAddEncodedCertificateToStore(store, X509_ASN_ENCODING,
+     bigCert2, sizeof(bigCert2), CERT_STORE_ADD_NEW, NULL);
+    ok(ret, "CertAddEncodedCertificateToStore failed: %08lx\n",
+     GetLastError());
+    context = CertFindCertificateInStore(store, X509_ASN_ENCODING, 0,
+     CERT_FIND_SUBJECT_NAME, &name, NULL);
+    ok(context != NULL, "CertFindCertificateInStore failed: %08lx\n",
+     GetLastError());
+    CertFreeCertificateContext(context);
+
+    CertCloseStore(store, 0);
+}
+
 static void testGetSubjectCert(void)
 {
     HCERTSTORE store;
@@ -4698,6 +4768,7 @@ START_TEST(cert)
     testCreateCert();
     testDupCert();
     testFindCert();
+    testFindCertIndex();
     testGetSubjectCert();
     testGetIssuerCert();
     testLinkCert();
@@ -4661,6 +4661,239 @@ static void test_CERT_CHAIN_PARA_cbSize(void)
     CertCloseStore(store, 0);
 }
 
+/* chain_cache_root -> chain_cache_ca -> chain_cache_leaf:
+ * A valid chain until 2049, for the tests which need the current time
+ */
+static const BYTE chain_cache_root[] = {
+0x30,0x82,0x02,0x02,0x30,0x82,0x01,0x6b,0xa0,0x03,0x02,0x01,0x02,0x02,0x01,
+0x01,0x30,0x0d,0x06,0x09,0x2a,0x86,0x48,0x86,0xf7,0x0d,0x01,0x01,0x0b,0x05,
+0x00,0x30,0x25,0x31,0x23,0x30,0x21,0x06,0x03,0x55,0x04,0x03,0x0c,0x1a,0x57,
+0x69,0x6e,0x65,0x20,0x43,0x68,0x61,0x69,0x6e,0x20,0x43,0x61,0x63,0x68,0x65,
+0x20,0x54,0x65,0x73,0x74,0x20,0x52,0x6f,0x6f,0x74,0x30,0x1e,0x17,0x0d,0x32,
+0x30,0x30,0x31,0x30,0x31,0x30,0x30,0x30,0x30,0x30,0x30,0x5a,0x17,0x0d,0x34,
+0x39,0x31,0x32,0x33,0x31,0x32,0x33,0x35,0x39,0x35,0x39,0x5a,0x30,0x25,0x31,
+0x23,0x30,0x21,0x06,0x03,0x55,0x04,0x03,0x0c,0x1a,0x57,0x69,0x6e,0x65,0x20,
+0x43,0x68,0x61,0x69,0x6e,0x20,0x43,0x61,0x63,0x68,0x65,0x20,0x54,0x65,0x73,
+0x74,0x20,0x52,0x6f,0x6f,0x74,0x30,0x81,0x9f,0x30,0x0d,0x06,0x09,0x2a,0x86,
+0x48,0x86,0xf7,0x0d,0x01,0x01,0x01,0x05,0x00,0x03,0x81,0x8d,0x00,0x30,0x81,
+0x89,0x02,0x81,0x81,0x00,0xb0,0x2d,0x08,0x6e,0x56,0xb6,0xf3,0x57,0xd1,0x9a,
+0xcf,0x5b,0xb2,0x28,0xc8,0x38,0xdb,0xe5,0xec,0x98,0x48,0xc6,0x6a,0x0f,0xb3,
+0xac,0x49,0x38,0x39,0x7e,0x1f,0x23,0xeb,0x2d,0xdd,0x51,0x4a,0xc9,0x12,0xc2,
+0x84,0xf1,0x42,0x3f,0xc9,0x12,0x5a,0xda,0xf8,0x1b,0x1f,0x9d,0x31,0xc5,0xab,
+0x4e,0xa4,0xc5,0xed,0x6f,0x4f,0xb4,0x56,0x3b,0x28,0xb2,0x6c,0x6f,0x21,0x90,
+0xc4,0x76,0x54,0xd0,0x90,0xbb,0x83,0x7f,0x5a,0x6f,0x16,0x74,0xd3,0xda,0x13,
+0x41,0x47,0xe6,0x1b,0xfa,0x32,0xce,0x50,0xcd,0xbc,0xd2,0x7d,0x3f,0xaa,0xb1,
+0x64,0x57,0x3e,0xae,0x0d,0x5a,0xe4,0x40,0x64,0xbf,0x4e,0x49,0x45,0xf2,0x6d,
+0x3e,0xc3,0x70,0xfd,0x94,0x87,0x6b,0xe2,0xcb,0x48,0xd4,0xb9,0xb5,0x02,0x03,
+0x01,0x00,0x01,0xa3,0x42,0x30,0x40,0x30,0x0f,0x06,0x03,0x55,0x1d,0x13,0x01,
+0x01,0xff,0x04,0x05,0x30,0x03,0x01,0x01,0xff,0x30,0x0e,0x06,0x03,0x55,0x1d,
+0x0f,0x01,0x01,0xff,0x04,0x04,0x03,0x02,0x01,0x06,0x30,0x1d,0x06,0x03,0x55,
+0x1d,0x0e,0x04,0x16,0x04,0x14,0x9b,0x87,0x70,0x39,0xe6,0x0c,0xa2,0x60,0xf7,
+0xea,0x18,0x90,0x03,0x5c,0x4e,0x78,0x13,0xbc,0x6f,0x5f,0x30,0x0d,0x06,0x09,
+0x2a,0x86,0x48,0x86,0xf7,0x0d,0x01,0x01,0x0b,0x05,0x00,0x03,0x81,0x81,0x00,
+0x0c,0x27,0x84,0xdc,0x76,0x2b,0x71,0x3f,0x60,0x7b,0x75,0x49,0xfc,0x1b,0x70,
+0x2d,0xd7,0x5d,0x8c,0x74,0x60,0x4b,0xc1,0xe7,0x72,0xb4,0xe5,0x24,0x19,0xb7,
+0xad,0x5f,0x10,0xc6,0xda,0x88,0x39,0x91,0x7c,0xff,0xaa,0x19,0xe2,0x09,0xab,
+0x86,0xf8,0x0d,0x19,0xce,0x53,0xfe,0x6b,0xd8,0x48,0xca,0x66,0x50,0xfa,0xa2,
+0x31,0x8e,0x81,0x7b,0x43,0x6f,0xd9,0x7e,0x0d,0x46,0xd6,0x9a,0x86,0xee,0x08,
+0xdf,0x1e,0x4f,0x88,0x57,0x98,0x8d,0xbc,0x54,0x5f,0x12,0x4a,0xd8,0xfa,0x8d,
+0xb3,0x89,0x74,0xb8,0x93,0x4b,0x6b,0x25,0xdd,0x25,0xc1,0xbc,0xaf,0xa0,0x54,
+0x6f,0x72,0x92,0xa3,0x98,0x41,0xf8,0xc4,0xef,0xc6,0x58,0x79,0x25,0x17,0x50,
+0x92,0x2a,0x6a,0xce,0xbb,0x04,0xfc,0x56 };
+static const BYTE chain_cache_ca[] = {
+0x30,0x82,0x02,0x2b,0x30,0x82,0x01,0x94,0xa0,0x03,0x02,0x01,0x02,0x02,0x01,
+0x02,0x30,0x0d,0x06,0x09,0x2a,0x86,0x48,0x86,0xf7,0x0d,0x01,0x01,0x0b,0x05,
+0x00,0x30,0x25,0x31,0x23,0x30,0x21,0x06,0x03,0x55,0x04,0x03,0x0c,0x1a,0x57,
+0x69,0x6e,0x65,0x20,0x43,0x68,0x61,0x69,0x6e,0x20,0x43,0x61,0x63,0x68,0x65,
+0x20,0x54,0x65,0x73,0x74,0x20,0x52,0x6f,0x6f,0x74,0x30,0x1e,0x17,0x0d,0x32,
+0x30,0x30,0x31,0x30,0x31,0x30,0x30,0x30,0x30,0x30,0x30,0x5a,0x17,0x0d,0x34,
+0x39,0x31,0x32,0x33,0x31,0x32,0x33,0x35,0x39,0x35,0x39,0x5a,0x30,0x2d,0x31,
+0x2b,0x30,0x29,0x06,0x03,0x55,0x04,0x03,0x0c,0x22,0x57,0x69,0x6e,0x65,0x20,
+0x43,0x68,0x61,0x69,0x6e,0x20,0x43,0x61,0x63,0x68,0x65,0x20,0x54,0x65,0x73,
+0x74,0x20,0x49,0x6e,0x74,0x65,0x72,0x6d,0x65,0x64,0x69,0x61,0x74,0x65,0x30,
+0x81,0x9f,0x30,0x0d,0x06,0x09,0x2a,0x86,0x48,0x86,0xf7,0x0d,0x01,0x01,0x01,
+0x05,0x00,0x03,0x81,0x8d,0x00,0x30,0x81,0x89,0x02,0x81,0x81,0x00,0xb4,0xa6,
+0xae,0x41,0x2b,0x26,0xc9,0x98,0x42,0x1d,0x75,0xdb,0x38,0xfb,0x50,0x4a,0x6a,
+0x68,0x3e,0x19,0x8f,0x50,0x2a,0x8c,0x01,0xfa,0x6d,0x4f,0x53,0xc5,0x43,0x8e,
+0xbb,0xa9,0x7c,0x26,0xaa,0xdc,0xab,0xc8,0x8a,0xf6,0x41,0xd4,0x81,0x14,0x84,
+0xb1,0xac,0x38,0x39,0xb7,0x0d,0xe1,0x49,0x29,0xb1,0x96,0x72,0x17,0x85,0x97,
+0xb8,0x78,0xd5,0x18,0x5b,0x57,0x66,0x5b,0xe1,0x79,0x98,0xb4,0xcd,0x48,0x42,
+0xb8,0x90,0xc2,0x01,0xd2,0x7e,0xc5,0xb4,0x66,0x30,0x2d,0x8b,0xbe,0x5f,0x01,
+0xca,0x1a,0xe8,0x87,0xa0,0xef,0x8f,0x27,0xd1,0x39,0xe9,0x4d,0x93,0x1d,0x99,
+0x31,0x13,0xe9,0x70,0x4a,0xb0,0x2f,0x9c,0x7a,0xb4,0xba,0xeb,0xcf,0x2e,0xa3,
+0x61,0x7a,0x70,0xd7,0x02,0xc5,0x02,0x03,0x01,0x00,0x01,0xa3,0x63,0x30,0x61,
+0x30,0x0f,0x06,0x03,0x55,0x1d,0x13,0x01,0x01,0xff,0x04,0x05,0x30,0x03,0x01,
+0x01,0xff,0x30,0x0e,0x06,0x03,0x55,0x1d,0x0f,0x01,0x01,0xff,0x04,0x04,0x03,
+0x02,0x01,0x06,0x30,0x1d,0x06,0x03,0x55,0x1d,0x0e,0x04,0x16,0x04,0x14,0x17,
+0x3c,0xf4,0x9f,0xc8,0xbf,0xd6,0xf6,0x48,0x1b,0x82,0xf8,0x58,0xc8,0x31,0x75,
+0xa6,0x22,0x00,0x11,0x30,0x1f,0x06,0x03,0x55,0x1d,0x23,0x04,0x18,0x30,0x16,
+0x80,0x14,0x9b,0x87,0x70,0x39,0xe6,0x0c,0xa2,0x60,0xf7,0xea,0x18,0x90,0x03,
+0x5c,0x4e,0x78,0x13,0xbc,0x6f,0x5f,0x30,0x0d,0x06,0x09,0x2a,0x86,0x48,0x86,
+0xf7,0x0d,0x01,0x01,0x0b,0x05,0x00,0x03,0x81,0x81,0x00,0x0f,0xbb,0xf4,0xe3,
+0xe5,0xa5,0x23,0x72,0x35,0x77,0x23,0x75,0xc6,0xf5,0x1e,0xd7,0x21,0xcf,0x44,
+0x1c,0x2f,0x79,0x7f,0x66,0x6b,0xa6,0xfb,0xe8,0x02,0xa8,0xa6,0xb2,0xf4,0x6a,
+0xc0,0x61,0xa2,0x7a,0xf7,0x23,0x0f,0x81,0x7a,0x35,0x44,0xe7,0xa4,0xd1,0x28,
+0x81,0x7e,0x3f,0x88,0x46,0xe5,0x21,0x7d,0x8d,0xb5,0x16,0xce,0x1b,0xe1,0x0b,
+0x40,0x16,0x6c,0xc1,0x27,0x60,0x69,0x72,0x76,0x7b,0x32,0xf8,0xfe,0x5c,0x26,
+0x71,0x67,0x03,0xd6,0xd0,0x49,0x1c,0xcb,0x9e,0x56,0x6d,0xed,0xf9,0xfa,0x25,
+0x80,0x67,0x63,0x8d,0x09,0x95,0xf6,0x87,0x6d,0x50,0x6e,0xba,0x25,0xbc,0x79,
+0x8d,0x9c,0xf2,0xc5,0x01,0x74,0x53,0x2c,0xed,0x91,0x4a,0xbf,0x33,0xa9,0x5a,
+0xa5,0x89,0x25,0xdb };
+static const BYTE chain_cache_leaf[] = {
+0x30,0x82,0x02,0x18,0x30,0x82,0x01,0x81,0xa0,0x03,0x02,0x01,0x02,0x02,0x01,
+0x03,0x30,0x0d,0x06,0x09,0x2a,0x86,0x48,0x86,0xf7,0x0d,0x01,0x01,0x0b,0x05,
+0x00,0x30,0x2d,0x31,0x2b,0x30,0x29,0x06,0x03,0x55,0x04,0x03,0x0c,0x22,0x57,
+0x69,0x6e,0x65,0x20,0x43,0x68,0x61,0x69,0x6e,0x20,0x43,0x61,0x63,0x68,0x65,
+0x20,0x54,0x65,0x73,0x74,0x20,0x49,0x6e,0x74,0x65,0x72,0x6d,0x65,0x64,0x69,
+0x61,0x74,0x65,0x30,0x1e,0x17,0x0d,0x32,0x30,0x30,0x31,0x30,0x31,0x30,0x30,
+0x30,0x30,0x30,0x30,0x5a,0x17,0x0d,0x34,0x39,0x31,0x32,0x33,0x31,0x32,0x33,
+0x35,0x39,0x35,0x39,0x5a,0x30,0x25,0x31,0x23,0x30,0x21,0x06,0x03,0x55,0x04,
+0x03,0x0c,0x1a,0x57,0x69,0x6e,0x65,0x20,0x43,0x68,0x61,0x69,0x6e,0x20,0x43,
+0x61,0x63,0x68,0x65,0x20,0x54,0x65,0x73,0x74,0x20,0x4c,0x65,0x61,0x66,0x30,
+0x81,0x9f,0x30,0x0d,0x06,0x09,0x2a,0x86,0x48,0x86,0xf7,0x0d,0x01,0x01,0x01,
+0x05,0x00,0x03,0x81,0x8d,0x00,0x30,0x81,0x89,0x02,0x81,0x81,0x00,0xcb,0xfa,
+0x3d,0x7a,0xbe,0xe6,0x58,0x5a,0xb8,0xe4,0x0b,0xc7,0x48,0xb9,0x65,0x8b,0xc4,
+0xdf,0xda,0x44,0x86,0x22,0x4a,0xec,0xac,0x6e,0xf4,0xd5,0x84,0x51,0xb6,0xa8,
+0xa7,0x23,0x96,0x55,0xdb,0x83,0x7f,0x78,0x3f,0x3e,0x29,0x43,0xc0,0xbe,0x69,
+0x79,0x04,0x53,0x9d,0x5c,0xcf,0xd0,0xb5,0xa4,0xba,0xac,0xa4,0x3b,0xfe,0xff,
+0x6c,0x44,0x93,0xc5,0x2f,0x48,0x4f,0x12,0x50,0x1c,0xb1,0xf0,0x7f,0xcf,0x6f,
+0xe4,0xb7,0x9e,0x2f,0x00,0x11,0x5b,0x65,0xbc,0xfb,0x76,0x3c,0xfa,0x27,0x31,
+0xfd,0x97,0x38,0xb5,0xe2,0x1b,0x39,0x8f,0xf8,0x04,0x5a,0x9e,0x06,0x1e,0xc7,
+0x10,0xa6,0x77,0x11,0xc5,0x0a,0x12,0x4a,0xea,0xb9,0x29,0x56,0xbc,0xba,0x3b,
+0xcb,0x88,0x81,0xda,0x4e,0x17,0x02,0x03,0x01,0x00,0x01,0xa3,0x50,0x30,0x4e,
+0x30,0x0c,0x06,0x03,0x55,0x1d,0x13,0x01,0x01,0xff,0x04,0x02,0x30,0x00,0x30,
+0x1d,0x06,0x03,0x55,0x1d,0x0e,0x04,0x16,0x04,0x14,0x5d,0xb8,0xe3,0xa2,0x1a,
+0xe4,0x45,0x83,0x64,0x7f,0xe0,0x25,0xc7,0x2e,0xe7,0x32,0xc3,0x6c,0xce,0x0a,
+0x30,0x1f,0x06,0x03,0x55,0x1d,0x23,0x04,0x18,0x30,0x16,0x80,0x14,0x17,0x3c,
+0xf4,0x9f,0xc8,0xbf,0xd6,0xf6,0x48,0x1b,0x82,0xf8,0x58,0xc8,0x31,0x75,0xa6,
+0x22,0x00,0x11,0x30,0x0d,0x06,0x09,0x2a,0x86,0x48,0x86,0xf7,0x0d,0x01,0x01,
+0x0b,0x05,0x00,0x03,0x81,0x81,0x00,0x82,0x61,0x79,0x27,0x1f,0xfb,0x77,0x4c,
+0x80,0x9a,0x43,0x9c,0x9c,0xe4,0x77,0xb0,0x7c,0x2c,0x14,0xba,0x3b,0xd0,0xc0,
+0xf9,0xae,0xb9,0xff,0x1a,0x8a,0x70,0x53,0x09,0xe8,0x29,0x59,0x69,0xa3,0x23,
+0xf7,0x91,0x09,0x54,0xc5,0xaa,0xd2,0x61,0x55,0xa6,0xb5,0xb3,0xf9,0xcd,0x41,
+0x2d,0x39,0x2b,0xe4,0x06,0x23,0xa0,0x84,0x19,0x4d,0x53,0x05,0x9b,0x74,0x16,
+0xdb,0xe1,0x0f,0x50,0x28,0x8f,0x57,0xa5,0x31,0x8c,0xa6,0x86,0x10,0xcc,0xb3,
+0x88,0x6c,0x62,0xca,0xc9,0x27,0x5d,0x33,0xaa,0x72,0x94,0x78,0x4c,0x02,0x33,
+0x3b,0x41,0x49,0xf7,0xcb,0xe0,0xb1,0x13,0xbc,0x85,0xd3,0xce,0x14,0x97,0xaf,
+0xc1,0xf0,0x9e,0xc7,0x39,0xf8,0xcb,0x99,0x97,0x3d,0xc3,0x64,0xaf,0x7c,0xc6 };
+
+static DWORD get_chain_length(HCERTCHAINENGINE engine, PCCERT_CONTEXT cert, HCERTSTORE additional)
+{
+    CERT_CHAIN_PARA para = { sizeof(para), { 0 } };
+    PCCERT_CHAIN_CONTEXT chain;
+    DWORD ret;
+
+    if (!CertGetCertificateChain(engine, cert, NULL, additional, &para, 0, NULL, &chain))
+    {
+        ok(0, "CertGetCertificateChain failed: %08lx\n", GetLastError());
+        return 0;
+    }
+    ok(chain->cChain == 1, "got %lu simple chains\n", chain->cChain);
+    ret = chain->rgpChain[0]->cElement;
+    CertFreeCertificateChain(chain);
+    return ret;
+}
+
+/* Chains built at the current time may be cached by the engine, make sure
+ * they still follow the changes of the engine's stores and the additional
+ * store.
+ */
+static void test_chain_cache(void)
+{
+    CERT_CHAIN_ENGINE_CONFIG config = { sizeof(config), 0 };
+    CERT_CHAIN_PARA para = { sizeof(para), { 0 } };
+    HCERTSTORE root, world, additional, store;
+    PCCERT_CONTEXT leaf, ca, cert;
+    PCCERT_CHAIN_CONTEXT chain;
+    HCERTCHAINENGINE engine;
+    DWORD length, i;
+    BOOL ret;
+
+    root = CertOpenStore(CERT_STORE_PROV_MEMORY, 0, 0,
+     CERT_STORE_CREATE_NEW_FLAG, NULL);
+    CertAddEncodedCertificateToStore(root, X509_ASN_ENCODING, chain_cache_root,
+     sizeof(chain_cache_root), CERT_STORE_ADD_ALWAYS, NULL);
+    world = CertOpenStore(CERT_STORE_PROV_MEMORY, 0, 0,
+     CERT_STORE_CREATE_NEW_FLAG, NULL);
+    config.hExclusiveRoot = root;
+    config.cAdditionalStore = 1;
+    config.rghAdditionalStore = &world;
+    if (!CertCreateCertificateChainEngine(&config, &engine))
+    {
+        skip("Couldn't create chain engine\n");
+        CertCloseStore(world, 0);
+        CertCloseStore(root, 0);
+        return;
+    }
+    leaf = CertCreateCertificateContext(X509_ASN_ENCODING, chain_cache_leaf,
+     sizeof(chain_cache_leaf));
+
+    /* The intermediate CA can't be found */
+    length = get_chain_length(engine, leaf, NULL);
+    ok(length == 1, "got %lu elements\n", length);
+
+    /* Adding it to the engine's stores completes the chain, */
+    ret = CertAddEncodedCertificateToStore(world, X509_ASN_ENCODING, chain_cache_ca,
+     sizeof(chain_cache_ca), CERT_STORE_ADD_ALWAYS, &ca);
+    ok(ret, "CertAddEncodedCertificateToStore failed: %08lx\n", GetLastError());
+    length = get_chain_length(engine, leaf, NULL);
+    ok(length == 3, "got %lu elements\n", length);
+    length = get_chain_length(engine, leaf, NULL);
+    ok(length == 3, "got %lu elements\n", length);
+
+    /* A chain found again starts with the caller's certificate, and doesn't
+     * keep it or its store alive.
+     */
+    store = CertOpenStore(CERT_STORE_PROV_MEMORY, 0, 0,
+     CERT_STORE_CREATE_NEW_FLAG, NULL);
+    ret = CertAddCertificateContextToStore(store, leaf, CERT_STORE_ADD_ALWAYS, &cert);
+    ok(ret, "CertAddCertificateContextToStore failed: %08lx\n", GetLastError());
+    for (i = 0; i < 2; i++)
+    {
+        ret = CertGetCertificateChain(engine, cert, NULL, NULL, &para, 0, NULL, &chain);
+        ok(ret, "CertGetCertificateChain failed: %08lx\n", GetLastError());
+        ok(chain->rgpChain[0]->cElement == 3, "got %lu elements\n", chain->rgpChain[0]->cElement);
+        ok(chain->rgpChain[0]->rgpElement[0]->pCertContext == cert, "got %p, expected %p\n",
+         chain->rgpChain[0]->rgpElement[0]->pCertContext, cert);
+        CertFreeCertificateChain(chain);
+    }
+    CertFreeCertificateContext(cert);
+    ret = CertCloseStore(store, CERT_CLOSE_STORE_CHECK_FLAG);
+    ok(ret, "CertCloseStore failed: %08lx\n", GetLastError());
+    ret = CertGetCertificateChain(engine, leaf, NULL, NULL, &para, 0, NULL, &chain);
+    ok(ret, "CertGetCertificateChain failed: %08lx\n", GetLastError());
+    ok(chain->rgpChain[0]->rgpElement[0]->pCertContext == leaf, "got %p, expected %p\n",
+     chain->rgpChain[0]->rgpElement[0]->pCertContext, leaf);
+    CertFreeCertificateChain(chain);
+
+    /* and removing it breaks it again. */
+    ret = CertDeleteCertificateFromStore(ca);
+    ok(ret, "CertDeleteCertificateFromStore failed: %08lx\n", GetLastError());
+    length = get_chain_length(engine, leaf, NULL);
+    ok(length == 1, "got %lu elements\n", length);
+
+    /* Same with the additional store */
+    additional = CertOpenStore(CERT_STORE_PROV_MEMORY, 0, 0,
+     CERT_STORE_CREATE_NEW_FLAG, NULL);
+    ret = CertAddEncodedCertificateToStore(additional, X509_ASN_ENCODING, chain_cache_ca,
+     sizeof(chain_cache_ca), CERT_STORE_ADD_ALWAYS, &ca);
+    ok(ret, "CertAddEncodedCertificateToStore failed: %08lx\n", GetLastError());
+    length = get_chain_length(engine, leaf, additional);
+    ok(length == 3, "got %lu elements\n", length);
+    length = get_chain_length(engine, leaf, NULL);
+    ok(length == 1, "got %lu elements\n", length);
+    ret = CertDeleteCertificateFromStore(ca);
+    ok(ret, "CertDeleteCertificateFromStore failed: %08lx\n", GetLastError());
+    length = get_chain_length(engine, leaf, additional);
+    ok(length == 1, "got %lu elements\n", length);
+
+    CertFreeCertificateContext(leaf);
+    CertCloseStore(additional, 0);
+    CertFreeCertificateChainEngine(engine);
+    CertCloseStore(world, 0);
+    CertCloseStore(root, 0);
+}
+
 typedef struct _ChainPolicyCheck
 {
     CONST_BLOB_ARRAY                certs;
@@ -5385,4 +5618,5 @@ START_TEST(chain)
     testVerifyCertChainPolicy();
     testGetCertChain();
     test_CERT_CHAIN_PARA_cbSize();
+    test_chain_cache();
 }
@@ -2195,100 +2195,458 @@ static BOOL d2d_geometry_apply_intersections(struct d2d_geometry *geometry,
     return TRUE;
 }
 
-/* Intersect the geometry's segments with themselves. This uses the
- * straightforward approach of testing everything against everything, but
- * there certainly exist more scalable algorithms for this. */
+/* A segment of a path geometry, with its bounds for finding candidate
+ * intersections. */
+struct d2d_geometry_segment
+{
+    struct d2d_segment_idx idx;
+    enum d2d_vertex_type type;
+    D2D1_RECT_F bounds;
+};
+
+struct d2d_geometry_segment_pair
+{
+    size_t p, q;
+};
+
+static int __cdecl d2d_geometry_segment_compare_left(const void *a, const void *b)
+{
+    const struct d2d_geometry_segment *s0 = *(const struct d2d_geometry_segment **)a;
+    const struct d2d_geometry_segment *s1 = *(const struct d2d_geometry_segment **)b;
+
+    if (s0->bounds.left != s1->bounds.left)
+        return s0->bounds.left > s1->bounds.left ? 1 : -1;
+    return 0;
+}
+
+static int __cdecl d2d_geometry_segment_pair_compare(const void *a, const void *b)
+{
+    const struct d2d_geometry_segment_pair *p0 = a;
+    const struct d2d_geometry_segment_pair *p1 = b;
+
+    if (p0->p != p1->p)
+        return p0->p > p1->p ? 1 : -1;
+    if (p0->q != p1->q)
+        return p0->q > p1->q ? 1 : -1;
+    return 0;
+}
+
+static void d2d_geometry_get_segment_bounds(const struct d2d_geometry *geometry,
+        struct d2d_geometry_segment *segment)
+{
+    const struct d2d_figure *figure = &geometry->u.path.figures[segment->idx.figure_idx];
+    const D2D1_POINT_2F *p0, *p1;
+    D2D1_RECT_F *bounds = &segment->bounds;
+    size_t next;
+    float pad;
+
+    p0 = &figure->vertices[segment->idx.vertex_idx];
+    if ((next = segment->idx.vertex_idx + 1) == figure->vertex_count)
+        next = 0;
+    p1 = &figure->vertices[next];
+
+    if (d2d_vertex_type_is_bezier(segment->type))
+    {
+        d2d_rect_get_bezier_bounds(bounds, p0, &figure->bezier_controls[segment->idx.control_idx], p1);
+    }
+    else
+    {
+        bounds->left = min(p0->x, p1->x);
+        bounds->top = min(p0->y, p1->y);
+        bounds->right = max(p0->x, p1->x);
+        bounds->bottom = max(p0->y, p1->y);
+    }
+
+    /* The intersection tests work on rounded values, so don't let the
+     * bounding boxes reject pairs that only touch within rounding error. */
+    pad = max(max(fabsf(bounds->left), fabsf(bounds->right)), max(fabsf(bounds->top), fabsf(bounds->bottom)));
+    pad = max(pad, 1.0f) * FLT_EPSILON * 16.0f;
+    bounds->left -= pad;
+    bounds->top -= pad;
+    bounds->right += pad;
+    bounds->bottom += pad;
+}
+
+static BOOL d2d_geometry_intersect_segments(struct d2d_geometry *geometry,
+        struct d2d_geometry_intersections *intersections, const struct d2d_geometry_segment *segment_p,
+        const struct d2d_geometry_segment *segment_q)
+{
+    const struct d2d_segment_idx *idx_p = &segment_p->idx, *idx_q = &segment_q->idx;
+
+    if (d2d_vertex_type_is_bezier(segment_q->type))
+    {
+        if (d2d_vertex_type_is_bezier(segment_p->type))
+            return d2d_geometry_intersect_bezier_bezier(geometry, intersections, idx_p, 0.0f, 1.0f, idx_q, 0.0f, 1.0f);
+        return d2d_geometry_intersect_bezier_line(geometry, intersections, idx_q, idx_p);
+    }
+
+    if (d2d_vertex_type_is_bezier(segment_p->type))
+        return d2d_geometry_intersect_bezier_line(geometry, intersections, idx_p, idx_q);
+    return d2d_geometry_intersect_line_line(geometry, intersections, idx_p, idx_q);
+}
+
+/* Find all segment pairs with overlapping bounds by sweeping along the x
+ * axis, then run the exact intersection tests on those pairs only, in the
+ * order a test of every pair of segments would have used. */
 static BOOL d2d_geometry_intersect_self(struct d2d_geometry *geometry)
 {
     struct d2d_geometry_intersections intersections = {0};
-    const struct d2d_figure *figure_p, *figure_q;
-    struct d2d_segment_idx idx_p, idx_q;
-    enum d2d_vertex_type type_p, type_q;
+    struct d2d_geometry_segment *segments = NULL, **sorted = NULL;
+    struct d2d_geometry_segment_pair *pairs = NULL;
+    size_t segment_count, pairs_size = 0, pair_count = 0, i, j;
+    const struct d2d_figure *figure, *figure_q;
+    struct d2d_segment_idx idx;
     BOOL ret = FALSE;
-    size_t max_q;
 
     if (!geometry->u.path.figure_count)
         return TRUE;
 
-    for (idx_p.figure_idx = 0; idx_p.figure_idx < geometry->u.path.figure_count; ++idx_p.figure_idx)
+    for (i = 0, segment_count = 0; i < geometry->u.path.figure_count; ++i)
+        segment_count += geometry->u.path.figures[i].vertex_count;
+    if (!segment_count)
+        return TRUE;
+    if (!(segments = calloc(segment_count, sizeof(*segments)))
+            || !(sorted = calloc(segment_count, sizeof(*sorted))))
     {
-        figure_p = &geometry->u.path.figures[idx_p.figure_idx];
-        idx_p.control_idx = 0;
-        for (idx_p.vertex_idx = 0; idx_p.vertex_idx < figure_p->vertex_count; ++idx_p.vertex_idx)
+        ERR("Failed to allocate segments array.\n");
+        goto done;
+    }
+
+    for (idx.figure_idx = 0, segment_count = 0; idx.figure_idx < geometry->u.path.figure_count; ++idx.figure_idx)
+    {
+        figure = &geometry->u.path.figures[idx.figure_idx];
+        idx.control_idx = 0;
+        for (idx.vertex_idx = 0; idx.vertex_idx < figure->vertex_count; ++idx.vertex_idx)
         {
-            if ((type_p = figure_p->vertex_types[idx_p.vertex_idx]) == D2D_VERTEX_TYPE_END)
+            struct d2d_geometry_segment *segment = &segments[segment_count];
+
+            if ((segment->type = figure->vertex_types[idx.vertex_idx]) == D2D_VERTEX_TYPE_END)
                 continue;
+            segment->idx = idx;
+            d2d_geometry_get_segment_bounds(geometry, segment);
+            sorted[segment_count++] = segment;
+            if (d2d_vertex_type_is_bezier(segment->type))
+                ++idx.control_idx;
+        }
+    }
+
+    qsort(sorted, segment_count, sizeof(*sorted), d2d_geometry_segment_compare_left);
+    for (i = 0; i < segment_count; ++i)
+    {
+        const struct d2d_geometry_segment *s = sorted[i];
+
+        for (j = i + 1; j < segment_count && sorted[j]->bounds.left <= s->bounds.right; ++j)
+        {
+            const struct d2d_geometry_segment *t = sorted[j];
+            size_t p = s - segments, q = t - segments;
 
-            for (idx_q.figure_idx = 0; idx_q.figure_idx <= idx_p.figure_idx; ++idx_q.figure_idx)
+            if (t->bounds.top > s->bounds.bottom || t->bounds.bottom < s->bounds.top)
+                continue;
+
+            /* Segments of different figures are only tested when the figures overlap. */
+            if (s->idx.figure_idx != t->idx.figure_idx)
             {
-                figure_q = &geometry->u.path.figures[idx_q.figure_idx];
-                if (idx_q.figure_idx != idx_p.figure_idx)
-                {
-                    if (!d2d_rect_check_overlap(&figure_p->bounds, &figure_q->bounds))
-                        continue;
-                    if ((max_q = figure_q->vertex_count)
-                            && figure_q->vertex_types[max_q - 1] == D2D_VERTEX_TYPE_END)
-                        --max_q;
-                }
-                else
-                {
-                    max_q = idx_p.vertex_idx;
-                }
+                figure = &geometry->u.path.figures[s->idx.figure_idx];
+                figure_q = &geometry->u.path.figures[t->idx.figure_idx];
+                if (!d2d_rect_check_overlap(&figure->bounds, &figure_q->bounds))
+                    continue;
+            }
 
-                idx_q.control_idx = 0;
-                for (idx_q.vertex_idx = 0; idx_q.vertex_idx < max_q; ++idx_q.vertex_idx)
-                {
-                    type_q = figure_q->vertex_types[idx_q.vertex_idx];
-                    if (d2d_vertex_type_is_bezier(type_q))
-                    {
-                        if (d2d_vertex_type_is_bezier(type_p))
-                        {
-                            if (!d2d_geometry_intersect_bezier_bezier(geometry, &intersections,
-                                    &idx_p, 0.0f, 1.0f, &idx_q, 0.0f, 1.0f))
-                                goto done;
-                        }
-                        else
-                        {
-                            if (!d2d_geometry_intersect_bezier_line(geometry, &intersections, &idx_q, &idx_p))
-                                goto done;
-                        }
-                        ++idx_q.control_idx;
-                    }
-                    else
-                    {
-                        if (d2d_vertex_type_is_bezier(type_p))
-                        {
-                            if (!d2d_geometry_intersect_bezier_line(geometry, &intersections, &idx_p, &idx_q))
-                                goto done;
-                        }
-                        else
-                        {
-                            if (!d2d_geometry_intersect_line_line(geometry, &intersections, &idx_p, &idx_q))
-                                goto done;
-                        }
-                    }
-                }
+            if (!d2d_array_reserve((void **)&pairs, &pairs_size, pair_count + 1, sizeof(*pairs)))
+            {
+                ERR("Failed to grow segment pairs array.\n");
+                goto done;
             }
-            if (d2d_vertex_type_is_bezier(type_p))
-                ++idx_p.control_idx;
+            pairs[pair_count].p = max(p, q);
+            pairs[pair_count].q = min(p, q);
+            ++pair_count;
         }
     }
 
+    qsort(pairs, pair_count, sizeof(*pairs), d2d_geometry_segment_pair_compare);
+    for (i = 0; i < pair_count; ++i)
+    {
+        if (!d2d_geometry_intersect_segments(geometry, &intersections, &segments[pairs[i].p], &segments[pairs[i].q]))
+            goto done;
+    }
+
     qsort(intersections.intersections, intersections.intersection_count,
             sizeof(*intersections.intersections), d2d_geometry_intersections_compare);
     ret = d2d_geometry_apply_intersections(geometry, &intersections);
 
 done:
     free(intersections.intersections);
+    free(pairs);
+    free(sorted);
+    free(segments);
     return ret;
 }
 
+#define D2D_FILL_CACHE_MAX_ENTRIES  64
+#define D2D_FILL_CACHE_MAX_VERTICES 65536
+
+/* Triangulations of recently closed path geometries, most recently used
+ * first. Applications often recreate identical geometries every frame. */
+struct d2d_fill_cache_entry
+{
+    struct list entry;
+    uint32_t hash;
+    size_t key_size;
+    BYTE *key;
+
+    D2D1_POINT_2F *vertices;
+    size_t vertex_count;
+    struct d2d_face *faces;
+    size_t face_count;
+};
+
+static struct list d2d_fill_cache = LIST_INIT(d2d_fill_cache);
+static size_t d2d_fill_cache_entry_count, d2d_fill_cache_vertex_count;
+
+static CRITICAL_SECTION d2d_fill_cache_cs;
+static CRITICAL_SECTION_DEBUG d2d_fill_cache_cs_debug =
+{
+    0, 0, &d2d_fill_cache_cs,
+    { &d2d_fill_cache_cs_debug.ProcessLocksList, &d2d_fill_cache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": d2d_fill_cache_cs") }
+};
+static CRITICAL_SECTION d2d_fill_cache_cs = { &d2d_fill_cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static void d2d_fill_cache_entry_destroy(struct d2d_fill_cache_entry *entry)
+{
+    free(entry->key);
+    free(entry->vertices);
+    free(entry->faces);
+    free(entry);
+}
+
+/* Serialise everything the triangulation depends on. */
+static BYTE *d2d_fill_cache_get_key(const struct d2d_geometry *geometry, size_t *key_size, uint32_t *hash)
+{
+    const struct d2d_figure *figure;
+    size_t size, i;
+    BYTE *key, *ptr;
+
+    size = sizeof(geometry->u.path.fill_mode);
+    for (i = 0; i < geometry->u.path.figure_count; ++i)
+    {
+        figure = &geometry->u.path.figures[i];
+        size += sizeof(figure->flags) + sizeof(figure->vertex_count)
+                + figure->vertex_count * (sizeof(*figure->vertices) + sizeof(*figure->vertex_types));
+    }
+
+    if (!(key = malloc(size)))
+        return NULL;
+
+    ptr = key;
+    memcpy(ptr, &geometry->u.path.fill_mode, sizeof(geometry->u.path.fill_mode));
+    ptr += sizeof(geometry->u.path.fill_mode);
+    for (i = 0; i < geometry->u.path.figure_count; ++i)
+    {
+        figure = &geometry->u.path.figures[i];
+        memcpy(ptr, &figure->flags, sizeof(figure->flags));
+        ptr += sizeof(figure->flags);
+        memcpy(ptr, &figure->vertex_count, sizeof(figure->vertex_count));
+        ptr += sizeof(figure->vertex_count);
+        memcpy(ptr, figure->vertices, figure->vertex_count * sizeof(*figure->vertices));
+        ptr += figure->vertex_count * sizeof(*figure->vertices);
+        memcpy(ptr, figure->vertex_types, figure->vertex_count * sizeof(*figure->vertex_types));
+        ptr += figure->vertex_count * sizeof(*figure->vertex_types);
+    }
+
+    /* FNV-1a */
+    *hash = 0x811c9dc5u;
+    for (i = 0; i < size; ++i)
+        *hash = (*hash ^ key[i]) * 0x01000193u;
+    *key_size = size;
+
+    return key;
+}
+
+static BOOL d2d_fill_cache_lookup(struct d2d_geometry *geometry, const BYTE *key, size_t key_size, uint32_t hash)
+{
+    struct d2d_fill_cache_entry *entry;
+    BOOL ret = FALSE;
+
+    EnterCriticalSection(&d2d_fill_cache_cs);
+    LIST_FOR_EACH_ENTRY(entry, &d2d_fill_cache, struct d2d_fill_cache_entry, entry)
+    {
+        if (entry->hash != hash || entry->key_size != key_size || memcmp(entry->key, key, key_size))
+            continue;
+
+        if (!(geometry->fill.vertices = malloc(entry->vertex_count * sizeof(*entry->vertices))))
+            break;
+        if (!d2d_array_reserve((void **)&geometry->fill.faces, &geometry->fill.faces_size,
+                entry->face_count, sizeof(*entry->faces)))
+        {
+            free(geometry->fill.vertices);
+            geometry->fill.vertices = NULL;
+            break;
+        }
+        memcpy(geometry->fill.vertices, entry->vertices, entry->vertex_count * sizeof(*entry->vertices));
+        geometry->fill.vertex_count = entry->vertex_count;
+        memcpy(geometry->fill.faces, entry->faces, entry->face_count * sizeof(*entry->faces));
+        geometry->fill.face_count = entry->face_count;
+
+        list_remove(&entry->entry);
+        list_add_head(&d2d_fill_cache, &entry->entry);
+        ret = TRUE;
+        break;
+    }
+    LeaveCriticalSection(&d2d_fill_cache_cs);
+
+    return ret;
+}
+
+/* Takes ownership of the key. */
+static void d2d_fill_cache_add(const struct d2d_geometry *geometry, BYTE *key, size_t key_size, uint32_t hash)
+{
+    struct d2d_fill_cache_entry *entry;
+    struct list *tail;
+
+    if (geometry->fill.vertex_count > D2D_FILL_CACHE_MAX_VERTICES / 4
+            || !(entry = calloc(1, sizeof(*entry))))
+    {
+        free(key);
+        return;
+    }
+
+    entry->hash = hash;
+    entry->key_size = key_size;
+    entry->key = key;
+    entry->vertex_count = geometry->fill.vertex_count;
+    entry->face_count = geometry->fill.face_count;
+    if (!(entry->vertices = malloc(entry->vertex_count * sizeof(*entry->vertices)))
+            || !(entry->faces = malloc(max(entry->face_count, 1) * sizeof(*entry->faces))))
+    {
+        d2d_fill_cache_entry_destroy(entry);
+        return;
+    }
+    memcpy(entry->vertices, geometry->fill.vertices, entry->vertex_count * sizeof(*entry->vertices));
+    memcpy(entry->faces, geometry->fill.faces, entry->face_count * sizeof(*entry->faces));
+
+    EnterCriticalSection(&d2d_fill_cache_cs);
+    list_add_head(&d2d_fill_cache, &entry->entry);
+    ++d2d_fill_cache_entry_count;
+    d2d_fill_cache_vertex_count += entry->vertex_count;
+    while (d2d_fill_cache_entry_count > D2D_FILL_CACHE_MAX_ENTRIES
+            || d2d_fill_cache_vertex_count > D2D_FILL_CACHE_MAX_VERTICES)
+    {
+        tail = list_tail(&d2d_fill_cache);
+        entry = LIST_ENTRY(tail, struct d2d_fill_cache_entry, entry);
+        list_remove(&entry->entry);
+        --d2d_fill_cache_entry_count;
+        d2d_fill_cache_vertex_count -= entry->vertex_count;
+        d2d_fill_cache_entry_destroy(entry);
+    }
+    LeaveCriticalSection(&d2d_fill_cache_cs);
+}
+
+/* A single convex figure doesn't need the CDT, a triangle fan covers it. */
+static HRESULT d2d_path_geometry_triangulate_convex(struct d2d_geometry *geometry, BOOL *done)
+{
+    const struct d2d_figure *figure = &geometry->u.path.figures[0];
+    int sign = 0, x_changes = 0, y_changes = 0, first_x = 0, first_y = 0, last_x = 0, last_y = 0;
+    size_t count = figure->vertex_count, i;
+    const D2D1_POINT_2F *a, *b, *c;
+    D2D1_POINT_2F e0, e1;
+    float det;
+
+    *done = FALSE;
+
+    if (geometry->u.path.figure_count != 1 || (figure->flags & D2D_FIGURE_FLAG_HOLLOW)
+            || count < 3 || count > UINT16_MAX)
+        return S_OK;
+
+    for (i = 0; i < count; ++i)
+    {
+        int dx, dy;
+
+        a = &figure->vertices[i];
+        b = &figure->vertices[(i + 1) % count];
+        c = &figure->vertices[(i + 2) % count];
+        d2d_point_subtract(&e0, b, a);
+        d2d_point_subtract(&e1, c, b);
+        if (e0.x == 0.0f && e0.y == 0.0f)
+            return S_OK;
+
+        if (!(det = d2d_point_ccw(a, b, c)))
+        {
+            /* Collinear vertices are fine, reversing direction isn't. */
+            if (d2d_point_dot(&e0, &e1) <= 0.0f)
+                return S_OK;
+        }
+        else if (!sign)
+        {
+            sign = det > 0.0f ? 1 : -1;
+        }
+        else if ((det > 0.0f) != (sign > 0))
+        {
+            return S_OK;
+        }
+
+        /* Turning the same way isn't enough, the figure should also wind
+         * around only once. The edge directions then change sign at most
+         * twice along each axis. */
+        if ((dx = (e0.x > 0.0f) - (e0.x < 0.0f)))
+        {
+            if (last_x && dx != last_x)
+                ++x_changes;
+            if (!first_x)
+                first_x = dx;
+            last_x = dx;
+        }
+        if ((dy = (e0.y > 0.0f) - (e0.y < 0.0f)))
+        {
+            if (last_y && dy != last_y)
+                ++y_changes;
+            if (!first_y)
+                first_y = dy;
+            last_y = dy;
+        }
+    }
+    if (first_x != last_x)
+        ++x_changes;
+    if (first_y != last_y)
+        ++y_changes;
+    if (!sign || x_changes > 2 || y_changes > 2)
+        return S_OK;
+
+    if (!(geometry->fill.vertices = malloc(count * sizeof(*geometry->fill.vertices))))
+        return E_OUTOFMEMORY;
+    if (!d2d_array_reserve((void **)&geometry->fill.faces, &geometry->fill.faces_size,
+            count - 2, sizeof(*geometry->fill.faces)))
+    {
+        free(geometry->fill.vertices);
+        geometry->fill.vertices = NULL;
+        return E_OUTOFMEMORY;
+    }
+
+    memcpy(geometry->fill.vertices, figure->vertices, count * sizeof(*geometry->fill.vertices));
+    geometry->fill.vertex_count = count;
+    for (i = 1; i < count - 1; ++i)
+    {
+        struct d2d_face *face = &geometry->fill.faces[geometry->fill.face_count++];
+
+        face->v[0] = 0;
+        face->v[1] = i;
+        face->v[2] = i + 1;
+    }
+
+    *done = TRUE;
+    return S_OK;
+}
+
 static HRESULT d2d_path_geometry_triangulate(struct d2d_geometry *geometry)
 {
     struct d2d_cdt_edge_ref left_edge, right_edge;
-    size_t vertex_count, i, j;
+    size_t vertex_count, key_size, i, j;
     struct d2d_cdt cdt = {0};
     D2D1_POINT_2F *vertices;
+    BYTE *key = NULL;
+    uint32_t hash;
+    HRESULT hr;
+    BOOL done;
 
     for (i = 0, vertex_count = 0; i < geometry->u.path.figure_count; ++i)
     {
@@ -2303,8 +2661,21 @@ static HRESULT d2d_path_geometry_triangulate(struct d2d_geometry *geometry)
         return S_OK;
     }
 
+    if (FAILED(hr = d2d_path_geometry_triangulate_convex(geometry, &done)) || done)
+        return hr;
+
+    if ((key = d2d_fill_cache_get_key(geometry, &key_size, &hash))
+            && d2d_fill_cache_lookup(geometry, key, key_size, hash))
+    {
+        free(key);
+        return S_OK;
+    }
+
     if (!(vertices = calloc(vertex_count, sizeof(*vertices))))
+    {
+        free(key);
         return E_OUTOFMEMORY;
+    }
 
     for (i = 0, j = 0; i < geometry->u.path.figure_count; ++i)
     {
@@ -2331,6 +2702,7 @@ static HRESULT d2d_path_geometry_triangulate(struct d2d_geometry *geometry)
     {
         WARN("Geometry has %lu vertices after eliminating duplicates.\n", (long)vertex_count);
         free(vertices);
+        free(key);
         return S_OK;
     }
 
@@ -2347,6 +2719,8 @@ static HRESULT d2d_path_geometry_triangulate(struct d2d_geometry *geometry)
         goto fail;
 
     free(cdt.edges);
+    if (key)
+        d2d_fill_cache_add(geometry, key, key_size, hash);
     return S_OK;
 
 fail:
@@ -2354,6 +2728,7 @@ fail:
     geometry->fill.vertex_count = 0;
     free(vertices);
     free(cdt.edges);
+    free(key);
     return E_FAIL;
 }
 
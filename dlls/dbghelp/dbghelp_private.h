@@ -257,6 +257,7 @@ struct symt_function
     struct symt*                type;           /* points to function_signature */
     ULONG_PTR                   size;
     struct vector               vlines;
+    struct line_addr_index*     line_index;     /* vlines sorted on address, built on first lookup */
     struct vector               vchildren;      /* locals, params, blocks, start/end, labels, inline sites */
     struct symt_inlinesite*     next_inlinesite;/* linked list of inline sites in this function */
 };
@@ -419,6 +420,12 @@ struct module_format
                                                const struct module_format* modfmt,
                                                const struct symt_function* func,
                                                struct location* loc);
+    /* for formats loading their debug information lazily (may be NULL):
+     * request_addr loads what's needed for looking up an address,
+     * request_all loads everything that's still pending
+     */
+    void                        (*request_addr)(struct module_format* modfmt, DWORD64 addr);
+    void                        (*request_all)(struct module_format* modfmt);
     union
     {
         struct elf_module_info*         elf_info;
@@ -453,7 +460,8 @@ struct module
     struct vector               vsymt;
     struct vector               vcustom_symt;
     int                         sortlist_valid;
-    unsigned                    num_sorttab;    /* number of symbols with addresses */
+    unsigned                    num_sorttab;    /* number of symbols with addresses (main sorted run) */
+    unsigned                    num_sorttail;   /* number of symbols in the second sorted run */
     unsigned                    num_symbols;
     unsigned                    sorttab_size;
     struct symt_ht**            addr_sorttab;
@@ -721,6 +729,8 @@ extern struct module*
                     module_is_already_loaded(const struct process* pcs,
                                              const WCHAR* imgname) DECLSPEC_HIDDEN;
 extern BOOL         module_get_debug(struct module_pair*) DECLSPEC_HIDDEN;
+extern void         module_request_addr(struct module* module, DWORD64 addr) DECLSPEC_HIDDEN;
+extern void         module_request_all(struct module* module) DECLSPEC_HIDDEN;
 extern struct module*
                     module_new(struct process* pcs, const WCHAR* name,
                                enum module_type type, BOOL virtual,
@@ -216,6 +216,15 @@ typedef struct dwarf2_parse_context_s
     unsigned                    language;
 } dwarf2_parse_context_t;
 
+/* address range covered by a compilation unit (sorted on low) */
+struct dwarf2_unit_range
+{
+    ULONG_PTR                   low;
+    ULONG_PTR                   high;
+    ULONG_PTR                   max_high; /* highest high in this range and all the previous ones */
+    dwarf2_parse_context_t*     unit;
+};
+
 /* stored in the dbghelp's module internal structure for later reuse */
 struct dwarf2_module_info_s
 {
@@ -225,6 +234,21 @@ struct dwarf2_module_info_s
     dwarf2_section_t            debug_frame;
     dwarf2_section_t            eh_frame;
     unsigned char               word_size;
+    /* compilation units are loaded on demand, so the module context is kept
+     * until the module is removed
+     */
+    dwarf2_section_t            sections[section_max];
+    dwarf2_parse_module_context_t module_ctx;
+    struct dwarf2_unit_range*   unit_ranges;
+    unsigned                    num_unit_ranges;
+    struct
+    {
+        ULONG_PTR               low;
+        ULONG_PTR               high;
+    }                           code_ranges[4]; /* the module's code sections */
+    unsigned                    num_code_ranges;
+    BOOL                        all_loaded;
+    unsigned                    loading;        /* >0 while loading a unit, or building the index */
 };
 
 #define loc_dwarf2_location_list        (loc_user + 0)
@@ -2901,6 +2925,7 @@ static BOOL dwarf2_parse_compilation_unit_head(dwarf2_parse_context_t* ctx,
     ctx->head.version = dwarf2_parse_u2(&ctx->traverse_DIE);
     cu_abbrev_offset = dwarf2_parse_offset(&ctx->traverse_DIE, ctx->head.offset_size);
     ctx->head.word_size = dwarf2_parse_byte(&ctx->traverse_DIE);
+    ctx->ref_offset = comp_unit_start - ctx->module_ctx->sections[section_debug].address;
     ctx->status = UNIT_ERROR;
 
     TRACE("Compilation Unit Header found at 0x%x:\n",
@@ -2929,7 +2954,6 @@ static BOOL dwarf2_parse_compilation_unit_head(dwarf2_parse_context_t* ctx,
 
     pool_init(&ctx->pool, 65536);
     ctx->section = section_debug;
-    ctx->ref_offset = comp_unit_start - ctx->module_ctx->sections[section_debug].address;
     ctx->cpp_name = NULL;
     ctx->status = UNIT_NOTLOADED;
 
@@ -4106,20 +4130,294 @@ static inline void dwarf2_fini_section(dwarf2_section_t* section)
         HeapFree(GetProcessHeap(), 0, (void*)section->address);
 }
 
+static BOOL dwarf2_unload_CU_module(dwarf2_parse_module_context_t* module_ctx);
+
 static void dwarf2_module_remove(struct process* pcs, struct module_format* modfmt)
 {
-    dwarf2_fini_section(&modfmt->u.dwarf2_info->debug_loc);
-    dwarf2_fini_section(&modfmt->u.dwarf2_info->debug_frame);
-    free(modfmt->u.dwarf2_info->cuheads);
+    struct dwarf2_module_info_s* info = modfmt->u.dwarf2_info;
+    unsigned i;
+
+    dwarf2_unload_CU_module(&info->module_ctx);
+    for (i = 0; i < section_max; i++)
+        dwarf2_fini_section(&info->sections[i]);
+    dwarf2_fini_section(&info->debug_loc);
+    dwarf2_fini_section(&info->debug_frame);
+    free(info->unit_ranges);
+    free(info->cuheads);
     HeapFree(GetProcessHeap(), 0, modfmt);
 }
 
+static BOOL dwarf2_add_unit_range(struct dwarf2_module_info_s* info, unsigned* alloc,
+                                  dwarf2_parse_context_t* unit, ULONG_PTR low, ULONG_PTR high)
+{
+    if (low >= high) return TRUE;
+    if (info->num_unit_ranges >= *alloc)
+    {
+        unsigned new_alloc = *alloc ? *alloc * 2 : 64;
+        struct dwarf2_unit_range* new_ranges;
+
+        if (!(new_ranges = realloc(info->unit_ranges, new_alloc * sizeof(*new_ranges)))) return FALSE;
+        info->unit_ranges = new_ranges;
+        *alloc = new_alloc;
+    }
+    info->unit_ranges[info->num_unit_ranges].low = info->module_ctx.load_offset + low;
+    info->unit_ranges[info->num_unit_ranges].high = info->module_ctx.load_offset + high;
+    info->unit_ranges[info->num_unit_ranges].unit = unit;
+    info->num_unit_ranges++;
+    return TRUE;
+}
+
+static int dwarf2_find_unit_by_offset(const dwarf2_parse_module_context_t* module_ctx, ULONG_PTR offset)
+{
+    int low = 0, high = module_ctx->unit_contexts.num_elts - 1, mid;
+
+    while (low <= high)
+    {
+        const dwarf2_parse_context_t* unit;
+
+        mid = (low + high) / 2;
+        unit = vector_at(&module_ctx->unit_contexts, mid);
+        if (unit->ref_offset == offset) return mid;
+        if (unit->ref_offset < offset) low = mid + 1; else high = mid - 1;
+    }
+    return -1;
+}
+
+/* fills the unit ranges from .debug_aranges, marking the units found there */
+static void dwarf2_index_aranges(struct dwarf2_module_info_s* info, unsigned* alloc,
+                                 const dwarf2_section_t* aranges, BOOL* indexed)
+{
+    dwarf2_traverse_context_t   traverse;
+
+    traverse.data = aranges->address;
+    traverse.end_data = aranges->address + aranges->size;
+    while (traverse.data + 4 <= traverse.end_data)
+    {
+        const unsigned char*    start = traverse.data;
+        const unsigned char*    end;
+        unsigned char           offset_size, address_size, segment_size;
+        unsigned short          version;
+        ULONG_PTR               length, cu_offset, low, len;
+        int                     idx;
+        dwarf2_parse_context_t* unit;
+
+        length = dwarf2_parse_3264(&traverse, &offset_size);
+        end = traverse.data + length;
+        if (end > traverse.end_data) break;
+        version = dwarf2_parse_u2(&traverse);
+        cu_offset = dwarf2_parse_offset(&traverse, offset_size);
+        address_size = dwarf2_parse_byte(&traverse);
+        segment_size = dwarf2_parse_byte(&traverse);
+        if (version == 2 && (address_size == 4 || address_size == 8) && !segment_size &&
+            (idx = dwarf2_find_unit_by_offset(&info->module_ctx, cu_offset)) != -1 &&
+            (unit = vector_at(&info->module_ctx.unit_contexts, idx))->status != UNIT_ERROR)
+        {
+            /* tuples are aligned on twice the address size from the start of the set */
+            traverse.data = start + ((traverse.data - start + 2 * address_size - 1) & ~(2 * address_size - 1));
+            while (traverse.data + 2 * address_size <= end)
+            {
+                low = dwarf2_parse_addr(&traverse, address_size);
+                len = dwarf2_parse_addr(&traverse, address_size);
+                if (!low && !len) break;
+                if (!dwarf2_add_unit_range(info, alloc, unit, low, low + len)) return;
+            }
+            indexed[idx] = TRUE;
+        }
+        traverse.data = end;
+    }
+}
+
+/* fills the unit ranges from the attributes of the unit's top DIE only */
+static BOOL dwarf2_index_unit(struct dwarf2_module_info_s* info, unsigned* alloc,
+                              dwarf2_parse_context_t* unit)
+{
+    dwarf2_traverse_context_t   traverse = unit->traverse_DIE;
+    const dwarf2_abbrev_entry_t*abbrev;
+    dwarf2_abbrev_entry_attr_t* abbrev_attr;
+    dwarf2_debug_info_t         di;
+    struct attribute            low_pc, high_pc, range;
+    ULONG_PTR                   base, low, high;
+    BOOL                        has_low_pc, ret = FALSE;
+    unsigned                    i;
+
+    abbrev = dwarf2_abbrev_table_find_entry(&unit->abbrev_table, dwarf2_leb128_as_unsigned(&traverse));
+    if (!abbrev || abbrev->tag != DW_TAG_compile_unit || !abbrev->num_attr) return FALSE;
+    di.abbrev = abbrev;
+    di.symt = NULL;
+    di.parent = NULL;
+    di.unit_ctx = unit;
+    if (!(di.data = pool_alloc(&unit->pool, abbrev->num_attr * sizeof(const char*)))) return FALSE;
+    for (i = 0, abbrev_attr = abbrev->attrs; abbrev_attr; i++, abbrev_attr = abbrev_attr->next)
+    {
+        di.data[i] = traverse.data;
+        dwarf2_swallow_attribute(&traverse, &unit->head, abbrev_attr);
+    }
+
+    has_low_pc = dwarf2_find_attribute(&di, DW_AT_low_pc, &low_pc);
+    base = has_low_pc ? low_pc.u.uvalue : 0;
+    if (dwarf2_find_attribute(&di, DW_AT_ranges, &range))
+    {
+        traverse.data = info->sections[section_ranges].address + range.u.uvalue;
+        traverse.end_data = info->sections[section_ranges].address + info->sections[section_ranges].size;
+        while (traverse.data + 2 * unit->head.word_size <= traverse.end_data)
+        {
+            low = dwarf2_parse_addr_head(&traverse, &unit->head);
+            high = dwarf2_parse_addr_head(&traverse, &unit->head);
+            if (low == 0 && high == 0) break;
+            if (low == (unit->head.word_size == 8 ? (~(DWORD64)0u) : (DWORD64)(~0u)))
+            {
+                base = high;
+                continue;
+            }
+            if (!dwarf2_add_unit_range(info, alloc, unit, base + low, base + high)) return FALSE;
+            ret = TRUE;
+        }
+    }
+    else if (has_low_pc && dwarf2_find_attribute(&di, DW_AT_high_pc, &high_pc))
+    {
+        high = high_pc.u.uvalue;
+        /* From dwarf4 on, when FORM's class is constant, high_pc is an offset from low_pc */
+        if (unit->head.version >= 4 && high_pc.form != DW_FORM_addr)
+            high += base;
+        ret = dwarf2_add_unit_range(info, alloc, unit, base, high);
+    }
+    return ret;
+}
+
+static int __cdecl dwarf2_unit_range_compare(const void* p1, const void* p2)
+{
+    const struct dwarf2_unit_range* r1 = p1;
+    const struct dwarf2_unit_range* r2 = p2;
+
+    if (r1->low < r2->low) return -1;
+    if (r1->low > r2->low) return 1;
+    return 0;
+}
+
+/* loading a unit can look up symbols by address (or name) in the module, which would
+ * request the unit being loaded again, so requests are ignored while a unit is loaded
+ */
+static void dwarf2_load_unit(struct dwarf2_module_info_s* info, dwarf2_parse_context_t* unit)
+{
+    info->loading++;
+    dwarf2_parse_compilation_unit(unit);
+    info->loading--;
+}
+
+/* builds the address => unit index, and loads the units which can't be indexed */
+static void dwarf2_index_units(struct dwarf2_module_info_s* info, const dwarf2_section_t* aranges)
+{
+    dwarf2_parse_module_context_t* module_ctx = &info->module_ctx;
+    unsigned    i, alloc = 0;
+    ULONG_PTR   max_high = 0;
+    BOOL*       indexed;
+
+    if (!(indexed = calloc(module_ctx->unit_contexts.num_elts, sizeof(*indexed))))
+    {
+        info->all_loaded = TRUE;
+        for (i = 0; i < module_ctx->unit_contexts.num_elts; ++i)
+            dwarf2_load_unit(info, vector_at(&module_ctx->unit_contexts, i));
+        return;
+    }
+    info->loading++;
+    if (aranges->address && aranges->address != IMAGE_NO_MAP)
+        dwarf2_index_aranges(info, &alloc, aranges, indexed);
+    for (i = 0; i < module_ctx->unit_contexts.num_elts; ++i)
+    {
+        dwarf2_parse_context_t* unit = vector_at(&module_ctx->unit_contexts, i);
+
+        if (unit->status == UNIT_ERROR || indexed[i]) continue;
+        indexed[i] = dwarf2_index_unit(info, &alloc, unit);
+    }
+
+    qsort(info->unit_ranges, info->num_unit_ranges, sizeof(info->unit_ranges[0]), dwarf2_unit_range_compare);
+    for (i = 0; i < info->num_unit_ranges; i++)
+    {
+        if (info->unit_ranges[i].high > max_high) max_high = info->unit_ranges[i].high;
+        info->unit_ranges[i].max_high = max_high;
+    }
+    info->loading--;
+    TRACE("indexed %u ranges for %u units\n", info->num_unit_ranges, module_ctx->unit_contexts.num_elts);
+
+    /* only load the units without address information once the index is complete */
+    for (i = 0; i < module_ctx->unit_contexts.num_elts; ++i)
+    {
+        dwarf2_parse_context_t* unit = vector_at(&module_ctx->unit_contexts, i);
+
+        if (unit->status != UNIT_ERROR && !indexed[i])
+            dwarf2_load_unit(info, unit);
+    }
+    free(indexed);
+}
+
+static void dwarf2_module_request_all(struct module_format* modfmt)
+{
+    struct dwarf2_module_info_s* info = modfmt->u.dwarf2_info;
+    unsigned i;
+
+    if (info->all_loaded || info->loading) return;
+    info->all_loaded = TRUE;
+    for (i = 0; i < info->module_ctx.unit_contexts.num_elts; ++i)
+        dwarf2_load_unit(info, vector_at(&info->module_ctx.unit_contexts, i));
+}
+
+static void dwarf2_module_request_addr(struct module_format* modfmt, DWORD64 addr)
+{
+    struct dwarf2_module_info_s* info = modfmt->u.dwarf2_info;
+    int low = 0, high = info->num_unit_ranges, mid;
+    unsigned i;
+    BOOL covered = FALSE;
+
+    if (info->all_loaded || info->loading) return;
+    /* look for the first range starting after addr... */
+    while (low < high)
+    {
+        mid = (low + high) / 2;
+        if (info->unit_ranges[mid].low <= addr) low = mid + 1; else high = mid;
+    }
+    /* ...and walk back on all the ranges which can still contain addr */
+    while (--low >= 0 && info->unit_ranges[low].max_high > addr)
+    {
+        if (addr < info->unit_ranges[low].high)
+        {
+            dwarf2_load_unit(info, info->unit_ranges[low].unit);
+            covered = TRUE;
+        }
+    }
+    if (covered) return;
+    /* the index holds all the code ranges of the units, so a code address outside
+     * of them (padding, thunks, code without debug info) won't be found in any unit
+     */
+    for (i = 0; i < info->num_code_ranges; i++)
+        if (info->code_ranges[i].low <= addr && addr < info->code_ranges[i].high) return;
+    /* but any other address (like a global variable) can be defined in any unit */
+    dwarf2_module_request_all(modfmt);
+}
+
+/* records the code sections of the module, see dwarf2_module_request_addr */
+static void dwarf2_init_code_ranges(struct dwarf2_module_info_s* info, struct module* module,
+                                    struct image_file_map* fmap)
+{
+    static const char* const code_sections[] = {".text", ".init", ".fini", "__text"};
+    struct image_section_map ism;
+    unsigned i;
+
+    info->num_code_ranges = 0;
+    for (i = 0; i < ARRAY_SIZE(code_sections); i++)
+    {
+        if (!image_find_section(fmap, code_sections[i], &ism) || !image_get_map_size(&ism)) continue;
+        info->code_ranges[info->num_code_ranges].low = module->module.BaseOfImage + image_get_map_rva(&ism);
+        info->code_ranges[info->num_code_ranges].high = info->code_ranges[info->num_code_ranges].low +
+            image_get_map_size(&ism);
+        info->num_code_ranges++;
+    }
+}
+
 static BOOL dwarf2_load_CU_module(dwarf2_parse_module_context_t* module_ctx, struct module* module,
                                   dwarf2_section_t* sections, ULONG_PTR load_offset,
-                                  const struct elf_thunk_area* thunks, BOOL is_dwz)
+                                  const struct elf_thunk_area* thunks)
 {
     dwarf2_traverse_context_t   mod_ctx;
-    unsigned i;
 
     module_ctx->sections = sections;
     module_ctx->module = module;
@@ -4139,15 +4437,12 @@ static BOOL dwarf2_load_CU_module(dwarf2_parse_module_context_t* module_ctx, str
         dwarf2_parse_compilation_unit_head(unit_ctx, &mod_ctx);
     }
 
-    /* phase2: load content of all CU
-     * If this is a DWZ alternate module, don't load all debug_info at once
-     * wait for main module to ask for them (it's likely it won't need them all)
+    /* phase2: the content of the CUs isn't loaded here, but on demand
+     * - for a DWZ alternate module, when the main module refers to them
+     * - for the main module, when an address lookup falls into their ranges
+     *   (see dwarf2_index_units) or when all the symbols are needed
      * Doing this can lead to a huge performance improvement.
      */
-    if (!is_dwz)
-        for (i = 0; i < module_ctx->unit_contexts.num_elts; ++i)
-            dwarf2_parse_compilation_unit((dwarf2_parse_context_t*)vector_at(&module_ctx->unit_contexts, i));
-
     return TRUE;
 }
 
@@ -4173,7 +4468,7 @@ static dwarf2_dwz_alternate_t* dwarf2_load_dwz(struct image_file_map* fmap, stru
     dwarf2_init_section(&dwz->sections[section_ranges], fmap_dwz, ".debug_ranges", ".zdebug_ranges", &dwz->sectmap[section_ranges]);
 
     dwz->module_ctx.dwz = NULL;
-    dwarf2_load_CU_module(&dwz->module_ctx, module, dwz->sections, 0/*FIXME*/, NULL, TRUE);
+    dwarf2_load_CU_module(&dwz->module_ctx, module, dwz->sections, 0/*FIXME*/, NULL);
     return dwz;
 }
 
@@ -4212,12 +4507,12 @@ BOOL dwarf2_parse(struct module* module, ULONG_PTR load_offset,
                   const struct elf_thunk_area* thunks,
                   struct image_file_map* fmap)
 {
-    dwarf2_section_t    eh_frame, section[section_max];
+    dwarf2_section_t    eh_frame, aranges, section[section_max];
     struct image_section_map    debug_sect, debug_str_sect, debug_abbrev_sect,
-                                debug_line_sect, debug_ranges_sect, eh_frame_sect;
-    BOOL                ret = TRUE;
+                                debug_line_sect, debug_ranges_sect, eh_frame_sect,
+                                debug_aranges_sect;
     struct module_format* dwarf2_modfmt;
-    dwarf2_parse_module_context_t module_ctx;
+    struct dwarf2_module_info_s* info;
 
     if (!dwarf2_init_section(&eh_frame,                fmap, ".eh_frame",     NULL,             &eh_frame_sect))
         /* lld produces .eh_fram to avoid generating a long name */
@@ -4231,10 +4526,7 @@ BOOL dwarf2_parse(struct module* module, ULONG_PTR load_offset,
     /* to do anything useful we need either .eh_frame or .debug_info */
     if ((!eh_frame.address || eh_frame.address == IMAGE_NO_MAP) &&
         (!section[section_debug].address || section[section_debug].address == IMAGE_NO_MAP))
-    {
-        ret = FALSE;
         goto leave;
-    }
 
     if (fmap->modtype == DMT_ELF && debug_sect.fmap)
     {
@@ -4250,44 +4542,58 @@ BOOL dwarf2_parse(struct module* module, ULONG_PTR load_offset,
     dwarf2_modfmt = HeapAlloc(GetProcessHeap(), 0,
                               sizeof(*dwarf2_modfmt) + sizeof(*dwarf2_modfmt->u.dwarf2_info));
     if (!dwarf2_modfmt)
-    {
-        ret = FALSE;
         goto leave;
-    }
     dwarf2_modfmt->module = module;
     dwarf2_modfmt->remove = dwarf2_module_remove;
     dwarf2_modfmt->loc_compute = dwarf2_location_compute;
-    dwarf2_modfmt->u.dwarf2_info = (struct dwarf2_module_info_s*)(dwarf2_modfmt + 1);
-    dwarf2_modfmt->u.dwarf2_info->word_size = fmap->addr_size / 8; /* set the word_size for eh_frame parsing */
+    dwarf2_modfmt->request_addr = dwarf2_module_request_addr;
+    dwarf2_modfmt->request_all = dwarf2_module_request_all;
+    dwarf2_modfmt->u.dwarf2_info = info = (struct dwarf2_module_info_s*)(dwarf2_modfmt + 1);
+    info->word_size = fmap->addr_size / 8; /* set the word_size for eh_frame parsing */
     dwarf2_modfmt->module->format_info[DFI_DWARF] = dwarf2_modfmt;
 
     /* As we'll need later some sections' content, we won't unmap these
      * sections upon existing this function
      */
-    dwarf2_init_section(&dwarf2_modfmt->u.dwarf2_info->debug_loc,   fmap, ".debug_loc",   ".zdebug_loc",   NULL);
-    dwarf2_init_section(&dwarf2_modfmt->u.dwarf2_info->debug_frame, fmap, ".debug_frame", ".zdebug_frame", NULL);
-    dwarf2_modfmt->u.dwarf2_info->eh_frame = eh_frame;
-    dwarf2_modfmt->u.dwarf2_info->cuheads = NULL;
-    dwarf2_modfmt->u.dwarf2_info->num_cuheads = 0;
-
-    module_ctx.dwz = dwarf2_load_dwz(fmap, module);
-    dwarf2_load_CU_module(&module_ctx, module, section, load_offset, thunks, FALSE);
+    dwarf2_init_section(&info->debug_loc,   fmap, ".debug_loc",   ".zdebug_loc",   NULL);
+    dwarf2_init_section(&info->debug_frame, fmap, ".debug_frame", ".zdebug_frame", NULL);
+    info->eh_frame = eh_frame;
+    info->cuheads = NULL;
+    info->num_cuheads = 0;
+    /* the debug sections are needed as long as some CU can be loaded, they'll be
+     * unmapped with the file map (and the decompressed ones freed in dwarf2_module_remove)
+     */
+    memcpy(info->sections, section, sizeof(section));
+    info->unit_ranges = NULL;
+    info->num_unit_ranges = 0;
+    dwarf2_init_code_ranges(info, module, fmap);
+    info->all_loaded = FALSE;
+    info->loading = 0;
+
+    info->module_ctx.dwz = dwarf2_load_dwz(fmap, module);
+    dwarf2_load_CU_module(&info->module_ctx, module, info->sections, load_offset, thunks);
+
+    dwarf2_init_section(&aranges, fmap, ".debug_aranges", ".zdebug_aranges", &debug_aranges_sect);
+    dwarf2_index_units(info, &aranges);
+    dwarf2_fini_section(&aranges);
+    image_unmap_section(&debug_aranges_sect);
+    if (info->num_unit_ranges && section[section_line].address && section[section_line].address != IMAGE_NO_MAP)
+        module->module.LineNumbers = TRUE;
 
     dwarf2_modfmt->module->module.SymType = SymDia;
     /* hide dwarf versions in CVSig
      * bits 24-31 will be set according to found dwarf version
      * different CU can have different dwarf version, so use a bit per version (version 2 => b24)
      */
-    dwarf2_modfmt->module->module.CVSig = 'D' | ('W' << 8) | ('F' << 16) | ((module_ctx.cu_versions & 0xFF) << 24);
+    dwarf2_modfmt->module->module.CVSig = 'D' | ('W' << 8) | ('F' << 16) | ((info->module_ctx.cu_versions & 0xFF) << 24);
     /* FIXME: we could have a finer grain here */
     dwarf2_modfmt->module->module.GlobalSymbols = TRUE;
     dwarf2_modfmt->module->module.TypeInfo = TRUE;
     dwarf2_modfmt->module->module.SourceIndexed = TRUE;
     dwarf2_modfmt->module->module.Publics = TRUE;
+    return TRUE;
 
-    dwarf2_unload_CU_module(&module_ctx);
 leave:
-
     dwarf2_fini_section(&section[section_debug]);
     dwarf2_fini_section(&section[section_abbrev]);
     dwarf2_fini_section(&section[section_string]);
@@ -4299,7 +4605,7 @@ leave:
     image_unmap_section(&debug_str_sect);
     image_unmap_section(&debug_line_sect);
     image_unmap_section(&debug_ranges_sect);
-    if (!ret) image_unmap_section(&eh_frame_sect);
+    image_unmap_section(&eh_frame_sect);
 
-    return ret;
+    return FALSE;
 }
@@ -1031,7 +1031,7 @@ static BOOL elf_load_debug_info_from_map(struct module* module,
                                          struct hash_table* ht_symtab)
 {
     BOOL                ret = FALSE, lret;
-    struct elf_thunk_area thunks[] = 
+    static const struct elf_thunk_area elf_thunks[] =
     {
         {"__wine_spec_import_thunks",           THUNK_ORDINAL_NOTYPE, 0, 0},    /* inter DLL calls */
         {"__wine_spec_delayed_import_loaders",  THUNK_ORDINAL_LOAD,   0, 0},    /* delayed inter DLL calls */
@@ -1041,6 +1041,11 @@ static BOOL elf_load_debug_info_from_map(struct module* module,
         {"__wine_spec_thunk_text_32",           -32,                  0, 0},    /* 32 => 16 thunks */
         {NULL,                                  0,                    0, 0}
     };
+    struct elf_thunk_area* thunks;
+
+    /* the DWARF parser keeps a reference to the thunks (it loads its compilation units on demand) */
+    if (!(thunks = pool_alloc(&module->pool, sizeof(elf_thunks)))) return FALSE;
+    memcpy(thunks, elf_thunks, sizeof(elf_thunks));
 
     module->module.SymType = SymExport;
 
@@ -1254,6 +1259,8 @@ static BOOL elf_load_file_from_fmap(struct process* pcs, const WCHAR* filename,
         modfmt->module      = elf_info->module;
         modfmt->remove      = elf_module_remove;
         modfmt->loc_compute = NULL;
+        modfmt->request_addr = NULL;
+        modfmt->request_all = NULL;
         modfmt->u.elf_info  = elf_module_info;
 
         elf_module_info->elf_addr = load_offset;
@@ -1385,7 +1385,11 @@ static BOOL macho_load_debug_info(struct process *pcs, struct module* module)
 
         if (dwarf2_parse(module, module->reloc_delta, NULL /* FIXME: some thunks to deal with ? */,
                          &module->format_info[DFI_MACHO]->u.macho_info->file_map))
+        {
+            /* the symtab below is matched against all the DWARF symbols */
+            module_request_all(module);
             ret = TRUE;
+        }
     }
 
     mdi.fmap = fmap;
@@ -1491,6 +1495,8 @@ static BOOL macho_load_file(struct process* pcs, const WCHAR* filename,
         modfmt->module       = macho_info->module;
         modfmt->remove       = macho_module_remove;
         modfmt->loc_compute  = NULL;
+        modfmt->request_addr = NULL;
+        modfmt->request_all  = NULL;
         modfmt->u.macho_info = macho_module_info;
 
         macho_module_info->load_addr = load_addr;
@@ -227,6 +227,7 @@ struct module* module_new(struct process* pcs, const WCHAR* name,
     module->sorttab_size      = 0;
     module->addr_sorttab      = NULL;
     module->num_sorttab       = 0;
+    module->num_sorttail      = 0;
     module->num_symbols       = 0;
     module->cpu               = cpu_find(machine);
     if (!module->cpu)
@@ -403,6 +404,35 @@ BOOL module_get_debug(struct module_pair* pair)
     return module_load_debug(pair->effective);
 }
 
+/******************************************************************
+ *		module_request_addr
+ *
+ * Loads the lazily loaded debug information needed for looking up addr.
+ */
+void module_request_addr(struct module* module, DWORD64 addr)
+{
+    unsigned i;
+
+    for (i = 0; i < DFI_LAST; i++)
+        if (module->format_info[i] && module->format_info[i]->request_addr)
+            module->format_info[i]->request_addr(module->format_info[i], addr);
+}
+
+/******************************************************************
+ *		module_request_all
+ *
+ * Loads all the lazily loaded debug information (needed before enumerating
+ * or searching by name).
+ */
+void module_request_all(struct module* module)
+{
+    unsigned i;
+
+    for (i = 0; i < DFI_LAST; i++)
+        if (module->format_info[i] && module->format_info[i]->request_all)
+            module->format_info[i]->request_all(module->format_info[i]);
+}
+
 /***********************************************************************
  *	module_find_by_addr
  *
@@ -1454,7 +1484,7 @@ void module_reset_debug_info(struct module* module)
     module->sortlist_valid = TRUE;
     module->sorttab_size = 0;
     module->addr_sorttab = NULL;
-    module->num_sorttab = module->num_symbols = 0;
+    module->num_sorttab = module->num_sorttail = module->num_symbols = 0;
     hash_table_destroy(&module->ht_symbols);
     module->ht_symbols.num_buckets = 0;
     module->ht_symbols.buckets = NULL;
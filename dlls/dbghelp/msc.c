@@ -3835,6 +3835,8 @@ static BOOL pdb_process_file(const struct process* pcs,
     modfmt->module      = msc_dbg->module;
     modfmt->remove      = pdb_module_remove;
     modfmt->loc_compute = pdb_location_compute;
+    modfmt->request_addr = NULL;
+    modfmt->request_all = NULL;
     modfmt->u.pdb_info  = pdb_module_info;
 
     memset(cv_zmodules, 0, sizeof(cv_zmodules));
@@ -64,6 +64,9 @@ int __cdecl symt_cmp_addr(const void* p1, const void* p2)
 
 #define BASE_CUSTOM_SYMT 0x80000000
 
+/* minimal size of the second sorted run of addr_sorttab before it's merged into the main one */
+#define SORTTAB_MIN_TAIL 256
+
 /* dbghelp exposes the internal symbols/types with DWORD indexes.
  * - custom symbols are always stored with index starting at BASE_CUSTOM_SYMT
  * - for all the other (non custom) symbols:
@@ -249,6 +252,8 @@ struct symt_compiland* symt_new_compiland(struct module* module, unsigned src_id
     return sym;
 }
 
+static struct symt_ht* symt_find_nearest_loaded(struct module* module, DWORD_PTR addr);
+
 struct symt_public* symt_new_public(struct module* module, 
                                     struct symt_compiland* compiland,
                                     const char* name,
@@ -261,7 +266,7 @@ struct symt_public* symt_new_public(struct module* module,
     TRACE_(dbghelp_symt)("Adding public symbol %s:%s @%Ix\n",
                          debugstr_w(module->modulename), name, address);
     if ((dbghelp_options & SYMOPT_AUTO_PUBLICS) &&
-        symt_find_nearest(module, address) != NULL)
+        symt_find_nearest_loaded(module, address) != NULL)
         return NULL;
     if ((sym = pool_alloc(&module->pool, sizeof(*sym))))
     {
@@ -330,6 +335,7 @@ static void init_function_or_inlinesite(struct symt_function* sym,
     sym->type      = sig_type;
     sym->size      = size;
     vector_init(&sym->vlines,  sizeof(struct line_info), 64);
+    sym->line_index = NULL;
     vector_init(&sym->vchildren, sizeof(struct symt*), 8);
 }
 
@@ -911,6 +917,22 @@ static BOOL send_symbol(const struct sym_enum* se, struct module_pair* pair,
     return !se->cb(se->sym_info, se->sym_info->Size, se->user);
 }
 
+/* With SYMOPT_AUTO_PUBLICS, public symbols aren't created where debug information
+ * exists. As debug information can be loaded after the publics, hide the publics
+ * which are shadowed by a (then loaded) symbol.
+ */
+static BOOL symt_is_shadowed_public(struct module* module, const struct symt_ht* sym)
+{
+    struct symt_ht* nearest;
+    ULONG64         addr;
+
+    if (!(dbghelp_options & SYMOPT_AUTO_PUBLICS) || sym->symt.tag != SymTagPublicSymbol)
+        return FALSE;
+    symt_get_address(&sym->symt, &addr);
+    nearest = symt_find_nearest_loaded(module, addr);
+    return nearest && nearest->symt.tag != SymTagPublicSymbol;
+}
+
 static BOOL symt_enum_module(struct module_pair* pair, const WCHAR* match,
                              const struct sym_enum* se)
 {
@@ -920,10 +942,12 @@ static BOOL symt_enum_module(struct module_pair* pair, const WCHAR* match,
     WCHAR*                      nameW;
     BOOL                        ret;
 
+    module_request_all(pair->effective);
     hash_table_iter_init(&pair->effective->ht_symbols, &hti, NULL);
     while ((ptr = hash_table_iter_up(&hti)))
     {
         sym = CONTAINING_RECORD(ptr, struct symt_ht, hash_elt);
+        if (symt_is_shadowed_public(pair->effective, sym)) continue;
         nameW = symt_get_nameW(&sym->symt);
         ret = SymMatchStringW(nameW, match, FALSE);
         HeapFree(GetProcessHeap(), 0, nameW);
@@ -937,12 +961,12 @@ static BOOL symt_enum_module(struct module_pair* pair, const WCHAR* match,
     return FALSE;
 }
 
-static inline unsigned where_to_insert(struct module* module, unsigned high, const struct symt_ht* elt)
+static inline unsigned where_to_insert(struct module* module, unsigned low, unsigned high, const struct symt_ht* elt)
 {
-    unsigned    low = 0, mid = high / 2;
+    unsigned    mid = low + (high - low) / 2;
     ULONG64     addr;
 
-    if (!high) return 0;
+    if (low == high) return low;
     symt_get_address(&elt->symt, &addr);
     do
     {
@@ -957,59 +981,79 @@ static inline unsigned where_to_insert(struct module* module, unsigned high, con
     return mid;
 }
 
+/* merges the two consecutive sorted runs of addr_sorttab starting at base */
+static BOOL merge_sorttab_runs(struct module* module, unsigned base, unsigned count1, unsigned count2)
+{
+    static struct symt_ht** tmp;
+    static unsigned num_tmp;
+    unsigned ins_idx = base + count1, prev_ins_idx;
+    int i;
+
+    if (!count1 || !count2) return TRUE;
+    if (num_tmp < count2)
+    {
+        struct symt_ht** new;
+        if (tmp)
+            new = HeapReAlloc(GetProcessHeap(), 0, tmp, count2 * sizeof(struct symt_ht*));
+        else
+            new = HeapAlloc(GetProcessHeap(), 0, count2 * sizeof(struct symt_ht*));
+        if (!new) return FALSE;
+        tmp = new;
+        num_tmp = count2;
+    }
+    memcpy(tmp, &module->addr_sorttab[base + count1], count2 * sizeof(struct symt_ht*));
+
+    for (i = count2 - 1; i >= 0; i--)
+    {
+        prev_ins_idx = ins_idx;
+        ins_idx = where_to_insert(module, base, ins_idx, tmp[i]);
+        memmove(&module->addr_sorttab[ins_idx + i + 1],
+                &module->addr_sorttab[ins_idx],
+                (prev_ins_idx - ins_idx) * sizeof(struct symt_ht*));
+        module->addr_sorttab[ins_idx + i] = tmp[i];
+    }
+    return TRUE;
+}
+
 /***********************************************************************
  *              resort_symbols
  *
  * Rebuild sorted list of symbols for a module.
+ * The list is made of two sorted runs: the main one (num_sorttab symbols),
+ * followed by a smaller one (num_sorttail symbols) where the new symbols get
+ * merged. The smaller run is only merged into the main one when it gets big
+ * enough, so that symbols loaded on demand don't require to move the whole
+ * list on each lookup.
  */
 static BOOL resort_symbols(struct module* module)
 {
-    int delta;
+    unsigned delta, tail_start;
 
     if (!(module->module.NumSyms = module->num_symbols))
         return FALSE;
 
-    /* we know that set from 0 up to num_sorttab is already sorted
-     * so sort the remaining (new) symbols, and merge the two sets
-     * (unless the first set is empty)
+    /* we know that the two runs up to num_sorttab + num_sorttail are already
+     * sorted, so sort the remaining (new) symbols, and merge them into the second run
      */
-    delta = module->num_symbols - module->num_sorttab;
-    qsort(&module->addr_sorttab[module->num_sorttab], delta, sizeof(struct symt_ht*), symt_cmp_addr);
-    if (module->num_sorttab)
+    tail_start = module->num_sorttab;
+    delta = module->num_symbols - tail_start - module->num_sorttail;
+    qsort(&module->addr_sorttab[tail_start + module->num_sorttail], delta, sizeof(struct symt_ht*), symt_cmp_addr);
+    if (!merge_sorttab_runs(module, tail_start, module->num_sorttail, delta))
     {
-        int     i, ins_idx = module->num_sorttab, prev_ins_idx;
-        static struct symt_ht** tmp;
-        static unsigned num_tmp;
-
-        if (num_tmp < delta)
-        {
-            static struct symt_ht** new;
-            if (tmp)
-                new = HeapReAlloc(GetProcessHeap(), 0, tmp, delta * sizeof(struct symt_ht*));
-            else
-                new = HeapAlloc(GetProcessHeap(), 0, delta * sizeof(struct symt_ht*));
-            if (!new)
-            {
-                module->num_sorttab = 0;
-                return resort_symbols(module);
-            }
-            tmp = new;
-            num_tmp = delta;
-        }
-        memcpy(tmp, &module->addr_sorttab[module->num_sorttab], delta * sizeof(struct symt_ht*));
-        qsort(tmp, delta, sizeof(struct symt_ht*), symt_cmp_addr);
+        module->num_sorttab = module->num_sorttail = 0;
+        qsort(module->addr_sorttab, module->num_symbols, sizeof(struct symt_ht*), symt_cmp_addr);
+        module->num_sorttab = module->num_symbols;
+        return module->sortlist_valid = TRUE;
+    }
+    module->num_sorttail += delta;
 
-        for (i = delta - 1; i >= 0; i--)
-        {
-            prev_ins_idx = ins_idx;
-            ins_idx = where_to_insert(module, ins_idx, tmp[i]);
-            memmove(&module->addr_sorttab[ins_idx + i + 1],
-                    &module->addr_sorttab[ins_idx],
-                    (prev_ins_idx - ins_idx) * sizeof(struct symt_ht*));
-            module->addr_sorttab[ins_idx + i] = tmp[i];
-        }
+    if (!module->num_sorttab || module->num_sorttail > max(SORTTAB_MIN_TAIL, module->num_sorttab / 16))
+    {
+        if (!merge_sorttab_runs(module, 0, module->num_sorttab, module->num_sorttail))
+            qsort(module->addr_sorttab, module->num_symbols, sizeof(struct symt_ht*), symt_cmp_addr);
+        module->num_sorttab = module->num_symbols;
+        module->num_sorttail = 0;
     }
-    module->num_sorttab = module->num_symbols;
     return module->sortlist_valid = TRUE;
 }
 
@@ -1026,21 +1070,21 @@ static void symt_get_length(struct module* module, const struct symt* symt, ULON
 }
 
 /* needed by symt_find_nearest */
-static int symt_get_best_at(struct module* module, int idx_sorttab)
+static int symt_get_best_at(struct module* module, int idx_sorttab, unsigned base, unsigned count)
 {
     ULONG64 ref_addr;
     int idx_sorttab_orig = idx_sorttab;
     if (module->addr_sorttab[idx_sorttab]->symt.tag == SymTagPublicSymbol)
     {
         symt_get_address(&module->addr_sorttab[idx_sorttab]->symt, &ref_addr);
-        while (idx_sorttab > 0 &&
+        while (idx_sorttab > base &&
                module->addr_sorttab[idx_sorttab]->symt.tag == SymTagPublicSymbol &&
                !cmp_sorttab_addr(module, idx_sorttab - 1, ref_addr))
             idx_sorttab--;
         if (module->addr_sorttab[idx_sorttab]->symt.tag == SymTagPublicSymbol)
         {
             idx_sorttab = idx_sorttab_orig;
-            while (idx_sorttab < module->num_sorttab - 1 &&
+            while (idx_sorttab < base + count - 1 &&
                    module->addr_sorttab[idx_sorttab]->symt.tag == SymTagPublicSymbol &&
                    !cmp_sorttab_addr(module, idx_sorttab + 1, ref_addr))
                 idx_sorttab++;
@@ -1052,33 +1096,15 @@ static int symt_get_best_at(struct module* module, int idx_sorttab)
     return idx_sorttab;
 }
 
-/* assume addr is in module */
-struct symt_ht* symt_find_nearest(struct module* module, DWORD_PTR addr)
+/* binary search of the closest symbol in the sorted run [base, base + count) */
+static int symt_find_nearest_in_run(struct module* module, unsigned base, unsigned count, DWORD_PTR addr)
 {
     int         mid, high, low;
-    ULONG64     ref_addr, ref_size;
-
-    if (!module->sortlist_valid || !module->addr_sorttab)
-    {
-        if (!resort_symbols(module)) return NULL;
-    }
-
-    /*
-     * Binary search to find closest symbol.
-     */
-    low = 0;
-    high = module->num_sorttab;
 
-    symt_get_address(&module->addr_sorttab[0]->symt, &ref_addr);
-    if (addr < ref_addr) return NULL;
+    if (!count || cmp_sorttab_addr(module, base, addr) > 0) return -1;
 
-    if (high)
-    {
-        symt_get_address(&module->addr_sorttab[high - 1]->symt, &ref_addr);
-        symt_get_length(module, &module->addr_sorttab[high - 1]->symt, &ref_size);
-        if (addr >= ref_addr + ref_size) return NULL;
-    }
-    
+    low = base;
+    high = base + count;
     while (high > low + 1)
     {
         mid = (high + low) / 2;
@@ -1087,16 +1113,71 @@ struct symt_ht* symt_find_nearest(struct module* module, DWORD_PTR addr)
         else
             high = mid;
     }
-    if (low != high && high != module->num_sorttab &&
+    if (low != high && high != base + count &&
         cmp_sorttab_addr(module, high, addr) <= 0)
         low = high;
 
     /* If found symbol is a public symbol, check if there are any other entries that
      * might also have the same address, but would get better information
      */
-    low = symt_get_best_at(module, low);
+    return symt_get_best_at(module, low, base, count);
+}
+
+/* assume addr is in module
+ * only looks into the already loaded debug information
+ */
+static struct symt_ht* symt_find_nearest_loaded(struct module* module, DWORD_PTR addr)
+{
+    int         idx, idx_tail, last;
+    ULONG64     ref_addr, ref_size, tail_addr;
 
-    return module->addr_sorttab[low];
+    if (!module->sortlist_valid || !module->addr_sorttab)
+    {
+        if (!resort_symbols(module)) return NULL;
+    }
+
+    /* the symbol with the highest address bounds the lookup */
+    last = module->num_sorttab ? module->num_sorttab - 1 : -1;
+    if (module->num_sorttail)
+    {
+        idx_tail = module->num_sorttab + module->num_sorttail - 1;
+        symt_get_address(&module->addr_sorttab[idx_tail]->symt, &tail_addr);
+        if (last == -1 || cmp_sorttab_addr(module, last, tail_addr) < 0)
+            last = idx_tail;
+    }
+    if (last < 0) return NULL;
+    symt_get_address(&module->addr_sorttab[last]->symt, &ref_addr);
+    symt_get_length(module, &module->addr_sorttab[last]->symt, &ref_size);
+    if (addr >= ref_addr + ref_size) return NULL;
+
+    idx = symt_find_nearest_in_run(module, 0, module->num_sorttab, addr);
+    idx_tail = symt_find_nearest_in_run(module, module->num_sorttab, module->num_sorttail, addr);
+    if (idx_tail != -1)
+    {
+        /* keep the closest one, and at same address, the one with better information */
+        if (idx == -1) idx = idx_tail;
+        else
+        {
+            symt_get_address(&module->addr_sorttab[idx_tail]->symt, &tail_addr);
+            switch (cmp_sorttab_addr(module, idx, tail_addr))
+            {
+            case -1: idx = idx_tail; break;
+            case 0:
+                if (module->addr_sorttab[idx]->symt.tag == SymTagPublicSymbol &&
+                    module->addr_sorttab[idx_tail]->symt.tag != SymTagPublicSymbol)
+                    idx = idx_tail;
+                break;
+            }
+        }
+    }
+    return idx == -1 ? NULL : module->addr_sorttab[idx];
+}
+
+/* assume addr is in module */
+struct symt_ht* symt_find_nearest(struct module* module, DWORD_PTR addr)
+{
+    module_request_addr(module, addr);
+    return symt_find_nearest_loaded(module, addr);
 }
 
 struct symt_ht* symt_find_symbol_at(struct module* module, DWORD_PTR addr)
@@ -1627,12 +1708,13 @@ static BOOL find_name(struct process* pcs, struct module* module, const char* na
     if (!(pair.requested = module)) return FALSE;
     if (!module_get_debug(&pair)) return FALSE;
 
+    module_request_all(pair.effective);
     hash_table_iter_init(&pair.effective->ht_symbols, &hti, name);
     while ((ptr = hash_table_iter_up(&hti)))
     {
         sym = CONTAINING_RECORD(ptr, struct symt_ht, hash_elt);
 
-        if (!strcmp(sym->hash_elt.name, name))
+        if (!strcmp(sym->hash_elt.name, name) && !symt_is_shadowed_public(pair.effective, sym))
         {
             symt_fill_sym_info(&pair, NULL, &sym->symt, symbol);
             return TRUE;
@@ -1902,44 +1984,116 @@ static BOOL internal_line_set_nameW(struct process* pcs, struct internal_line_t*
     return TRUE;
 }
 
+/* minimal number of lines in a function before they get indexed */
+#define LINE_INDEX_MIN 16
+
+struct line_addr_entry
+{
+    ULONG_PTR                   address;
+    unsigned                    line_idx;       /* index in vlines of the line */
+    unsigned                    file_idx;       /* index in vlines of the line's source file */
+};
+
+struct line_addr_index
+{
+    unsigned                    num_lines;      /* size of vlines when the index was built */
+    unsigned                    count;
+    struct line_addr_entry      entries[1];
+};
+
+static int __cdecl line_index_compare(const void* p1, const void* p2)
+{
+    const struct line_addr_entry* e1 = p1;
+    const struct line_addr_entry* e2 = p2;
+
+    if (e1->address != e2->address) return e1->address < e2->address ? -1 : 1;
+    /* at same address, keep the order of insertion */
+    return e1->line_idx < e2->line_idx ? -1 : (e1->line_idx > e2->line_idx);
+}
+
+static struct line_addr_index* symt_get_line_index(struct module* module, struct symt_function* func)
+{
+    struct line_addr_index*     index = func->line_index;
+    unsigned                    num_lines = vector_length(&func->vlines), i, file_idx = ~0u;
+    struct line_info*           dli;
+
+    /* lines are only added while loading the function, so the index rarely needs a rebuild */
+    if (index && index->num_lines == num_lines) return index;
+    if (!(index = pool_alloc(&module->pool, offsetof(struct line_addr_index, entries[num_lines]))))
+        return NULL;
+    index->num_lines = num_lines;
+    index->count = 0;
+    for (i = 0; i < num_lines; i++)
+    {
+        dli = vector_at(&func->vlines, i);
+        if (dli->is_source_file)
+            file_idx = i;
+        else if (file_idx != ~0u)
+        {
+            index->entries[index->count].address = dli->u.address;
+            index->entries[index->count].line_idx = i;
+            index->entries[index->count].file_idx = file_idx;
+            index->count++;
+        }
+    }
+    qsort(index->entries, index->count, sizeof(index->entries[0]), line_index_compare);
+    return func->line_index = index;
+}
+
 static BOOL get_line_from_function(struct module_pair* pair, struct symt_function* func, DWORD64 addr,
                                    PDWORD pdwDisplacement, struct internal_line_t* intl)
 {
     struct line_info*           dli = NULL;
     struct line_info*           found_dli = NULL;
+    struct line_addr_index*     index;
+    BOOL                        ret;
     int                         i;
 
-    for (i = vector_length(&func->vlines) - 1; i >= 0; i--)
+    if (vector_length(&func->vlines) >= LINE_INDEX_MIN &&
+        (index = symt_get_line_index(pair->effective, func)))
     {
-        dli = vector_at(&func->vlines, i);
-        if (!dli->is_source_file)
+        int low = 0, high = index->count, mid;
+
+        /* look for the last line at or before addr */
+        while (low < high)
         {
-            if (found_dli || dli->u.address > addr) continue;
-            intl->line_number = dli->line_number;
-            intl->address     = dli->u.address;
-            intl->key         = dli;
-            found_dli = dli;
-            continue;
+            mid = (low + high) / 2;
+            if (index->entries[mid].address <= addr) low = mid + 1; else high = mid;
         }
-        if (found_dli)
+        if (!low) return FALSE;
+        found_dli = vector_at(&func->vlines, index->entries[low - 1].line_idx);
+        dli = vector_at(&func->vlines, index->entries[low - 1].file_idx);
+    }
+    else
+    {
+        for (i = vector_length(&func->vlines) - 1; i >= 0; i--)
         {
-            BOOL ret;
-            if (dbghelp_opt_native)
-            {
-                /* Return native file paths when using winedbg */
-                ret = internal_line_set_nameA(pair->pcs, intl, (char*)source_get(pair->effective, dli->u.source_file), FALSE);
-            }
-            else
+            dli = vector_at(&func->vlines, i);
+            if (!dli->is_source_file)
             {
-                WCHAR *dospath = wine_get_dos_file_name(source_get(pair->effective, dli->u.source_file));
-                ret = internal_line_set_nameW(pair->pcs, intl, dospath, TRUE);
-                HeapFree( GetProcessHeap(), 0, dospath );
+                if (!found_dli && dli->u.address <= addr) found_dli = dli;
             }
-            if (ret && pdwDisplacement) *pdwDisplacement = addr - found_dli->u.address;
-            return ret;
+            else if (found_dli) break;
         }
+        if (i < 0) return FALSE;
     }
-    return FALSE;
+
+    intl->line_number = found_dli->line_number;
+    intl->address     = found_dli->u.address;
+    intl->key         = found_dli;
+    if (dbghelp_opt_native)
+    {
+        /* Return native file paths when using winedbg */
+        ret = internal_line_set_nameA(pair->pcs, intl, (char*)source_get(pair->effective, dli->u.source_file), FALSE);
+    }
+    else
+    {
+        WCHAR *dospath = wine_get_dos_file_name(source_get(pair->effective, dli->u.source_file));
+        ret = internal_line_set_nameW(pair->pcs, intl, dospath, TRUE);
+        HeapFree( GetProcessHeap(), 0, dospath );
+    }
+    if (ret && pdwDisplacement) *pdwDisplacement = addr - found_dli->u.address;
+    return ret;
 }
 
 /******************************************************************
@@ -2584,6 +2738,7 @@ BOOL WINAPI SymEnumLines(HANDLE hProcess, ULONG64 base, PCSTR compiland,
     sci.SizeOfStruct = sizeof(sci);
     sci.ModBase      = base;
 
+    module_request_all(pair.effective);
     hash_table_iter_init(&pair.effective->ht_symbols, &hti, NULL);
     while ((ptr = hash_table_iter_up(&hti)))
     {
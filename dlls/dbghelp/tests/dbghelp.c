@@ -190,6 +190,115 @@ static void test_search_path(void)
     ok(!strcmp(search_path, "."), "Got search path '%s', expected '.'\n", search_path);
 }
 
+static void test_load_module_symbols(void)
+{
+    static const char * const names[] = {"RtlInitUnicodeString", "RtlAllocateHeap", "RtlFreeHeap", "LdrGetProcedureAddress"};
+    char si_buf[sizeof(SYMBOL_INFO) + 200];
+    SYMBOL_INFO *si = (SYMBOL_INFO *)si_buf;
+    HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+    DWORD start, load_time, lookup_time;
+    char path[MAX_PATH];
+    DWORD64 base, disp;
+    HANDLE process;
+    unsigned int i, j;
+    BOOL ret;
+
+    ret = DuplicateHandle(GetCurrentProcess(), GetCurrentProcess(), GetCurrentProcess(), &process,
+                          0, FALSE, DUPLICATE_SAME_ACCESS);
+    ok(ret, "got error %lu\n", GetLastError());
+    ret = SymInitialize(process, NULL, FALSE);
+    ok(ret, "got error %lu\n", GetLastError());
+    GetModuleFileNameA(ntdll, path, ARRAY_SIZE(path));
+
+    start = GetTickCount();
+    base = SymLoadModuleEx(process, NULL, path, NULL, (DWORD_PTR)ntdll, 0, NULL, 0);
+    load_time = GetTickCount() - start;
+    ok(base == (DWORD_PTR)ntdll, "got %#I64x, error %lu\n", base, GetLastError());
+
+    /* lookups by address only need the debug information around that address */
+    start = GetTickCount();
+    for (j = 0; j < 100; j++)
+    {
+        for (i = 0; i < ARRAY_SIZE(names); i++)
+        {
+            si->SizeOfStruct = sizeof(*si);
+            si->MaxNameLen = 200;
+            ret = SymFromAddr(process, (DWORD_PTR)GetProcAddress(ntdll, names[i]), &disp, si);
+            ok(ret, "got error %lu\n", GetLastError());
+            if (!ret) break;
+            ok(!strcmp(si->Name, names[i]), "got %s, expected %s\n", si->Name, names[i]);
+            ok(!disp, "got disp %#I64x\n", disp);
+        }
+    }
+    lookup_time = GetTickCount() - start;
+
+    /* data symbols aren't in the code ranges */
+    si->SizeOfStruct = sizeof(*si);
+    si->MaxNameLen = 200;
+    ret = SymFromAddr(process, (DWORD_PTR)GetProcAddress(ntdll, "NlsMbCodePageTag"), &disp, si);
+    ok(ret, "got error %lu\n", GetLastError());
+    if (ret) ok(!strcmp(si->Name, "NlsMbCodePageTag"), "got %s\n", si->Name);
+
+    /* lookups by name need everything */
+    for (i = 0; i < ARRAY_SIZE(names); i++)
+    {
+        si->SizeOfStruct = sizeof(*si);
+        si->MaxNameLen = 200;
+        ret = SymFromName(process, names[i], si);
+        ok(ret, "got error %lu\n", GetLastError());
+        ok(si->Address == (DWORD_PTR)GetProcAddress(ntdll, names[i]), "got %#I64x for %s\n", si->Address, names[i]);
+    }
+
+    if (winetest_debug > 1)
+        trace("loading %s took %lu ms, %u lookups took %lu ms\n", path, load_time,
+              100 * (unsigned int)ARRAY_SIZE(names), lookup_time);
+
+    ret = SymCleanup(process);
+    ok(ret, "got error %lu\n", GetLastError());
+    CloseHandle(process);
+}
+
+static void test_sampled_lookups(void)
+{
+    char si_buf[sizeof(SYMBOL_INFO) + 200];
+    SYMBOL_INFO *si = (SYMBOL_INFO *)si_buf;
+    HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+    IMAGEHLP_MODULE64 info = {sizeof(info)};
+    unsigned int i, found = 0, found_lines = 0;
+    IMAGEHLP_LINE64 line;
+    DWORD64 addr, disp;
+    DWORD start, disp32;
+    BOOL ret;
+
+    /* look up addresses spread over a module, the way a sampling profiler does */
+    ret = SymGetModuleInfo64(GetCurrentProcess(), (DWORD_PTR)ntdll, &info);
+    ok(ret, "got error %lu\n", GetLastError());
+    if (!ret) return;
+
+    start = GetTickCount();
+    for (i = 0; i < 20000; i++)
+    {
+        addr = info.BaseOfImage + (i * 7919ull) % info.ImageSize;
+        si->SizeOfStruct = sizeof(*si);
+        si->MaxNameLen = 200;
+        if (SymFromAddr(GetCurrentProcess(), addr, &disp, si))
+        {
+            ok(si->Address <= addr && si->Address + disp == addr, "got %#I64x + %#I64x for %#I64x\n",
+               si->Address, disp, addr);
+            found++;
+        }
+        line.SizeOfStruct = sizeof(line);
+        if (SymGetLineFromAddr64(GetCurrentProcess(), addr, &disp32, &line))
+        {
+            ok(line.Address <= addr && line.Address + disp32 == addr, "got %#I64x + %#lx for %#I64x\n",
+               line.Address, disp32, addr);
+            found_lines++;
+        }
+    }
+    if (winetest_debug > 1)
+        trace("%u lookups (%u symbols, %u lines found) took %lu ms\n", i, found, found_lines, GetTickCount() - start);
+}
+
 START_TEST(dbghelp)
 {
     BOOL ret;
@@ -203,6 +312,8 @@ START_TEST(dbghelp)
 
     test_stack_walk();
     test_search_path();
+    test_load_module_symbols();
+    test_sampled_lookups();
 
     ret = SymCleanup(GetCurrentProcess());
     ok(ret, "got error %lu\n", GetLastError());
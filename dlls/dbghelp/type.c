@@ -486,6 +486,7 @@ BOOL WINAPI SymEnumTypes(HANDLE hProcess, ULONG64 BaseOfDll,
     sym_info->SizeOfStruct = sizeof(SYMBOL_INFO);
     sym_info->MaxNameLen = sizeof(buffer) - sizeof(SYMBOL_INFO);
 
+    module_request_all(pair.effective);
     for (i=0; i<vector_length(&pair.effective->vtypes); i++)
     {
         type = *(struct symt**)vector_at(&pair.effective->vtypes, i);
@@ -550,6 +551,7 @@ static void enum_types_of_module(struct module_pair* pair, const char* name, PSY
     sym_info->SizeOfStruct = sizeof(SYMBOL_INFO);
     sym_info->MaxNameLen = sizeof(buffer) - sizeof(SYMBOL_INFO);
 
+    module_request_all(pair->effective);
     for (i = 0; i < vector_length(&pair->effective->vtypes); i++)
     {
         type = *(struct symt**)vector_at(&pair->effective->vtypes, i);
@@ -1181,6 +1183,7 @@ BOOL WINAPI SymGetTypeFromName(HANDLE hProcess, ULONG64 BaseOfDll,
     DWORD64             size;
 
     if (!module_init_pair(&pair, hProcess, BaseOfDll)) return FALSE;
+    module_request_all(pair.effective);
     type = symt_find_type_by_name(pair.effective, SymTagNull, Name);
     if (!type) return FALSE;
     Symbol->Index = Symbol->TypeIndex = symt_ptr2index(pair.effective, type);
@@ -111,6 +111,39 @@ float get_mono(const IDirectSoundBufferImpl *dsb, BYTE *base, DWORD channel)
     return val;
 }
 
+/* Convert "count" frames of one channel starting at "base" to float, writing
+ * them "stride" floats apart. This keeps the per-frame function pointer call
+ * out of the common cases. */
+void get_samples(const IDirectSoundBufferImpl *dsb, BYTE *base, DWORD channel,
+        UINT count, float *dst, UINT stride)
+{
+    UINT istride = dsb->pwfx->nBlockAlign, i;
+
+    if (dsb->get == get8)
+    {
+        const BYTE *buf = base + channel;
+        for (i = 0; i < count; ++i, buf += istride)
+            dst[i * stride] = (buf[0] - 0x80) / (float)0x80;
+    }
+    else if (dsb->get == get16)
+    {
+        const BYTE *buf = base + 2 * channel;
+        for (i = 0; i < count; ++i, buf += istride)
+            dst[i * stride] = (SHORT)le16(*(const SHORT *)buf) / (float)0x8000;
+    }
+    else if (dsb->get == getieee32)
+    {
+        const BYTE *buf = base + 4 * channel;
+        for (i = 0; i < count; ++i, buf += istride)
+            dst[i * stride] = *(const float *)buf;
+    }
+    else
+    {
+        for (i = 0; i < count; ++i, base += istride)
+            dst[i * stride] = dsb->get(dsb, base, channel);
+    }
+}
+
 static inline unsigned char f_to_8(float value)
 {
     if(value <= -1.f)
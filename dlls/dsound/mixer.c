@@ -283,6 +283,46 @@ static inline float get_current_sample(const IDirectSoundBufferImpl *dsb,
     return dsb->get(dsb, buffer + (mixpos % buflen), channel);
 }
 
+/* Block version of get_current_sample(); splits the range at the end of the
+ * buffer so that each contiguous run is converted in one go. */
+static void get_current_samples(const IDirectSoundBufferImpl *dsb, BYTE *buffer, DWORD buflen,
+        DWORD mixpos, DWORD channel, UINT count, float *dst, UINT stride)
+{
+    UINT istride = dsb->pwfx->nBlockAlign;
+
+    while (count)
+    {
+        UINT run;
+
+        if (mixpos >= buflen)
+        {
+            if (!(dsb->playflags & DSBPLAY_LOOPING))
+            {
+                for (; count; --count, dst += stride)
+                    *dst = 0.0f;
+                return;
+            }
+            mixpos %= buflen;
+        }
+
+        if (!(run = (buflen - mixpos) / istride))
+        {
+            /* a partial frame at the end of the buffer */
+            *dst = get_current_sample(dsb, buffer, buflen, mixpos, channel);
+            run = 1;
+        }
+        else
+        {
+            run = min(run, count);
+            get_samples(dsb, buffer + mixpos, channel, run, dst, stride);
+        }
+
+        count -= run;
+        mixpos += run * istride;
+        dst += run * stride;
+    }
+}
+
 static UINT cp_fields_noresample(IDirectSoundBufferImpl *dsb, UINT count)
 {
     UINT istride = dsb->pwfx->nBlockAlign;
@@ -298,6 +338,24 @@ static UINT cp_fields_noresample(IDirectSoundBufferImpl *dsb, UINT count)
         committed_samples = committed_samples <= count ? committed_samples : count;
     }
 
+    if (dsb->put == putieee32)
+    {
+        /* Straight copy; convert directly into the interleaved output. */
+        UINT ochannels = dsb->device->pwfx->nChannels;
+
+        for (channel = 0; channel < dsb->mix_channels; channel++)
+        {
+            float *dst = dsb->device->tmp_buffer + channel;
+
+            get_current_samples(dsb, dsb->committedbuff, dsb->writelead,
+                    dsb->committed_mixpos, channel, committed_samples, dst, ochannels);
+            get_current_samples(dsb, dsb->buffer->memory, dsb->buflen,
+                    dsb->sec_mixpos + committed_samples * istride, channel,
+                    count - committed_samples, dst + committed_samples * ochannels, ochannels);
+        }
+        return count;
+    }
+
     for (i = 0; i < committed_samples; i++)
         for (channel = 0; channel < dsb->mix_channels; channel++)
             dsb->put(dsb, i * ostride, channel, get_current_sample(dsb, dsb->committedbuff,
@@ -359,12 +417,12 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
      */
     itmp = intermediate;
     for (channel = 0; channel < channels; channel++) {
-        for (i = 0; i < committed_samples; i++)
-            *(itmp++) = get_current_sample(dsb, dsb->committedbuff,
-                dsb->writelead, dsb->committed_mixpos + i * istride, channel);
-        for (; i < required_input; i++)
-            *(itmp++) = get_current_sample(dsb, dsb->buffer->memory,
-                    dsb->buflen, dsb->sec_mixpos + i * istride, channel);
+        get_current_samples(dsb, dsb->committedbuff, dsb->writelead,
+                dsb->committed_mixpos, channel, committed_samples, itmp, 1);
+        get_current_samples(dsb, dsb->buffer->memory, dsb->buflen,
+                dsb->sec_mixpos + committed_samples * istride, channel,
+                required_input - committed_samples, itmp + committed_samples, 1);
+        itmp += required_input;
     }
 
     for(i = 0; i < count; ++i) {
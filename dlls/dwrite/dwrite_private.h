@@ -252,6 +252,7 @@ struct dwrite_fontface
         size_t max_size;
         size_t size;
     } cache;
+    struct glyph_cache_font *glyph_cache_font;
     CRITICAL_SECTION cs;
 
     USHORT simulations;
@@ -464,12 +465,19 @@ struct tag_array
     size_t count;
 };
 
+struct ot_lookup_digest
+{
+    UINT64 mask[2];
+};
+
 struct ot_gsubgpos_table
 {
     struct dwrite_fonttable table;
     unsigned int script_list;
     unsigned int feature_list;
     unsigned int lookup_list;
+    struct ot_lookup_digest *lookup_digests;
+    unsigned int lookup_digest_count;
 };
 
 struct dwrite_var_axis
@@ -619,6 +627,15 @@ struct scriptshaping_cache
         unsigned int markattachclassdef;
         unsigned int markglyphsetdef;
     } gdef;
+
+    /* Recently shaped short runs, see shape_get_glyphs(). */
+    struct
+    {
+        CRITICAL_SECTION cs;
+        struct wine_rb_tree tree;
+        struct list mru;
+        unsigned int count;
+    } runs;
 };
 
 struct shaping_glyph_info
@@ -60,21 +60,239 @@ struct cache_entry
     struct cache_key key;
     int advance;
     RECT bbox;
-    BYTE *bitmap;
-    unsigned int bitmap_size;
-    unsigned int is_1bpp : 1;
     unsigned int has_contours : 1;
     unsigned int has_advance : 1;
     unsigned int has_bbox : 1;
-    unsigned int has_bitmap : 1;
 };
 
 static void fontface_release_cache_entry(struct cache_entry *entry)
 {
-    free(entry->bitmap);
     free(entry);
 }
 
+/* Rendered glyph bitmaps are kept in a process wide cache, shared by all faces
+   created for the same font file, face index and simulations. Bitmaps of local
+   font files survive face destruction, so recreating a face, or creating it
+   from another factory, does not rasterize the same glyphs again. Bitmaps of
+   files from other loaders are dropped with the last face using them, so the
+   cache never outlives, or holds references to, application loaders. */
+struct glyph_cache_font
+{
+    struct list entry;
+    LONG refcount;
+    LONG faces;
+    IDWriteFontFileLoader *loader; /* only used for comparison, not referenced */
+    void *key;
+    UINT32 key_size;
+    UINT32 index;
+    USHORT simulations;
+};
+
+struct glyph_cache_key
+{
+    const struct glyph_cache_font *font;
+    float size;
+    unsigned short glyph;
+    unsigned short mode;
+};
+
+struct glyph_cache_entry
+{
+    struct wine_rb_entry entry;
+    struct list mru;
+    struct glyph_cache_key key;
+    unsigned int bitmap_size;
+    unsigned int is_1bpp;
+    BYTE bitmap[1];
+};
+
+static int glyph_cache_compare(const void *k, const struct wine_rb_entry *e)
+{
+    const struct glyph_cache_entry *entry = WINE_RB_ENTRY_VALUE(e, const struct glyph_cache_entry, entry);
+    const struct glyph_cache_key *key = k, *key2 = &entry->key;
+
+    if (key->font != key2->font) return key->font < key2->font ? -1 : 1;
+    if (key->size != key2->size) return key->size < key2->size ? -1 : 1;
+    if (key->glyph != key2->glyph) return (int)key->glyph - (int)key2->glyph;
+    if (key->mode != key2->mode) return (int)key->mode - (int)key2->mode;
+    return 0;
+}
+
+static struct
+{
+    struct list fonts;
+    struct wine_rb_tree tree;
+    struct list mru;
+    size_t max_size;
+    size_t size;
+}
+glyph_cache =
+{
+    LIST_INIT(glyph_cache.fonts),
+    { glyph_cache_compare },
+    LIST_INIT(glyph_cache.mru),
+    0x400000,
+};
+
+static CRITICAL_SECTION glyph_cache_cs;
+static CRITICAL_SECTION_DEBUG glyph_cache_cs_debug =
+{
+    0, 0, &glyph_cache_cs,
+    { &glyph_cache_cs_debug.ProcessLocksList, &glyph_cache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": glyph_cache_cs") }
+};
+static CRITICAL_SECTION glyph_cache_cs = { &glyph_cache_cs_debug, -1, 0, 0, 0, 0 };
+
+/* Called with glyph_cache_cs held. */
+static void glyph_cache_release_font(struct glyph_cache_font *font)
+{
+    if (--font->refcount) return;
+
+    list_remove(&font->entry);
+    free(font->key);
+    free(font);
+}
+
+static struct glyph_cache_font *glyph_cache_get_font(IDWriteFontFile *file, UINT32 index, USHORT simulations)
+{
+    struct glyph_cache_font *font = NULL, *cur;
+    IDWriteFontFileLoader *loader;
+    const void *key;
+    UINT32 key_size;
+
+    if (FAILED(IDWriteFontFile_GetReferenceKey(file, &key, &key_size)))
+        return NULL;
+    if (FAILED(IDWriteFontFile_GetLoader(file, &loader)))
+        return NULL;
+
+    EnterCriticalSection(&glyph_cache_cs);
+
+    LIST_FOR_EACH_ENTRY(cur, &glyph_cache.fonts, struct glyph_cache_font, entry)
+    {
+        if (cur->loader == loader && cur->index == index && cur->simulations == simulations
+                && cur->key_size == key_size && !memcmp(cur->key, key, key_size))
+        {
+            font = cur;
+            font->refcount++;
+            font->faces++;
+            break;
+        }
+    }
+
+    if (!font && (font = calloc(1, sizeof(*font))))
+    {
+        if ((font->key = malloc(key_size)))
+        {
+            memcpy(font->key, key, key_size);
+            font->key_size = key_size;
+            font->index = index;
+            font->simulations = simulations;
+            font->loader = loader;
+            font->refcount = 1;
+            font->faces = 1;
+            list_add_head(&glyph_cache.fonts, &font->entry);
+        }
+        else
+        {
+            free(font);
+            font = NULL;
+        }
+    }
+
+    LeaveCriticalSection(&glyph_cache_cs);
+
+    IDWriteFontFileLoader_Release(loader);
+    return font;
+}
+
+static BOOL glyph_cache_get_bitmap(const struct glyph_cache_key *key, BYTE *bitmap, unsigned int size,
+        unsigned int *is_1bpp)
+{
+    struct glyph_cache_entry *entry;
+    struct wine_rb_entry *e;
+    BOOL ret = FALSE;
+
+    EnterCriticalSection(&glyph_cache_cs);
+    if ((e = wine_rb_get(&glyph_cache.tree, key)))
+    {
+        entry = WINE_RB_ENTRY_VALUE(e, struct glyph_cache_entry, entry);
+        if (entry->bitmap_size == size)
+        {
+            memcpy(bitmap, entry->bitmap, size);
+            *is_1bpp = entry->is_1bpp;
+            list_remove(&entry->mru);
+            list_add_head(&glyph_cache.mru, &entry->mru);
+            ret = TRUE;
+        }
+    }
+    LeaveCriticalSection(&glyph_cache_cs);
+
+    return ret;
+}
+
+static void glyph_cache_remove_entry(struct glyph_cache_entry *entry)
+{
+    glyph_cache.size -= offsetof(struct glyph_cache_entry, bitmap[entry->bitmap_size]);
+    wine_rb_remove(&glyph_cache.tree, &entry->entry);
+    list_remove(&entry->mru);
+    glyph_cache_release_font((struct glyph_cache_font *)entry->key.font);
+    free(entry);
+}
+
+static void glyph_cache_put_font(struct glyph_cache_font *font)
+{
+    struct glyph_cache_entry *entry, *next;
+
+    if (!font) return;
+
+    EnterCriticalSection(&glyph_cache_cs);
+    if (!--font->faces && font->loader != get_local_fontfile_loader())
+    {
+        LIST_FOR_EACH_ENTRY_SAFE(entry, next, &glyph_cache.mru, struct glyph_cache_entry, mru)
+        {
+            if (entry->key.font == font)
+                glyph_cache_remove_entry(entry);
+        }
+    }
+    glyph_cache_release_font(font);
+    LeaveCriticalSection(&glyph_cache_cs);
+}
+
+static void glyph_cache_add_bitmap(const struct glyph_cache_key *key, const BYTE *bitmap, unsigned int size,
+        unsigned int is_1bpp)
+{
+    size_t entry_size = offsetof(struct glyph_cache_entry, bitmap[size]);
+    struct glyph_cache_entry *entry;
+    struct wine_rb_entry *e;
+
+    /* Don't let a single huge glyph flush the whole cache. */
+    if (entry_size > glyph_cache.max_size / 16)
+        return;
+
+    if (!(entry = malloc(entry_size)))
+        return;
+    entry->key = *key;
+    entry->bitmap_size = size;
+    entry->is_1bpp = is_1bpp;
+    memcpy(entry->bitmap, bitmap, size);
+
+    EnterCriticalSection(&glyph_cache_cs);
+
+    /* Another thread may have rendered the same glyph meanwhile. */
+    if ((e = wine_rb_get(&glyph_cache.tree, key)))
+        glyph_cache_remove_entry(WINE_RB_ENTRY_VALUE(e, struct glyph_cache_entry, entry));
+
+    while (glyph_cache.size + entry_size > glyph_cache.max_size && !list_empty(&glyph_cache.mru))
+        glyph_cache_remove_entry(LIST_ENTRY(list_tail(&glyph_cache.mru), struct glyph_cache_entry, mru));
+
+    wine_rb_put(&glyph_cache.tree, &entry->key, &entry->entry);
+    list_add_head(&glyph_cache.mru, &entry->mru);
+    ((struct glyph_cache_font *)key->font)->refcount++;
+    glyph_cache.size += entry_size;
+
+    LeaveCriticalSection(&glyph_cache_cs);
+}
+
 static struct cache_entry * fontface_get_cache_entry(struct dwrite_fontface *fontface, size_t size,
         const struct cache_key *key)
 {
@@ -92,7 +310,7 @@ static struct cache_entry * fontface_get_cache_entry(struct dwrite_fontface *fon
         if ((fontface->cache.size + size > fontface->cache.max_size) && !list_empty(&fontface->cache.mru))
         {
             old_entry = LIST_ENTRY(list_tail(&fontface->cache.mru), struct cache_entry, mru);
-            fontface->cache.size -= (old_entry->bitmap_size + sizeof(*old_entry));
+            fontface->cache.size -= sizeof(*old_entry);
             wine_rb_remove(&fontface->cache.tree, &old_entry->entry);
             list_remove(&old_entry->mru);
             fontface_release_cache_entry(old_entry);
@@ -187,17 +405,15 @@ static unsigned int get_glyph_bitmap_pitch(DWRITE_RENDERING_MODE1 rendering_mode
 static HRESULT dwrite_fontface_get_glyph_bitmap(struct dwrite_fontface *fontface, DWRITE_RENDERING_MODE rendering_mode,
         unsigned int *is_1bpp, struct dwrite_glyphbitmap *bitmap)
 {
-    struct cache_key key = { .size = bitmap->emsize, .glyph = bitmap->glyph, .mode = DWRITE_MEASURING_MODE_NATURAL };
+    struct glyph_cache_key key = { .font = fontface->glyph_cache_font, .size = bitmap->emsize,
+            .glyph = bitmap->glyph, .mode = rendering_mode };
     struct get_glyph_bitmap_params params;
     const RECT *bbox = &bitmap->bbox;
-    unsigned int bitmap_size, _1bpp;
-    struct cache_entry *entry;
-    HRESULT hr = S_OK;
+    unsigned int bitmap_size;
 
     bitmap_size = get_glyph_bitmap_pitch(rendering_mode, bbox->right - bbox->left) *
             (bbox->bottom - bbox->top);
 
-    params.object = fontface->get_font_object(fontface);
     params.simulations = fontface->simulations;
     params.glyph = bitmap->glyph;
     params.mode = rendering_mode;
@@ -208,36 +424,26 @@ static HRESULT dwrite_fontface_get_glyph_bitmap(struct dwrite_fontface *fontface
     params.bitmap = bitmap->buf;
     params.is_1bpp = is_1bpp;
 
-    EnterCriticalSection(&fontface->cs);
     /* For now bypass cache for transformed cases. */
-    if (memcmp(&params.m, &identity, sizeof(params.m)))
-    {
-        UNIX_CALL(get_glyph_bitmap, &params);
-    }
-    else if ((entry = fontface_get_cache_entry(fontface, bitmap_size, &key)))
+    if (key.font && !memcmp(&params.m, &identity, sizeof(params.m)))
     {
-        if (entry->has_bitmap)
-        {
-            memcpy(bitmap->buf, entry->bitmap, entry->bitmap_size);
-        }
-        else
-        {
-            params.is_1bpp = &_1bpp;
-            UNIX_CALL(get_glyph_bitmap, &params);
-
-            entry->bitmap_size = bitmap_size;
-            if ((entry->bitmap = malloc(entry->bitmap_size)))
-                memcpy(entry->bitmap, bitmap->buf, entry->bitmap_size);
-            entry->is_1bpp = !!_1bpp;
-            entry->has_bitmap = 1;
-        }
-        *is_1bpp = entry->is_1bpp;
+        if (glyph_cache_get_bitmap(&key, bitmap->buf, bitmap_size, is_1bpp))
+            return S_OK;
     }
     else
-        hr = E_FAIL;
+        key.font = NULL;
+
+    /* The font object is only created when something has to be rendered. */
+    params.object = fontface->get_font_object(fontface);
+
+    EnterCriticalSection(&fontface->cs);
+    UNIX_CALL(get_glyph_bitmap, &params);
     LeaveCriticalSection(&fontface->cs);
 
-    return hr;
+    if (key.font)
+        glyph_cache_add_bitmap(&key, bitmap->buf, bitmap_size, *is_1bpp);
+
+    return S_OK;
 }
 
 static int fontface_cache_compare(const void *k, const struct wine_rb_entry *e)
@@ -880,6 +1086,7 @@ static ULONG WINAPI dwritefontface_Release(IDWriteFontFace5 *iface)
             IDWriteFontFileStream_Release(fontface->stream);
         }
         fontface_cache_clear(fontface);
+        glyph_cache_put_font(fontface->glyph_cache_font);
 
         dwrite_cmap_release(&fontface->cmap);
         IDWriteFactory7_Release(fontface->factory);
@@ -5491,6 +5698,7 @@ HRESULT create_fontface(const struct fontface_desc *desc, struct list *cached_li
     IDWriteFontFileStream_AddRef(fontface->stream);
     InitializeCriticalSection(&fontface->cs);
     fontface_cache_init(fontface);
+    fontface->glyph_cache_font = glyph_cache_get_font(desc->file, desc->index, desc->simulations);
 
     stream_desc.stream = fontface->stream;
     stream_desc.face_type = desc->face_type;
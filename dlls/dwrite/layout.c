@@ -209,6 +209,7 @@ enum layout_recompute_mask {
     RECOMPUTE_MINIMAL_WIDTH       = 1 << 1,
     RECOMPUTE_LINES               = 1 << 2,
     RECOMPUTE_OVERHANGS           = 1 << 3,
+    RECOMPUTE_RUNS                = 1 << 4, /* shaping results can't be reused */
     RECOMPUTE_LINES_AND_OVERHANGS = RECOMPUTE_LINES | RECOMPUTE_OVERHANGS,
     RECOMPUTE_EVERYTHING          = 0xffff
 };
@@ -247,6 +248,12 @@ struct dwrite_textlayout
     struct list underlines;
     struct list strikethrough;
     USHORT recompute;
+    /* text positions affected by range changes since runs were last computed */
+    struct
+    {
+        UINT32 start;
+        UINT32 end;
+    } dirty;
 
     DWRITE_LINE_BREAKPOINT *nominal_breakpoints;
     DWRITE_LINE_BREAKPOINT *actual_breakpoints;
@@ -330,25 +337,35 @@ static HRESULT alloc_layout_run(enum layout_run_kind kind, unsigned int start_po
     return S_OK;
 }
 
-static void free_layout_runs(struct dwrite_textlayout *layout)
+static void free_layout_run(struct layout_run *run)
+{
+    if (run->kind == LAYOUT_RUN_REGULAR)
+    {
+        if (run->u.regular.run.fontFace)
+            IDWriteFontFace_Release(run->u.regular.run.fontFace);
+        free(run->u.regular.glyphs);
+        free(run->u.regular.clustermap);
+        free(run->u.regular.advances);
+        free(run->u.regular.offsets);
+    }
+    free(run);
+}
+
+static void free_layout_runs_list(struct list *runs)
 {
     struct layout_run *cur, *cur2;
-    LIST_FOR_EACH_ENTRY_SAFE(cur, cur2, &layout->runs, struct layout_run, entry)
+    LIST_FOR_EACH_ENTRY_SAFE(cur, cur2, runs, struct layout_run, entry)
     {
         list_remove(&cur->entry);
-        if (cur->kind == LAYOUT_RUN_REGULAR)
-        {
-            if (cur->u.regular.run.fontFace)
-                IDWriteFontFace_Release(cur->u.regular.run.fontFace);
-            free(cur->u.regular.glyphs);
-            free(cur->u.regular.clustermap);
-            free(cur->u.regular.advances);
-            free(cur->u.regular.offsets);
-        }
-        free(cur);
+        free_layout_run(cur);
     }
 }
 
+static void free_layout_runs(struct dwrite_textlayout *layout)
+{
+    free_layout_runs_list(&layout->runs);
+}
+
 static void free_layout_eruns(struct dwrite_textlayout *layout)
 {
     struct layout_effective_inline *in, *in2;
@@ -1147,14 +1164,74 @@ static HRESULT layout_shape_run(struct dwrite_textlayout *layout, struct regular
     return hr;
 }
 
+/* Runs that don't overlap ranges changed since the last pass, and that were itemized
+   to the same text segment, font and analysis as before, keep their shaping results. */
+static BOOL layout_reuse_shaped_run(struct dwrite_textlayout *layout, struct list *old_runs,
+        struct regular_layout_run *run)
+{
+    UINT32 start = run->descr.textPosition, end = start + run->descr.stringLength;
+    struct layout_run *cur, *cur2;
+
+    if (start < layout->dirty.end && end > layout->dirty.start)
+        return FALSE;
+
+    /* Both lists are in logical order, so runs left behind won't match anything later. */
+    LIST_FOR_EACH_ENTRY_SAFE(cur, cur2, old_runs, struct layout_run, entry)
+    {
+        struct regular_layout_run *old = &cur->u.regular;
+
+        if (cur->start_position > start)
+            break;
+
+        list_remove(&cur->entry);
+
+        if (cur->kind == LAYOUT_RUN_REGULAR && cur->start_position == start
+                && old->descr.stringLength == run->descr.stringLength
+                && old->sa.script == run->sa.script && old->sa.shapes == run->sa.shapes
+                && old->run.bidiLevel == run->run.bidiLevel && old->run.isSideways == run->run.isSideways
+                && old->run.fontFace == run->run.fontFace && old->run.fontEmSize == run->run.fontEmSize
+                && old->glyphs && old->clustermap && old->advances && old->offsets)
+        {
+            run->descr.localeName = get_layout_range_by_pos(layout, start)->locale;
+            run->glyphs = old->glyphs;
+            run->clustermap = old->clustermap;
+            run->advances = old->advances;
+            run->offsets = old->offsets;
+            run->glyphcount = old->glyphcount;
+            run->run.glyphIndices = run->glyphs;
+            run->run.glyphAdvances = run->advances;
+            run->run.glyphOffsets = run->offsets;
+            run->run.glyphCount = old->run.glyphCount;
+            run->descr.clusterMap = run->clustermap;
+
+            old->glyphs = NULL;
+            old->clustermap = NULL;
+            old->advances = NULL;
+            old->offsets = NULL;
+            free_layout_run(cur);
+            return TRUE;
+        }
+
+        free_layout_run(cur);
+    }
+
+    return FALSE;
+}
+
 static HRESULT layout_compute_runs(struct dwrite_textlayout *layout)
 {
+    struct list old_runs;
     struct layout_run *r;
     UINT32 cluster = 0;
     HRESULT hr;
 
     free_layout_eruns(layout);
-    free_layout_runs(layout);
+
+    list_init(&old_runs);
+    if (layout->recompute & RECOMPUTE_RUNS)
+        free_layout_runs(layout);
+    else
+        list_move_tail(&old_runs, &layout->runs);
 
     /* Cluster data arrays are allocated once, assuming one text position per cluster. */
     if (!layout->clustermetrics && layout->len)
@@ -1165,6 +1242,7 @@ static HRESULT layout_compute_runs(struct dwrite_textlayout *layout)
         {
             free(layout->clustermetrics);
             free(layout->clusters);
+            free_layout_runs_list(&old_runs);
             return E_OUTOFMEMORY;
         }
     }
@@ -1172,11 +1250,13 @@ static HRESULT layout_compute_runs(struct dwrite_textlayout *layout)
 
     if (FAILED(hr = layout_itemize(layout))) {
         WARN("Itemization failed, hr %#lx.\n", hr);
+        free_layout_runs_list(&old_runs);
         return hr;
     }
 
     if (FAILED(hr = layout_resolve_fonts(layout))) {
         WARN("Failed to resolve layout fonts, hr %#lx.\n", hr);
+        free_layout_runs_list(&old_runs);
         return hr;
     }
 
@@ -1218,7 +1298,9 @@ static HRESULT layout_compute_runs(struct dwrite_textlayout *layout)
             continue;
         }
 
-        if (FAILED(hr = layout_shape_run(layout, run)))
+        if (layout_reuse_shaped_run(layout, &old_runs, run))
+            hr = S_OK;
+        else if (FAILED(hr = layout_shape_run(layout, run)))
             WARN("%s: shaping failed, hr %#lx.\n", debugstr_rundescr(&run->descr), hr);
 
         /* baseline derived from font metrics */
@@ -1228,6 +1310,8 @@ static HRESULT layout_compute_runs(struct dwrite_textlayout *layout)
         layout_set_cluster_metrics(layout, r, &cluster);
     }
 
+    free_layout_runs_list(&old_runs);
+
     if (hr == S_OK) {
         layout->cluster_count = cluster;
         if (cluster)
@@ -1278,7 +1362,8 @@ static HRESULT layout_compute(struct dwrite_textlayout *layout)
         }
     }
 
-    layout->recompute &= ~RECOMPUTE_CLUSTERS;
+    layout->recompute &= ~(RECOMPUTE_CLUSTERS | RECOMPUTE_RUNS);
+    layout->dirty.start = layout->dirty.end = 0;
     return hr;
 }
 
@@ -2665,6 +2750,25 @@ static inline HRESULT return_range(const struct layout_range_header *h, DWRITE_T
     return S_OK;
 }
 
+/* Range attribute changes only invalidate shaping results for the affected text. */
+static void layout_invalidate_range(struct dwrite_textlayout *layout, const DWRITE_TEXT_RANGE *range)
+{
+    UINT32 start = range->startPosition, end = start + min(range->length, ~0u - start);
+
+    if (layout->dirty.start == layout->dirty.end)
+    {
+        layout->dirty.start = start;
+        layout->dirty.end = end;
+    }
+    else
+    {
+        layout->dirty.start = min(layout->dirty.start, start);
+        layout->dirty.end = max(layout->dirty.end, end);
+    }
+
+    layout->recompute |= RECOMPUTE_EVERYTHING & ~RECOMPUTE_RUNS;
+}
+
 /* Sets attribute value for given range, does all needed splitting/merging of existing ranges. */
 static HRESULT set_layout_range_attr(struct dwrite_textlayout *layout, enum layout_range_attr_kind attr, struct layout_range_attr_value *value)
 {
@@ -2772,7 +2876,7 @@ static HRESULT set_layout_range_attr(struct dwrite_textlayout *layout, enum layo
         list_add_after(&outer->entry, &cur->entry);
         list_add_after(&cur->entry, &right->entry);
 
-        layout->recompute = RECOMPUTE_EVERYTHING;
+        layout_invalidate_range(layout, &value->range);
         return S_OK;
     }
 
@@ -2812,7 +2916,7 @@ done:
     if (changed) {
         struct list *next, *i;
 
-        layout->recompute = RECOMPUTE_EVERYTHING;
+        layout_invalidate_range(layout, &value->range);
         i = list_head(ranges);
         while ((next = list_next(ranges, i))) {
             struct layout_range_header *next_range = LIST_ENTRY(next, struct layout_range_header, entry);
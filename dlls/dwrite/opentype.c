@@ -3676,6 +3676,166 @@ static unsigned int opentype_layout_get_gsubgpos_subtable(const struct scriptsha
     return subtable_offset + GET_BE_DWORD(format1->extension_offset);
 }
 
+/* Lookup digests give a quick negative answer to "could this lookup apply to this glyph",
+   so that most glyph positions don't need a coverage table search for every lookup. A glyph
+   passes if its bits are set in both masks, masks are built from first glyph coverage of
+   every lookup subtable. */
+static void lookup_digest_add_range(struct ot_lookup_digest *digest, unsigned int first, unsigned int last)
+{
+    unsigned int g;
+
+    if (last - first >= 63)
+        digest->mask[0] = ~(UINT64)0;
+    else
+    {
+        for (g = first; g <= last; ++g)
+            digest->mask[0] |= (UINT64)1 << (g & 63);
+    }
+
+    if ((last >> 6) - (first >> 6) >= 63)
+        digest->mask[1] = ~(UINT64)0;
+    else
+    {
+        for (g = first >> 6; g <= last >> 6; ++g)
+            digest->mask[1] |= (UINT64)1 << (g & 63);
+    }
+}
+
+static void lookup_digest_add_coverage(struct ot_lookup_digest *digest, const struct dwrite_fonttable *table,
+        unsigned int coverage)
+{
+    WORD format = table_read_be_word(table, coverage), count;
+    unsigned int i;
+
+    count = table_read_be_word(table, coverage + 2);
+
+    if (format == 1)
+    {
+        const struct ot_coverage_format1 *format1 = table_read_ensure(table, coverage,
+                FIELD_OFFSET(struct ot_coverage_format1, glyphs[count]));
+
+        if (format1)
+        {
+            for (i = 0; i < count; ++i)
+                lookup_digest_add_range(digest, GET_BE_WORD(format1->glyphs[i]), GET_BE_WORD(format1->glyphs[i]));
+            return;
+        }
+    }
+    else if (format == 2)
+    {
+        const struct ot_coverage_format2 *format2 = table_read_ensure(table, coverage,
+                FIELD_OFFSET(struct ot_coverage_format2, ranges[count]));
+
+        if (format2)
+        {
+            for (i = 0; i < count; ++i)
+            {
+                UINT16 first = GET_BE_WORD(format2->ranges[i].start_glyph);
+                UINT16 last = GET_BE_WORD(format2->ranges[i].end_glyph);
+
+                if (first <= last)
+                    lookup_digest_add_range(digest, first, last);
+            }
+            return;
+        }
+    }
+
+    /* Unknown or broken coverage, don't filter anything. */
+    digest->mask[0] = digest->mask[1] = ~(UINT64)0;
+}
+
+static void lookup_digest_init(struct ot_lookup_digest *digest, const struct ot_gsubgpos_table *table,
+        BOOL is_gsub, unsigned int lookup_offset)
+{
+    unsigned int extension_type = is_gsub ? GSUB_LOOKUP_EXTENSION_SUBST : GPOS_LOOKUP_EXTENSION_POSITION;
+    unsigned int context_type = is_gsub ? GSUB_LOOKUP_CONTEXTUAL_SUBST : GPOS_LOOKUP_CONTEXTUAL_POSITION;
+    unsigned int chain_type = is_gsub ? GSUB_LOOKUP_CHAINING_CONTEXTUAL_SUBST : GPOS_LOOKUP_CONTEXTUAL_CHAINING_POSITION;
+    unsigned int max_type = is_gsub ? GSUB_LOOKUP_REVERSE_CHAINING_CONTEXTUAL_SUBST : GPOS_LOOKUP_CONTEXTUAL_CHAINING_POSITION;
+    const struct ot_gsubgpos_extension_format1 *extension;
+    unsigned int i, type, subtable_count, subtable_offset;
+
+    type = table_read_be_word(&table->table, lookup_offset + FIELD_OFFSET(struct ot_lookup_table, lookup_type));
+    subtable_count = table_read_be_word(&table->table, lookup_offset + FIELD_OFFSET(struct ot_lookup_table, subtable_count));
+
+    for (i = 0; i < subtable_count; ++i)
+    {
+        unsigned int subtable_type = type;
+
+        subtable_offset = lookup_offset + table_read_be_word(&table->table, lookup_offset +
+                FIELD_OFFSET(struct ot_lookup_table, subtable[i]));
+
+        if (type == extension_type)
+        {
+            if (!(extension = table_read_ensure(&table->table, subtable_offset, sizeof(*extension)))
+                    || GET_BE_WORD(extension->format) != 1)
+            {
+                continue;
+            }
+            subtable_type = GET_BE_WORD(extension->lookup_type);
+            subtable_offset += GET_BE_DWORD(extension->extension_offset);
+        }
+
+        /* Nested extensions are invalid and are never applied. */
+        if (subtable_type == extension_type)
+            continue;
+
+        /* Format 3 context subtables keep coverage elsewhere; every other subtable of known
+           type starts with a format field followed by a coverage offset. */
+        if (!subtable_type || subtable_type > max_type
+                || ((subtable_type == context_type || subtable_type == chain_type)
+                && table_read_be_word(&table->table, subtable_offset) == 3))
+        {
+            digest->mask[0] = digest->mask[1] = ~(UINT64)0;
+            return;
+        }
+
+        lookup_digest_add_coverage(digest, &table->table, subtable_offset +
+                table_read_be_word(&table->table, subtable_offset + 2));
+    }
+}
+
+static const struct ot_lookup_digest *opentype_layout_get_lookup_digests(struct ot_gsubgpos_table *table, BOOL is_gsub)
+{
+    struct ot_lookup_digest *digests;
+    unsigned int i, count;
+
+    if (table->lookup_digests || !table->lookup_list)
+        return table->lookup_digests;
+
+    count = table_read_be_word(&table->table, table->lookup_list);
+    if (!count || !(digests = calloc(count, sizeof(*digests))))
+        return NULL;
+
+    for (i = 0; i < count; ++i)
+    {
+        unsigned int offset = table_read_be_word(&table->table, table->lookup_list +
+                FIELD_OFFSET(struct ot_lookup_list, lookup[i]));
+
+        if (!offset)
+            continue;
+
+        lookup_digest_init(&digests[i], table, is_gsub, table->lookup_list + offset);
+    }
+
+    table->lookup_digest_count = count;
+    if (InterlockedCompareExchangePointer((void **)&table->lookup_digests, digests, NULL))
+        free(digests);
+
+    return table->lookup_digests;
+}
+
+static inline BOOL lookup_digest_may_apply(const struct ot_lookup_digest *digests, unsigned int count,
+        const struct lookup *lookup, UINT16 glyph)
+{
+    const struct ot_lookup_digest *digest;
+
+    if (!digests || lookup->index >= count)
+        return TRUE;
+
+    digest = &digests[lookup->index];
+    return (digest->mask[0] >> (glyph & 63)) & (digest->mask[1] >> ((glyph >> 6) & 63)) & 1;
+}
+
 struct ot_lookup
 {
     unsigned int offset;
@@ -4933,8 +5093,9 @@ static void opentype_propagate_attachment_offsets(struct scriptshaping_context *
 void opentype_layout_apply_gpos_features(struct scriptshaping_context *context, unsigned int script_index,
         unsigned int language_index, struct shaping_features *features)
 {
+    const struct ot_lookup_digest *digests;
     struct lookups lookups = { 0 };
-    unsigned int i;
+    unsigned int i, digest_count;
     BOOL ret;
 
     context->nesting_level_left = SHAPE_MAX_NESTING_LEVEL;
@@ -4945,6 +5106,9 @@ void opentype_layout_apply_gpos_features(struct scriptshaping_context *context,
         opentype_set_glyph_props(context, i);
     opentype_layout_set_glyph_masks(context, features);
 
+    digests = opentype_layout_get_lookup_digests(&context->cache->gpos, FALSE);
+    digest_count = context->cache->gpos.lookup_digest_count;
+
     for (i = 0; i < lookups.count; ++i)
     {
         const struct lookup *lookup = &lookups.lookups[i];
@@ -4959,6 +5123,7 @@ void opentype_layout_apply_gpos_features(struct scriptshaping_context *context,
             ret = FALSE;
 
             if ((context->glyph_infos[context->cur].mask & lookup->mask) &&
+                    lookup_digest_may_apply(digests, digest_count, lookup, context->u.pos.glyphs[context->cur]) &&
                     lookup_is_glyph_match(context, context->cur, lookup->flags))
             {
                 ret = opentype_layout_apply_gpos_lookup(context, lookup);
@@ -6117,8 +6282,9 @@ static void opentype_layout_apply_gsub_context_lookup(struct scriptshaping_conte
 void opentype_layout_apply_gsub_features(struct scriptshaping_context *context, unsigned int script_index,
         unsigned int language_index, struct shaping_features *features)
 {
+    const struct ot_lookup_digest *digests;
     struct lookups lookups = { 0 };
-    unsigned int i = 0, j, start_idx;
+    unsigned int i = 0, j, start_idx, digest_count;
     BOOL ret;
 
     context->nesting_level_left = SHAPE_MAX_NESTING_LEVEL;
@@ -6127,6 +6293,8 @@ void opentype_layout_apply_gsub_features(struct scriptshaping_context *context,
 
     opentype_get_nominal_glyphs(context, features);
     opentype_layout_set_glyph_masks(context, features);
+    digests = opentype_layout_get_lookup_digests(&context->cache->gsub, TRUE);
+    digest_count = context->cache->gsub.lookup_digest_count;
 
     for (j = 0; j <= features->stage; ++j)
     {
@@ -6146,6 +6314,7 @@ void opentype_layout_apply_gsub_features(struct scriptshaping_context *context,
                     ret = FALSE;
 
                     if ((context->glyph_infos[context->cur].mask & lookup->mask) &&
+                            lookup_digest_may_apply(digests, digest_count, lookup, context->u.subst.glyphs[context->cur]) &&
                             lookup_is_glyph_match(context, context->cur, lookup->flags))
                     {
                         ret = opentype_layout_apply_gsub_lookup(context, lookup);
@@ -6162,6 +6331,7 @@ void opentype_layout_apply_gsub_features(struct scriptshaping_context *context,
                 for (;;)
                 {
                     if ((context->glyph_infos[context->cur].mask & lookup->mask) &&
+                            lookup_digest_may_apply(digests, digest_count, lookup, context->u.subst.glyphs[context->cur]) &&
                             lookup_is_glyph_match(context, context->cur, lookup->flags))
                     {
                         opentype_layout_apply_gsub_lookup(context, lookup);
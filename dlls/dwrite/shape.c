@@ -40,6 +40,41 @@ WINE_DEFAULT_DEBUG_CHANNEL(dwrite);
 #define GET_BE_DWORD(x) RtlUlongByteSwap(x)
 #endif
 
+/* Glyph shaping results of short runs are cached per font, keyed by everything that
+   GetGlyphs() output depends on: text, script, direction, language, digit substitution
+   and user features. UI text tends to repeat the same short strings a lot. */
+#define SHAPING_RUN_CACHE_MAX_COUNT 256
+#define SHAPING_RUN_CACHE_MAX_LENGTH 64
+
+struct shaping_run_key
+{
+    const BYTE *data;
+    unsigned int size;
+};
+
+struct shaping_run_entry
+{
+    struct wine_rb_entry entry;
+    struct list mru;
+    struct shaping_run_key key;
+    unsigned int length;
+    unsigned int glyph_count;
+    UINT16 *clustermap;
+    DWRITE_SHAPING_TEXT_PROPERTIES *text_props;
+    UINT16 *glyphs;
+    DWRITE_SHAPING_GLYPH_PROPERTIES *glyph_props;
+};
+
+static int shaping_run_compare(const void *k, const struct wine_rb_entry *e)
+{
+    const struct shaping_run_entry *entry = WINE_RB_ENTRY_VALUE(e, const struct shaping_run_entry, entry);
+    const struct shaping_run_key *key = k;
+
+    if (key->size != entry->key.size)
+        return key->size < entry->key.size ? -1 : 1;
+    return memcmp(key->data, entry->key.data, key->size);
+}
+
 struct scriptshaping_cache *create_scriptshaping_cache(void *context, const struct shaping_font_ops *font_ops)
 {
     struct scriptshaping_cache *cache;
@@ -50,6 +85,11 @@ struct scriptshaping_cache *create_scriptshaping_cache(void *context, const stru
     cache->font = font_ops;
     cache->context = context;
 
+    InitializeCriticalSection(&cache->runs.cs);
+    cache->runs.cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": shaping_cache.runs.cs");
+    wine_rb_init(&cache->runs.tree, shaping_run_compare);
+    list_init(&cache->runs.mru);
+
     opentype_layout_scriptshaping_cache_init(cache);
     cache->upem = cache->font->get_font_upem(cache->context);
 
@@ -58,12 +98,20 @@ struct scriptshaping_cache *create_scriptshaping_cache(void *context, const stru
 
 void release_scriptshaping_cache(struct scriptshaping_cache *cache)
 {
+    struct shaping_run_entry *entry, *entry2;
+
     if (!cache)
         return;
 
     cache->font->release_font_table(cache->context, cache->gdef.table.context);
     cache->font->release_font_table(cache->context, cache->gsub.table.context);
     cache->font->release_font_table(cache->context, cache->gpos.table.context);
+    free(cache->gsub.lookup_digests);
+    free(cache->gpos.lookup_digests);
+    LIST_FOR_EACH_ENTRY_SAFE(entry, entry2, &cache->runs.mru, struct shaping_run_entry, mru)
+        free(entry);
+    cache->runs.cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection(&cache->runs.cs);
     free(cache);
 }
 
@@ -305,6 +353,144 @@ static unsigned int shape_get_script_lang_index(struct scriptshaping_context *co
     return 0;
 }
 
+static BOOL shape_append_run_key(BYTE *key, unsigned int max_size, unsigned int *size, const void *data,
+        unsigned int data_size)
+{
+    if (data_size > max_size - *size)
+        return FALSE;
+    memcpy(key + *size, data, data_size);
+    *size += data_size;
+    return TRUE;
+}
+
+static unsigned int shape_get_run_key(const struct scriptshaping_context *context, BYTE *key, unsigned int max_size)
+{
+    unsigned int header[6], i, size = 0;
+
+    if (context->length > SHAPING_RUN_CACHE_MAX_LENGTH)
+        return 0;
+
+    header[0] = context->script;
+    header[1] = context->language_tag;
+    header[2] = context->length;
+    header[3] = (context->is_rtl ? 1 : 0) | (context->is_sideways ? 2 : 0);
+    header[4] = context->u.subst.digits ? wcslen(context->u.subst.digits) : 0;
+    header[5] = context->user_features.range_count;
+
+    if (!shape_append_run_key(key, max_size, &size, header, sizeof(header))
+            || !shape_append_run_key(key, max_size, &size, context->text, context->length * sizeof(WCHAR))
+            || !shape_append_run_key(key, max_size, &size, context->u.subst.digits, header[4] * sizeof(WCHAR)))
+    {
+        return 0;
+    }
+
+    for (i = 0; context->user_features.features && i < context->user_features.range_count; ++i)
+    {
+        const DWRITE_TYPOGRAPHIC_FEATURES *features = context->user_features.features[i];
+        unsigned int range[2] = { context->user_features.range_lengths[i], features->featureCount };
+
+        if (!shape_append_run_key(key, max_size, &size, range, sizeof(range))
+                || !shape_append_run_key(key, max_size, &size, features->features,
+                features->featureCount * sizeof(*features->features)))
+        {
+            return 0;
+        }
+    }
+
+    return size;
+}
+
+static BOOL shape_get_cached_run(struct scriptshaping_context *context, const struct shaping_run_key *key, HRESULT *hr)
+{
+    struct scriptshaping_cache *cache = context->cache;
+    struct shaping_run_entry *entry;
+    struct wine_rb_entry *e;
+
+    EnterCriticalSection(&cache->runs.cs);
+
+    if (!(e = wine_rb_get(&cache->runs.tree, key)))
+    {
+        LeaveCriticalSection(&cache->runs.cs);
+        return FALSE;
+    }
+
+    entry = WINE_RB_ENTRY_VALUE(e, struct shaping_run_entry, entry);
+    list_remove(&entry->mru);
+    list_add_head(&cache->runs.mru, &entry->mru);
+
+    context->glyph_count = entry->glyph_count;
+    if (entry->glyph_count <= context->u.subst.max_glyph_count)
+    {
+        memcpy(context->u.subst.clustermap, entry->clustermap, entry->length * sizeof(*entry->clustermap));
+        memcpy(context->u.subst.text_props, entry->text_props, entry->length * sizeof(*entry->text_props));
+        memcpy(context->u.subst.glyphs, entry->glyphs, entry->glyph_count * sizeof(*entry->glyphs));
+        memcpy(context->u.subst.glyph_props, entry->glyph_props, entry->glyph_count * sizeof(*entry->glyph_props));
+        *hr = S_OK;
+    }
+    else
+        *hr = E_NOT_SUFFICIENT_BUFFER;
+
+    LeaveCriticalSection(&cache->runs.cs);
+
+    return TRUE;
+}
+
+static void shape_cache_run(struct scriptshaping_context *context, const struct shaping_run_key *key)
+{
+    struct scriptshaping_cache *cache = context->cache;
+    unsigned int length = context->length, count = context->glyph_count;
+    struct shaping_run_entry *entry;
+    BYTE *ptr;
+
+    if (!(entry = malloc(sizeof(*entry) + length * (sizeof(*entry->clustermap) + sizeof(*entry->text_props))
+            + count * (sizeof(*entry->glyphs) + sizeof(*entry->glyph_props)) + key->size)))
+    {
+        return;
+    }
+
+    ptr = (BYTE *)(entry + 1);
+    entry->clustermap = (UINT16 *)ptr;
+    ptr += length * sizeof(*entry->clustermap);
+    entry->text_props = (DWRITE_SHAPING_TEXT_PROPERTIES *)ptr;
+    ptr += length * sizeof(*entry->text_props);
+    entry->glyphs = (UINT16 *)ptr;
+    ptr += count * sizeof(*entry->glyphs);
+    entry->glyph_props = (DWRITE_SHAPING_GLYPH_PROPERTIES *)ptr;
+    ptr += count * sizeof(*entry->glyph_props);
+    memcpy(ptr, key->data, key->size);
+    entry->key.data = ptr;
+    entry->key.size = key->size;
+    entry->length = length;
+    entry->glyph_count = count;
+
+    memcpy(entry->clustermap, context->u.subst.clustermap, length * sizeof(*entry->clustermap));
+    memcpy(entry->text_props, context->u.subst.text_props, length * sizeof(*entry->text_props));
+    memcpy(entry->glyphs, context->u.subst.glyphs, count * sizeof(*entry->glyphs));
+    memcpy(entry->glyph_props, context->u.subst.glyph_props, count * sizeof(*entry->glyph_props));
+
+    EnterCriticalSection(&cache->runs.cs);
+
+    if (wine_rb_put(&cache->runs.tree, &entry->key, &entry->entry) == -1)
+    {
+        /* Already added by another thread. */
+        LeaveCriticalSection(&cache->runs.cs);
+        free(entry);
+        return;
+    }
+    list_add_head(&cache->runs.mru, &entry->mru);
+
+    if (++cache->runs.count > SHAPING_RUN_CACHE_MAX_COUNT)
+    {
+        entry = LIST_ENTRY(list_tail(&cache->runs.mru), struct shaping_run_entry, mru);
+        wine_rb_remove(&cache->runs.tree, &entry->entry);
+        list_remove(&entry->mru);
+        free(entry);
+        cache->runs.count--;
+    }
+
+    LeaveCriticalSection(&cache->runs.cs);
+}
+
 HRESULT shape_get_glyphs(struct scriptshaping_context *context, const unsigned int *scripts)
 {
     static const unsigned int common_features[] =
@@ -322,7 +508,16 @@ HRESULT shape_get_glyphs(struct scriptshaping_context *context, const unsigned i
     };
     unsigned int script_index, language_index;
     struct shaping_features features = { 0 };
+    BYTE key_data[512];
+    struct shaping_run_key key = { key_data };
     unsigned int i;
+    HRESULT hr;
+
+    if ((key.size = shape_get_run_key(context, key_data, sizeof(key_data)))
+            && shape_get_cached_run(context, &key, &hr))
+    {
+        return hr;
+    }
 
     shape_set_shaper(context);
 
@@ -363,7 +558,13 @@ HRESULT shape_get_glyphs(struct scriptshaping_context *context, const unsigned i
 
     free(features.features);
 
-    return (context->glyph_count <= context->u.subst.max_glyph_count) ? S_OK : E_NOT_SUFFICIENT_BUFFER;
+    if (context->glyph_count > context->u.subst.max_glyph_count)
+        return E_NOT_SUFFICIENT_BUFFER;
+
+    if (key.size)
+        shape_cache_run(context, &key);
+
+    return S_OK;
 }
 
 static int __cdecl tag_array_sorting_compare(const void *a, const void *b)
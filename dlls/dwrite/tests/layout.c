@@ -886,6 +886,10 @@ struct renderer_context {
     FLOAT originY;
     IDWriteTextFormat *format;
     const WCHAR *familyW;
+    UINT16 *glyphs; /* if set, glyph indices and advances are recorded by DrawGlyphRun() */
+    FLOAT *advances;
+    UINT32 glyph_count;
+    UINT32 max_glyphs;
 };
 
 static HRESULT WINAPI testrenderer_IsPixelSnappingDisabled(IDWriteTextRenderer *iface,
@@ -948,6 +952,16 @@ static HRESULT WINAPI testrenderer_DrawGlyphRun(IDWriteTextRenderer *iface,
         ctxt->originY = baselineOriginY;
     }
 
+    if (ctxt && ctxt->glyphs) {
+        UINT32 i;
+
+        ok(ctxt->glyph_count + run->glyphCount <= ctxt->max_glyphs, "too many glyphs\n");
+        for (i = 0; i < run->glyphCount && ctxt->glyph_count < ctxt->max_glyphs; i++, ctxt->glyph_count++) {
+            ctxt->glyphs[ctxt->glyph_count] = run->glyphIndices[i];
+            ctxt->advances[ctxt->glyph_count] = run->glyphAdvances[i];
+        }
+    }
+
     ok(descr->stringLength < ARRAY_SIZE(entry.string), "string is too long\n");
     if (descr->stringLength && descr->stringLength < ARRAY_SIZE(entry.string)) {
         memcpy(entry.string, descr->string, descr->stringLength*sizeof(WCHAR));
@@ -3292,6 +3306,146 @@ static void test_SetFontSize(void)
     IDWriteFactory_Release(factory);
 }
 
+static void draw_layout_glyphs(IDWriteTextLayout *layout, UINT16 *glyphs, FLOAT *advances, UINT32 max_glyphs,
+        UINT32 *count)
+{
+    struct renderer_context ctxt;
+    HRESULT hr;
+
+    memset(&ctxt, 0, sizeof(ctxt));
+    ctxt.snapping_disabled = TRUE;
+    ctxt.ppdip = 1.0f;
+    ctxt.glyphs = glyphs;
+    ctxt.advances = advances;
+    ctxt.max_glyphs = max_glyphs;
+    hr = IDWriteTextLayout_Draw(layout, &ctxt, &testrenderer, 0.0f, 0.0f);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    flush_sequence(sequences, RENDERER_ID);
+    *count = ctxt.glyph_count;
+}
+
+static void test_range_relayout(void)
+{
+    DWRITE_CLUSTER_METRICS metrics[7], metrics2[7], expected[7];
+    UINT16 glyphs[7], glyphs2[7];
+    FLOAT advances[7], advances2[7];
+    IDWriteTextLayout *layout, *layout2, *layout3;
+    UINT32 count, count2, i;
+    IDWriteTextFormat *format;
+    IDWriteFactory *factory;
+    DWRITE_TEXT_RANGE r;
+    HRESULT hr;
+
+    factory = create_factory();
+
+    hr = IDWriteFactory_CreateTextFormat(factory, L"Tahoma", NULL, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL,
+            DWRITE_FONT_STRETCH_NORMAL, 10.0f, L"en-us", &format);
+    ok(hr == S_OK, "Failed to create text format, hr %#lx.\n", hr);
+
+    hr = IDWriteFactory_CreateTextLayout(factory, L"abc def", 7, format, 1000.0f, 1000.0f, &layout);
+    ok(hr == S_OK, "Failed to create text layout, hr %#lx.\n", hr);
+
+    count = 0;
+    hr = IDWriteTextLayout_GetClusterMetrics(layout, expected, ARRAY_SIZE(expected), &count);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(count == 7, "Unexpected cluster count %u.\n", count);
+
+    /* Change the size of the second word, after the layout was computed once. */
+    r.startPosition = 4;
+    r.length = 3;
+    hr = IDWriteTextLayout_SetFontSize(layout, 20.0f, r);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+    count = 0;
+    hr = IDWriteTextLayout_GetClusterMetrics(layout, metrics, ARRAY_SIZE(metrics), &count);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(count == 7, "Unexpected cluster count %u.\n", count);
+
+    /* Same change on a fresh layout. */
+    hr = IDWriteFactory_CreateTextLayout(factory, L"abc def", 7, format, 1000.0f, 1000.0f, &layout2);
+    ok(hr == S_OK, "Failed to create text layout, hr %#lx.\n", hr);
+    hr = IDWriteTextLayout_SetFontSize(layout2, 20.0f, r);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+    count = 0;
+    hr = IDWriteTextLayout_GetClusterMetrics(layout2, metrics2, ARRAY_SIZE(metrics2), &count);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(count == 7, "Unexpected cluster count %u.\n", count);
+
+    for (i = 0; i < count; ++i)
+    {
+        winetest_push_context("cluster %u", i);
+        ok(metrics[i].width == metrics2[i].width, "Unexpected width %.8e, expected %.8e.\n",
+                metrics[i].width, metrics2[i].width);
+        ok(metrics[i].length == metrics2[i].length, "Unexpected length %u.\n", metrics[i].length);
+        if (i < 4)
+            ok(metrics[i].width == expected[i].width, "Unexpected width %.8e, expected %.8e.\n",
+                    metrics[i].width, expected[i].width);
+        else
+            ok(metrics[i].width > expected[i].width, "Unexpected width %.8e.\n", metrics[i].width);
+        winetest_pop_context();
+    }
+
+    /* Restoring the size restores the original metrics. */
+    hr = IDWriteTextLayout_SetFontSize(layout, 10.0f, r);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+    count = 0;
+    hr = IDWriteTextLayout_GetClusterMetrics(layout, metrics, ARRAY_SIZE(metrics), &count);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(count == 7, "Unexpected cluster count %u.\n", count);
+    ok(!memcmp(metrics, expected, sizeof(expected)), "Unexpected cluster metrics.\n");
+
+    /* Once the text is split in two runs, changing the second one keeps the first one as is. */
+    hr = IDWriteTextLayout_SetFontSize(layout, 20.0f, r);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+    count = 0;
+    hr = IDWriteTextLayout_GetClusterMetrics(layout, metrics, ARRAY_SIZE(metrics), &count);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(count == 7, "Unexpected cluster count %u.\n", count);
+
+    hr = IDWriteTextLayout_SetFontSize(layout, 30.0f, r);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+    count = 0;
+    hr = IDWriteTextLayout_GetClusterMetrics(layout, metrics, ARRAY_SIZE(metrics), &count);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(count == 7, "Unexpected cluster count %u.\n", count);
+
+    hr = IDWriteFactory_CreateTextLayout(factory, L"abc def", 7, format, 1000.0f, 1000.0f, &layout3);
+    ok(hr == S_OK, "Failed to create text layout, hr %#lx.\n", hr);
+    hr = IDWriteTextLayout_SetFontSize(layout3, 30.0f, r);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+    count = 0;
+    hr = IDWriteTextLayout_GetClusterMetrics(layout3, metrics2, ARRAY_SIZE(metrics2), &count);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(count == 7, "Unexpected cluster count %u.\n", count);
+    ok(!memcmp(metrics, metrics2, sizeof(metrics)), "Unexpected cluster metrics.\n");
+
+    draw_layout_glyphs(layout, glyphs, advances, ARRAY_SIZE(glyphs), &count);
+    draw_layout_glyphs(layout3, glyphs2, advances2, ARRAY_SIZE(glyphs2), &count2);
+    ok(count == 7, "Unexpected glyph count %u.\n", count);
+    ok(count == count2, "Unexpected glyph count %u, expected %u.\n", count, count2);
+    for (i = 0; i < count && i < count2; ++i)
+    {
+        winetest_push_context("glyph %u", i);
+        ok(glyphs[i] == glyphs2[i], "Unexpected glyph %u, expected %u.\n", glyphs[i], glyphs2[i]);
+        ok(advances[i] == advances2[i], "Unexpected advance %.8e, expected %.8e.\n", advances[i], advances2[i]);
+        if (i < 4)
+            ok(metrics[i].width == expected[i].width, "Unexpected width %.8e, expected %.8e.\n",
+                    metrics[i].width, expected[i].width);
+        winetest_pop_context();
+    }
+
+    IDWriteTextLayout_Release(layout3);
+    IDWriteTextLayout_Release(layout2);
+    IDWriteTextLayout_Release(layout);
+    IDWriteTextFormat_Release(format);
+    IDWriteFactory_Release(factory);
+}
+
 static void test_SetFontFamilyName(void)
 {
     IDWriteTextFormat *format;
@@ -4746,6 +4900,7 @@ static void test_pixelsnapping(void)
     ok(hr == S_OK, "Failed to create text layout, hr %#lx.\n", hr);
 
     /* disabled snapping */
+    memset(&ctxt, 0, sizeof(ctxt));
     ctxt.snapping_disabled = TRUE;
     ctxt.gdicompat = FALSE;
     ctxt.use_gdi_natural = FALSE;
@@ -7080,6 +7235,7 @@ START_TEST(layout)
     test_fallback();
     test_DetermineMinWidth();
     test_SetFontSize();
+    test_range_relayout();
     test_SetFontFamilyName();
     test_SetFontStyle();
     test_SetFontStretch();
@@ -598,12 +598,10 @@ static GpStatus alpha_blend_pixels(GpGraphics *graphics, INT dst_x, INT dst_y,
     return alpha_blend_pixels_hrgn(graphics, dst_x, dst_y, src, src_width, src_height, src_stride, NULL, fmt);
 }
 
-static ARGB blend_colors(ARGB start, ARGB end, REAL position)
+/* pos is the position scaled to 0-255 */
+static ARGB blend_colors_pos(ARGB start, ARGB end, INT pos)
 {
     INT start_a, end_a, final_a;
-    INT pos;
-
-    pos = gdip_round(position * 0xff);
 
     start_a = ((start >> 24) & 0xff) * (pos ^ 0xff);
     end_a = ((end >> 24) & 0xff) * pos;
@@ -618,6 +616,11 @@ static ARGB blend_colors(ARGB start, ARGB end, REAL position)
         (((start & 0xff) * start_a + ((end & 0xff) * end_a)) / final_a);
 }
 
+static ARGB blend_colors(ARGB start, ARGB end, REAL position)
+{
+    return blend_colors_pos(start, end, gdip_round(position * 0xff));
+}
+
 static ARGB blend_line_gradient(GpLineGradient* brush, REAL position)
 {
     REAL blendfac;
@@ -963,50 +966,64 @@ static void get_bitmap_sample_size(InterpolationMode interpolation, WrapMode wra
     rect->Height = bottom - top + 1;
 }
 
-static ARGB sample_bitmap_pixel(GDIPCONST GpRect *src_rect, LPBYTE bits, UINT width,
-    UINT height, INT x, INT y, GDIPCONST GpImageAttributes *attributes)
+#define SAMPLE_OUTSIDE      -1 /* outside of the image with WrapModeClamp */
+#define SAMPLE_OUT_OF_RANGE -2 /* outside of the sampled rectangle */
+
+/* Maps a pixel coordinate along one axis to an offset in the sampled rectangle,
+ * applying the wrap mode. */
+static INT get_sample_offset(INT x, UINT size, INT rect_start, INT rect_size,
+    WrapMode wrap, WrapMode flip)
 {
-    if (attributes->wrap == WrapModeClamp)
+    if (wrap == WrapModeClamp)
     {
-        if (x < 0 || y < 0 || x >= width || y >= height)
-            return attributes->outside_color;
+        if (x < 0 || x >= size)
+            return SAMPLE_OUTSIDE;
     }
     else
     {
         /* Tiling. Make sure co-ordinates are positive as it simplifies the math. */
         if (x < 0)
-            x = width*2 + x % (INT)(width * 2);
-        if (y < 0)
-            y = height*2 + y % (INT)(height * 2);
+            x = size*2 + x % (INT)(size * 2);
 
-        if (attributes->wrap & WrapModeTileFlipX)
+        if (wrap & flip)
         {
-            if ((x / width) % 2 == 0)
-                x = x % width;
+            if ((x / size) % 2 == 0)
+                x = x % size;
             else
-                x = width - 1 - x % width;
+                x = size - 1 - x % size;
         }
         else
-            x = x % width;
-
-        if (attributes->wrap & WrapModeTileFlipY)
-        {
-            if ((y / height) % 2 == 0)
-                y = y % height;
-            else
-                y = height - 1 - y % height;
-        }
-        else
-            y = y % height;
+            x = x % size;
     }
 
-    if (x < src_rect->X || y < src_rect->Y || x >= src_rect->X + src_rect->Width || y >= src_rect->Y + src_rect->Height)
+    if (x < rect_start || x >= rect_start + rect_size)
+        return SAMPLE_OUT_OF_RANGE;
+
+    return x - rect_start;
+}
+
+static ARGB get_sample(GDIPCONST GpRect *src_rect, LPBYTE bits, INT x, INT y,
+    GDIPCONST GpImageAttributes *attributes)
+{
+    if (x == SAMPLE_OUTSIDE || y == SAMPLE_OUTSIDE)
+        return attributes->outside_color;
+
+    if (x == SAMPLE_OUT_OF_RANGE || y == SAMPLE_OUT_OF_RANGE)
     {
         ERR("out of range pixel requested\n");
         return 0xffcd0084;
     }
 
-    return ((DWORD*)(bits))[(x - src_rect->X) + (y - src_rect->Y) * src_rect->Width];
+    return ((DWORD*)(bits))[x + y * src_rect->Width];
+}
+
+static ARGB sample_bitmap_pixel(GDIPCONST GpRect *src_rect, LPBYTE bits, UINT width,
+    UINT height, INT x, INT y, GDIPCONST GpImageAttributes *attributes)
+{
+    x = get_sample_offset(x, width, src_rect->X, src_rect->Width, attributes->wrap, WrapModeTileFlipX);
+    y = get_sample_offset(y, height, src_rect->Y, src_rect->Height, attributes->wrap, WrapModeTileFlipY);
+
+    return get_sample(src_rect, bits, x, y, attributes);
 }
 
 static ARGB resample_bitmap_pixel(GDIPCONST GpRect *src_rect, LPBYTE bits, UINT width,
@@ -1078,6 +1095,135 @@ static ARGB resample_bitmap_pixel(GDIPCONST GpRect *src_rect, LPBYTE bits, UINT
     }
 }
 
+/* Source sampling parameters for one destination row or column. */
+struct sample_tap
+{
+    BOOL inside;    /* within the source rectangle being drawn */
+    BOOL single;    /* sample position is on a pixel, no interpolation needed */
+    INT first, second;
+    INT pos;        /* blend position of the second sample, scaled to 0-255 */
+};
+
+static void init_sample_taps(struct sample_tap *taps, INT start, INT count, REAL origin, REAL step,
+    REAL src_start, REAL src_size, UINT size, INT rect_start, INT rect_size, WrapMode wrap,
+    WrapMode flip, InterpolationMode interpolation, PixelOffsetMode offset_mode)
+{
+    FLOAT pixel_offset;
+    INT i;
+
+    switch (offset_mode)
+    {
+    default:
+    case PixelOffsetModeNone:
+    case PixelOffsetModeHighSpeed:
+        pixel_offset = 0.5;
+        break;
+
+    case PixelOffsetModeHalf:
+    case PixelOffsetModeHighQuality:
+        pixel_offset = 0.0;
+        break;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        REAL point = origin + (start + i) * step, floorpoint;
+        INT left, right;
+
+        taps[i].inside = point >= src_start && point < src_start + src_size;
+
+        if (interpolation == InterpolationModeNearestNeighbor)
+        {
+            left = right = floorf(point + pixel_offset);
+            taps[i].pos = 0;
+        }
+        else
+        {
+            floorpoint = floorf(point);
+            left = (INT)floorpoint;
+            right = (INT)ceilf(point);
+            taps[i].pos = gdip_round((point - floorpoint) * 0xff);
+        }
+
+        taps[i].single = left == right;
+        taps[i].first = get_sample_offset(left, size, rect_start, rect_size, wrap, flip);
+        taps[i].second = taps[i].single ? taps[i].first :
+            get_sample_offset(right, size, rect_start, rect_size, wrap, flip);
+    }
+}
+
+/* Resamples a bitmap for a transform without rotation or shearing. Source
+ * coordinates then only depend on the destination column or row, so the
+ * sampling parameters are computed once per column and row instead of for
+ * every pixel, and whole rows are produced at a time. This gives the same
+ * results as calling resample_bitmap_pixel for each pixel. */
+static GpStatus resample_bitmap_axis_aligned(GDIPCONST GpRect *src_rect, LPBYTE src_data,
+    UINT width, UINT height, GDIPCONST GpPointF *origin, REAL x_dx, REAL y_dy,
+    REAL srcx, REAL srcy, REAL srcwidth, REAL srcheight, GDIPCONST RECT *dst_area,
+    LPBYTE dst_data, INT dst_stride, GDIPCONST GpImageAttributes *attributes,
+    InterpolationMode interpolation, PixelOffsetMode offset_mode)
+{
+    INT dst_width = dst_area->right - dst_area->left, dst_height = dst_area->bottom - dst_area->top;
+    struct sample_tap *columns, *rows;
+    static int fixme;
+    INT x, y;
+
+    if (interpolation != InterpolationModeNearestNeighbor && interpolation != InterpolationModeBilinear)
+    {
+        if (!fixme++)
+            FIXME("Unimplemented interpolation %i\n", interpolation);
+        interpolation = InterpolationModeBilinear;
+    }
+
+    columns = heap_alloc(sizeof(*columns) * (dst_width + dst_height));
+    if (!columns)
+        return OutOfMemory;
+    rows = columns + dst_width;
+
+    init_sample_taps(columns, dst_area->left, dst_width, origin->X, x_dx, srcx, srcwidth,
+        width, src_rect->X, src_rect->Width, attributes->wrap, WrapModeTileFlipX,
+        interpolation, offset_mode);
+    init_sample_taps(rows, dst_area->top, dst_height, origin->Y, y_dy, srcy, srcheight,
+        height, src_rect->Y, src_rect->Height, attributes->wrap, WrapModeTileFlipY,
+        interpolation, offset_mode);
+
+    for (y = 0; y < dst_height; y++)
+    {
+        const struct sample_tap *row = &rows[y];
+        ARGB *dst_color = (ARGB *)(dst_data + dst_stride * y);
+
+        if (!row->inside)
+        {
+            memset(dst_color, 0, sizeof(ARGB) * dst_width);
+            continue;
+        }
+
+        for (x = 0; x < dst_width; x++)
+        {
+            const struct sample_tap *column = &columns[x];
+            ARGB top, bottom;
+
+            if (!column->inside)
+                dst_color[x] = 0;
+            else if (column->single && row->single)
+                dst_color[x] = get_sample(src_rect, src_data, column->first, row->first, attributes);
+            else
+            {
+                top = blend_colors_pos(get_sample(src_rect, src_data, column->first, row->first, attributes),
+                                       get_sample(src_rect, src_data, column->second, row->first, attributes),
+                                       column->pos);
+                bottom = blend_colors_pos(get_sample(src_rect, src_data, column->first, row->second, attributes),
+                                          get_sample(src_rect, src_data, column->second, row->second, attributes),
+                                          column->pos);
+                dst_color[x] = blend_colors_pos(top, bottom, row->pos);
+            }
+        }
+    }
+
+    heap_free(columns);
+    return Ok;
+}
+
 static REAL intersect_line_scanline(const GpPointF *p1, const GpPointF *p2, REAL y)
 {
     return (p1->X - p2->X) * (p2->Y - y) / (p2->Y - p1->Y) + p2->X;
@@ -3265,23 +3411,38 @@ GpStatus WINGDIPAPI GdipDrawImagePointsRect(GpGraphics *graphics, GpImage *image
                 y_dx = dst_to_src_points[2].X - dst_to_src_points[0].X;
                 y_dy = dst_to_src_points[2].Y - dst_to_src_points[0].Y;
 
-                for (x=dst_area.left; x<dst_area.right; x++)
+                if (x_dy == 0.0 && y_dx == 0.0)
+                {
+                    stat = resample_bitmap_axis_aligned(&src_area, src_data, bitmap->width, bitmap->height,
+                        &dst_to_src_points[0], x_dx, y_dy, srcx, srcy, srcwidth, srcheight, &dst_area,
+                        dst_data, dst_stride, imageAttributes, interpolation, offset_mode);
+                    if (stat != Ok)
+                    {
+                        heap_free(src_data);
+                        heap_free(dst_dyn_data);
+                        return stat;
+                    }
+                }
+                else
                 {
                     for (y=dst_area.top; y<dst_area.bottom; y++)
                     {
-                        GpPointF src_pointf;
-                        ARGB *dst_color;
+                        for (x=dst_area.left; x<dst_area.right; x++)
+                        {
+                            GpPointF src_pointf;
+                            ARGB *dst_color;
 
-                        src_pointf.X = dst_to_src_points[0].X + x * x_dx + y * y_dx;
-                        src_pointf.Y = dst_to_src_points[0].Y + x * x_dy + y * y_dy;
+                            src_pointf.X = dst_to_src_points[0].X + x * x_dx + y * y_dx;
+                            src_pointf.Y = dst_to_src_points[0].Y + x * x_dy + y * y_dy;
 
-                        dst_color = (ARGB*)(dst_data + dst_stride * (y - dst_area.top) + sizeof(ARGB) * (x - dst_area.left));
+                            dst_color = (ARGB*)(dst_data + dst_stride * (y - dst_area.top) + sizeof(ARGB) * (x - dst_area.left));
 
-                        if (src_pointf.X >= srcx && src_pointf.X < srcx + srcwidth && src_pointf.Y >= srcy && src_pointf.Y < srcy+srcheight)
-                            *dst_color = resample_bitmap_pixel(&src_area, src_data, bitmap->width, bitmap->height, &src_pointf,
-                                                               imageAttributes, interpolation, offset_mode);
-                        else
-                            *dst_color = 0;
+                            if (src_pointf.X >= srcx && src_pointf.X < srcx + srcwidth && src_pointf.Y >= srcy && src_pointf.Y < srcy+srcheight)
+                                *dst_color = resample_bitmap_pixel(&src_area, src_data, bitmap->width, bitmap->height, &src_pointf,
+                                                                   imageAttributes, interpolation, offset_mode);
+                            else
+                                *dst_color = 0;
+                        }
                     }
                 }
             }
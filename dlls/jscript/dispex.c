@@ -1991,6 +1991,34 @@ HRESULT jsdisp_get_id(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *
     return DISP_E_UNKNOWNNAME;
 }
 
+/*
+ * Same as jsdisp_get_id(), but first tries the property slot remembered in *cache by
+ * a previous lookup. Property slots never move, and objects initialized the same way
+ * get the same layout, so lookups done by a single bytecode instruction usually hit
+ * without hashing the name.
+ */
+HRESULT jsdisp_get_id_cached(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, unsigned *cache, DISPID *id)
+{
+    dispex_prop_t *prop;
+    HRESULT hres;
+
+    if(!(flags & fdexNameCaseInsensitive) && *cache < jsdisp->prop_cnt) {
+        prop = &jsdisp->props[*cache];
+        if(prop->type != PROP_DELETED && !wcscmp(prop->name, name)) {
+            fix_protref_prop(jsdisp, prop);
+            if(prop->type != PROP_DELETED) {
+                *id = prop_to_id(jsdisp, prop);
+                return S_OK;
+            }
+        }
+    }
+
+    hres = jsdisp_get_id(jsdisp, name, flags, id);
+    if(SUCCEEDED(hres))
+        *cache = *id - 1;
+    return hres;
+}
+
 HRESULT jsdisp_call_value(jsdisp_t *jsfunc, IDispatch *jsthis, WORD flags, unsigned argc, jsval_t *argv, jsval_t *r)
 {
     HRESULT hres;
@@ -2532,6 +2532,37 @@ SimpleMatch(REGlobalData *gData, match_state_t *x, REOp op,
     return NULL;
 }
 
+/*
+ * If op is a case sensitive literal, find the next position at or after cp
+ * where it may match, or return NULL if there is none. Other ops may match
+ * anywhere, so cp is returned as is.
+ */
+static const WCHAR *
+FindLiteralStart(REGlobalData *gData, REOp op, jsbytecode *pc, const WCHAR *cp)
+{
+    size_t offset;
+    WCHAR matchCh;
+
+    switch (op) {
+      case REOP_FLAT:
+        ReadCompactIndex(pc, &offset);
+        matchCh = gData->regexp->source[offset];
+        break;
+      case REOP_FLAT1:
+        matchCh = *pc;
+        break;
+      case REOP_UCFLAT1:
+        matchCh = GET_ARG(pc);
+        break;
+      default:
+        return cp;
+    }
+
+    if (cp == gData->cpend)
+        return NULL;
+    return wmemchr(cp, matchCh, gData->cpend - cp);
+}
+
 static inline match_state_t *
 ExecuteREBytecode(REGlobalData *gData, match_state_t *x)
 {
@@ -2559,6 +2590,14 @@ ExecuteREBytecode(REGlobalData *gData, match_state_t *x)
     if (REOP_IS_SIMPLE(op) && !(gData->regexp->flags & REG_STICKY)) {
         anchor = FALSE;
         while (x->cp <= gData->cpend) {
+            if (!(startcp = FindLiteralStart(gData, op, pc, x->cp))) {
+                /* no match anywhere in the rest of the input, don't retry from the next char */
+                gData->skipped += gData->cpend - x->cp + 1;
+                x->cp = gData->cpend + 1;
+                break;
+            }
+            gData->skipped += startcp - x->cp;
+            x->cp = startcp;
             nextpc = pc;    /* reset back to start each time */
             result = SimpleMatch(gData, x, op, &nextpc, TRUE);
             if (result) {
@@ -3077,6 +3116,19 @@ static match_state_t *MatchRegExp(REGlobalData *gData, match_state_t *x)
     const WCHAR *cp2;
     UINT j;
 
+    /*
+     * A pattern starting with ^ can only match at the beginning of input,
+     * unless it is a multiline one.
+     */
+    if (gData->regexp->program[0] == REOP_BOL && !(gData->regexp->flags & REG_MULTILINE)) {
+        if (cp != gData->cpbegin)
+            return NULL;
+        gData->skipped = 0;
+        for (j = 0; j < gData->regexp->parenCount; j++)
+            x->parens[j].index = -1;
+        return ExecuteREBytecode(gData, x);
+    }
+
     /*
      * Have to include the position beyond the last character
      * in order to detect end-of-input/line condition.
@@ -2115,3 +2115,32 @@ function test_es5_keywords() {
     ok(tmp === true, "Expected exception for 'const c1 = 1;'");
 }
 test_es5_keywords();
+
+function test_member_cache() {
+    var objs = [{a: 1, b: 2}, {b: 3, a: 4}, {c: 5}, {a: 6}], r = [], i, o;
+
+    for(i = 0; i < objs.length; i++)
+        r.push(objs[i].a);
+    ok(r.join() === "1,4,,6", "r = " + r.join());
+
+    o = {x: 1};
+    r = [];
+    for(i = 0; i < 3; i++) {
+        if(i == 1) delete o.x;
+        if(i == 2) o.x = 3;
+        r.push(o.x);
+    }
+    ok(r.join() === "1,,3", "r = " + r.join());
+
+    function C() {}
+    C.prototype.f = function() { return 1; };
+    o = new C();
+    r = [];
+    for(i = 0; i < 3; i++) {
+        if(i == 1) C.prototype.f = function() { return 2; };
+        if(i == 2) delete C.prototype.f;
+        r.push(typeof(o.f) === "function" ? o.f() : "none");
+    }
+    ok(r.join() === "1,2,none", "r = " + r.join());
+}
+test_member_cache();
@@ -236,6 +236,29 @@ ok(m[0] === "abcabc", "m[0] is not \"abc\"");
 ok(m[1] === "a", "m[1] is not \"a\"");
 ok(re.lastIndex === 6, "re.lastIndex = " + re.lastIndex);
 
+re = /abc/g;
+m = re.exec("xxabxabcxabc");
+ok(m.index === 5, "m.index = " + m.index);
+m = re.exec("xxabxabcxabc");
+ok(m.index === 9, "m.index = " + m.index);
+m = re.exec("xxabxabcxabc");
+ok(m === null, "m = " + m);
+
+re = /^ab/g;
+m = re.exec("abab");
+ok(m.index === 0, "m.index = " + m.index);
+ok(re.lastIndex === 2, "re.lastIndex = " + re.lastIndex);
+m = re.exec("abab");
+ok(m === null, "m = " + m);
+m = /^ab/m.exec("x\nab");
+ok(m.index === 2, "m.index = " + m.index);
+
+tmp = new Array(100001).join("x");
+m = /ab/.exec(tmp);
+ok(m === null, "m = " + m);
+m = /ab/.exec(tmp + "ab");
+ok(m.index === 100000, "m.index = " + m.index);
+
 re = /(a)bcabc/;
 re.lastIndex = 2;
 m = "abcabcxxx".match(re);
@@ -103,6 +103,18 @@ static void copy_image_imc2(BYTE *dest, LONG dest_stride, const BYTE *src, LONG
     MFCopyImage(dest, dest_stride / 2, src, src_stride / 2, width / 2, lines);
 }
 
+/* Size of the memory written by copy_image() for a given destination pitch. */
+static DWORD get_image_extent(const struct buffer *buffer, DWORD pitch)
+{
+    if (buffer->_2d.copy_image == copy_image_nv12)
+        return pitch * buffer->_2d.height + pitch * (buffer->_2d.height / 2);
+    if (buffer->_2d.copy_image == copy_image_imc1)
+        return pitch * buffer->_2d.height * 2;
+    if (buffer->_2d.copy_image == copy_image_imc2)
+        return pitch * buffer->_2d.height + pitch / 2 * buffer->_2d.height;
+    return pitch * buffer->_2d.height;
+}
+
 static inline struct buffer *impl_from_IMFMediaBuffer(IMFMediaBuffer *iface)
 {
     return CONTAINING_RECORD(iface, struct buffer, IMFMediaBuffer_iface);
@@ -600,16 +612,54 @@ static HRESULT WINAPI memory_2d_buffer_GetContiguousLength(IMF2DBuffer2 *iface,
 
 static HRESULT WINAPI memory_2d_buffer_ContiguousCopyTo(IMF2DBuffer2 *iface, BYTE *dest_buffer, DWORD dest_length)
 {
-    FIXME("%p, %p, %lu.\n", iface, dest_buffer, dest_length);
+    struct buffer *buffer = impl_from_IMF2DBuffer2(iface);
+    BYTE *src_scanline0, *src_buffer_start;
+    DWORD src_length;
+    LONG src_pitch;
+    HRESULT hr;
 
-    return E_NOTIMPL;
+    TRACE("%p, %p, %lu.\n", iface, dest_buffer, dest_length);
+
+    if (dest_length < buffer->_2d.plane_size)
+        return E_INVALIDARG;
+
+    if (FAILED(hr = IMF2DBuffer2_Lock2DSize(iface, MF2DBuffer_LockFlags_Read, &src_scanline0, &src_pitch,
+            &src_buffer_start, &src_length)))
+    {
+        return hr;
+    }
+
+    copy_image(buffer, dest_buffer, buffer->_2d.width, src_scanline0, src_pitch, buffer->_2d.width, buffer->_2d.height);
+
+    IMF2DBuffer2_Unlock2D(iface);
+
+    return S_OK;
 }
 
 static HRESULT WINAPI memory_2d_buffer_ContiguousCopyFrom(IMF2DBuffer2 *iface, const BYTE *src_buffer, DWORD src_length)
 {
-    FIXME("%p, %p, %lu.\n", iface, src_buffer, src_length);
+    struct buffer *buffer = impl_from_IMF2DBuffer2(iface);
+    BYTE *dest_scanline0, *dest_buffer_start;
+    DWORD dest_length;
+    LONG dest_pitch;
+    HRESULT hr;
 
-    return E_NOTIMPL;
+    TRACE("%p, %p, %lu.\n", iface, src_buffer, src_length);
+
+    if (src_length < buffer->_2d.plane_size)
+        return E_INVALIDARG;
+
+    if (FAILED(hr = IMF2DBuffer2_Lock2DSize(iface, MF2DBuffer_LockFlags_Write, &dest_scanline0, &dest_pitch,
+            &dest_buffer_start, &dest_length)))
+    {
+        return hr;
+    }
+
+    copy_image(buffer, dest_scanline0, dest_pitch, src_buffer, buffer->_2d.width, buffer->_2d.width, buffer->_2d.height);
+
+    IMF2DBuffer2_Unlock2D(iface);
+
+    return S_OK;
 }
 
 static HRESULT WINAPI memory_2d_buffer_Lock2DSize(IMF2DBuffer2 *iface, MF2DBuffer_LockFlags flags, BYTE **scanline0,
@@ -634,9 +684,47 @@ static HRESULT WINAPI memory_2d_buffer_Lock2DSize(IMF2DBuffer2 *iface, MF2DBuffe
 
 static HRESULT WINAPI memory_2d_buffer_Copy2DTo(IMF2DBuffer2 *iface, IMF2DBuffer2 *dest_buffer)
 {
-    FIXME("%p, %p.\n", iface, dest_buffer);
+    struct buffer *buffer = impl_from_IMF2DBuffer2(iface);
+    BYTE *src_scanline0, *dest_scanline0, *src_buffer_start, *dest_buffer_start;
+    DWORD src_length, dest_length;
+    LONG src_pitch, dest_pitch;
+    HRESULT hr;
 
-    return E_NOTIMPL;
+    TRACE("%p, %p.\n", iface, dest_buffer);
+
+    if (FAILED(hr = IMF2DBuffer2_GetContiguousLength(dest_buffer, &dest_length)))
+        return hr;
+    if (dest_length < buffer->_2d.plane_size)
+        return E_INVALIDARG;
+
+    if (FAILED(hr = IMF2DBuffer2_Lock2DSize(iface, MF2DBuffer_LockFlags_Read, &src_scanline0, &src_pitch,
+            &src_buffer_start, &src_length)))
+    {
+        return hr;
+    }
+
+    if (SUCCEEDED(hr = IMF2DBuffer2_Lock2DSize(dest_buffer, MF2DBuffer_LockFlags_Write, &dest_scanline0, &dest_pitch,
+            &dest_buffer_start, &dest_length)))
+    {
+        /* The destination may have the same contiguous length but different dimensions. */
+        if (labs(dest_pitch) < buffer->_2d.width || get_image_extent(buffer, labs(dest_pitch)) > dest_length)
+        {
+            WARN("Destination buffer is too small, pitch %ld, length %lu.\n", dest_pitch, dest_length);
+            hr = E_INVALIDARG;
+        }
+        else
+        {
+            /* Planes are copied directly between locked surfaces, without an intermediate contiguous copy. */
+            copy_image(buffer, dest_scanline0, dest_pitch, src_scanline0, src_pitch, buffer->_2d.width,
+                    buffer->_2d.height);
+        }
+
+        IMF2DBuffer2_Unlock2D(dest_buffer);
+    }
+
+    IMF2DBuffer2_Unlock2D(iface);
+
+    return hr;
 }
 
 static const IMF2DBuffer2Vtbl memory_2d_buffer_vtbl =
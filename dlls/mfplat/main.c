@@ -1620,6 +1620,13 @@ HRESULT WINAPI MFCopyImage(BYTE *dest, LONG deststride, const BYTE *src, LONG sr
 {
     TRACE("%p, %ld, %p, %ld, %lu, %lu.\n", dest, deststride, src, srcstride, width, lines);
 
+    /* Rows are back to back on both sides, copy the whole plane at once. */
+    if (deststride == srcstride && deststride == width)
+    {
+        memcpy(dest, src, (SIZE_T)width * lines);
+        return S_OK;
+    }
+
     while (lines--)
     {
         memcpy(dest, src, width);
@@ -6088,6 +6088,79 @@ static void test_MFCreate2DMediaBuffer(void)
     }
 }
 
+static void test_2dbuffer_copy(void)
+{
+    IMFMediaBuffer *src_buffer, *dest_buffer;
+    IMF2DBuffer2 *src, *dest;
+    BYTE data[24], data2[24];
+    unsigned int i;
+    HRESULT hr;
+
+    if (!pMFCreate2DMediaBuffer)
+    {
+        win_skip("MFCreate2DMediaBuffer() is not available.\n");
+        return;
+    }
+
+    hr = pMFCreate2DMediaBuffer(4, 4, MAKEFOURCC('N','V','1','2'), FALSE, &src_buffer);
+    ok(hr == S_OK, "Failed to create a buffer, hr %#lx.\n", hr);
+    hr = pMFCreate2DMediaBuffer(4, 4, MAKEFOURCC('N','V','1','2'), FALSE, &dest_buffer);
+    ok(hr == S_OK, "Failed to create a buffer, hr %#lx.\n", hr);
+
+    hr = IMFMediaBuffer_QueryInterface(src_buffer, &IID_IMF2DBuffer2, (void **)&src);
+    if (FAILED(hr))
+    {
+        win_skip("IMF2DBuffer2 is not supported.\n");
+        IMFMediaBuffer_Release(src_buffer);
+        IMFMediaBuffer_Release(dest_buffer);
+        return;
+    }
+    hr = IMFMediaBuffer_QueryInterface(dest_buffer, &IID_IMF2DBuffer2, (void **)&dest);
+    ok(hr == S_OK, "Failed to get interface, hr %#lx.\n", hr);
+
+    for (i = 0; i < sizeof(data); ++i)
+        data[i] = i;
+
+    hr = IMF2DBuffer2_ContiguousCopyFrom(src, data, sizeof(data));
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+    memset(data2, 0xcc, sizeof(data2));
+    hr = IMF2DBuffer2_ContiguousCopyTo(src, data2, sizeof(data2));
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(!memcmp(data, data2, sizeof(data)), "Unexpected buffer contents.\n");
+
+    hr = IMF2DBuffer2_Copy2DTo(src, dest);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+    memset(data2, 0xcc, sizeof(data2));
+    hr = IMF2DBuffer2_ContiguousCopyTo(dest, data2, sizeof(data2));
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(!memcmp(data, data2, sizeof(data)), "Unexpected buffer contents.\n");
+
+    IMF2DBuffer2_Release(dest);
+    IMF2DBuffer2_Release(src);
+    IMFMediaBuffer_Release(dest_buffer);
+    IMFMediaBuffer_Release(src_buffer);
+
+    /* Same contiguous length, but the destination is not tall enough. */
+    hr = pMFCreate2DMediaBuffer(4, 16, D3DFMT_A8R8G8B8, FALSE, &src_buffer);
+    ok(hr == S_OK, "Failed to create a buffer, hr %#lx.\n", hr);
+    hr = pMFCreate2DMediaBuffer(16, 4, D3DFMT_A8R8G8B8, FALSE, &dest_buffer);
+    ok(hr == S_OK, "Failed to create a buffer, hr %#lx.\n", hr);
+    hr = IMFMediaBuffer_QueryInterface(src_buffer, &IID_IMF2DBuffer2, (void **)&src);
+    ok(hr == S_OK, "Failed to get interface, hr %#lx.\n", hr);
+    hr = IMFMediaBuffer_QueryInterface(dest_buffer, &IID_IMF2DBuffer2, (void **)&dest);
+    ok(hr == S_OK, "Failed to get interface, hr %#lx.\n", hr);
+
+    hr = IMF2DBuffer2_Copy2DTo(src, dest);
+    ok(FAILED(hr), "Unexpected hr %#lx.\n", hr);
+
+    IMF2DBuffer2_Release(dest);
+    IMF2DBuffer2_Release(src);
+    IMFMediaBuffer_Release(dest_buffer);
+    IMFMediaBuffer_Release(src_buffer);
+}
+
 static void test_MFCreateMediaBufferFromMediaType(void)
 {
     static struct audio_buffer_test
@@ -8544,6 +8617,7 @@ START_TEST(mfplat)
     test_queue_com();
     test_MFGetStrideForBitmapInfoHeader();
     test_MFCreate2DMediaBuffer();
+    test_2dbuffer_copy();
     test_MFCreateMediaBufferFromMediaType();
     test_MFInitMediaTypeFromWaveFormatEx();
     test_MFCreateMFVideoFormatFromMFMediaType();
@@ -21,6 +21,11 @@
 #include <stdarg.h>
 #include "windef.h"
 
+#if (defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__)
+#include <intrin.h>
+#define HAVE_SHA_NI
+#endif
+
 /* SHA1 algorithm
  *
  * Based on public domain SHA code by Steve Reid <steve@edmweb.com>
@@ -50,12 +55,83 @@ typedef struct {
 #define R3(v,w,x,y,z,i) z+=f3(w,x,y)+blk1(i)+0x8F1BBCDC+rol(v,5);w=rol(w,30);
 #define R4(v,w,x,y,z,i) z+=f4(w,x,y)+blk1(i)+0xCA62C1D6+rol(v,5);w=rol(w,30);
 
+#ifdef HAVE_SHA_NI
+static BOOL have_sha_ni(void)
+{
+   static int supported = -1;
+   int regs[4];
+
+   if (supported == -1)
+   {
+      __cpuid(regs, 0);
+      if (regs[0] < 7) supported = 0;
+      else
+      {
+         __cpuid(regs, 1);
+         /* SSSE3 and SSE4.1 */
+         supported = (regs[2] & (1 << 9)) && (regs[2] & (1 << 19));
+         __cpuidex(regs, 7, 0);
+         supported = supported && (regs[1] & (1 << 29));
+      }
+   }
+   return supported;
+}
+
+#define SHA_NI_ROUNDS(func) \
+   if (i < 4) \
+      w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(Buffer + 16 * i)), mask); \
+   else \
+      w[i & 3] = _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(w[i & 3], w[(i + 1) & 3]), \
+                                                  w[(i + 2) & 3]), w[(i + 3) & 3]); \
+   e = i ? _mm_sha1nexte_epu32(e, w[i & 3]) : _mm_add_epi32(e, w[0]); \
+   prev = abcd; \
+   abcd = _mm_sha1rnds4_epu32(abcd, e, func); \
+   e = prev;
+
+/* Hash consecutive 512-bit blocks using the SHA extensions. */
+__attribute__((target("sha,ssse3,sse4.1")))
+static void SHA1Transform_sha_ni(ULONG State[5], const UCHAR *Buffer, ULONG Count)
+{
+   const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+   __m128i abcd, e, save_abcd, save_e, prev, w[4];
+   int i;
+
+   abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)State), 0x1b);
+   e = _mm_set_epi32(State[4], 0, 0, 0);
+
+   for (; Count; Count--, Buffer += 64)
+   {
+      save_abcd = abcd;
+      save_e = e;
+
+      for (i = 0; i < 5; i++) { SHA_NI_ROUNDS(0) }
+      for (; i < 10; i++) { SHA_NI_ROUNDS(1) }
+      for (; i < 15; i++) { SHA_NI_ROUNDS(2) }
+      for (; i < 20; i++) { SHA_NI_ROUNDS(3) }
+
+      e = _mm_sha1nexte_epu32(e, save_e);
+      abcd = _mm_add_epi32(abcd, save_abcd);
+   }
+
+   _mm_storeu_si128((__m128i *)State, _mm_shuffle_epi32(abcd, 0x1b));
+   State[4] = _mm_extract_epi32(e, 3);
+}
+#endif
+
 /* Hash a single 512-bit block. This is the core of the algorithm. */
 static void SHA1Transform(ULONG State[5], UCHAR Buffer[64])
 {
    ULONG a, b, c, d, e;
    ULONG *Block;
 
+#ifdef HAVE_SHA_NI
+   if (have_sha_ni())
+   {
+      SHA1Transform_sha_ni(State, Buffer, 1);
+      return;
+   }
+#endif
+
    Block = (ULONG*)Buffer;
 
    /* Copy Context->State[] to working variables */
@@ -154,6 +230,16 @@ void WINAPI A_SHAUpdate(PSHA_CTX Context, const unsigned char *Buffer, UINT Buff
    {
       while (BufferContentSize + BufferSize >= 64)
       {
+#ifdef HAVE_SHA_NI
+         /* hash whole blocks straight from the caller's buffer */
+         if (!BufferContentSize && have_sha_ni())
+         {
+            SHA1Transform_sha_ni(Context->State, Buffer, BufferSize / 64);
+            Buffer += BufferSize & ~63;
+            BufferSize &= 63;
+            break;
+         }
+#endif
          RtlCopyMemory(Context->Buffer + BufferContentSize, Buffer,
                        64 - BufferContentSize);
          Buffer += 64 - BufferContentSize;
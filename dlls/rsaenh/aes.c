@@ -30,6 +30,11 @@
 
 #include "tomcrypt.h"
 
+#if (defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__)
+#include <intrin.h>
+#define HAVE_AESNI
+#endif
+
 static const ulong32 TE0[256] = {
     0xc66363a5UL, 0xf87c7c84UL, 0xee777799UL, 0xf67b7b8dUL,
     0xfff2f20dUL, 0xd66b6bbdUL, 0xde6f6fb1UL, 0x91c5c554UL,
@@ -934,6 +939,132 @@ static ulong32 setup_mix(ulong32 temp)
           (Te4_0[byte(temp, 3)]);
 }
 
+#ifdef HAVE_AESNI
+
+static int have_aesni(void)
+{
+    static int supported = -1;
+    int regs[4];
+
+    if (supported == -1) {
+        __cpuid(regs, 1);
+        supported = (regs[2] >> 25) & 1;
+    }
+    return supported;
+}
+
+#define AESNI_ROUNDS4(op, rk, Nr, b0, b1, b2, b3) \
+    do { \
+        __m128i k = _mm_loadu_si128(rk); \
+        int r; \
+        b0 = _mm_xor_si128(b0, k); b1 = _mm_xor_si128(b1, k); \
+        b2 = _mm_xor_si128(b2, k); b3 = _mm_xor_si128(b3, k); \
+        for (r = 1; r < Nr; r++) { \
+            k = _mm_loadu_si128(rk + r); \
+            b0 = _mm_##op##_si128(b0, k); b1 = _mm_##op##_si128(b1, k); \
+            b2 = _mm_##op##_si128(b2, k); b3 = _mm_##op##_si128(b3, k); \
+        } \
+        k = _mm_loadu_si128(rk + Nr); \
+        b0 = _mm_##op##last_si128(b0, k); b1 = _mm_##op##last_si128(b1, k); \
+        b2 = _mm_##op##last_si128(b2, k); b3 = _mm_##op##last_si128(b3, k); \
+    } while (0)
+
+#define AESNI_ROUNDS1(op, rk, Nr, b0) \
+    do { \
+        int r; \
+        b0 = _mm_xor_si128(b0, _mm_loadu_si128(rk)); \
+        for (r = 1; r < Nr; r++) \
+            b0 = _mm_##op##_si128(b0, _mm_loadu_si128(rk + r)); \
+        b0 = _mm_##op##last_si128(b0, _mm_loadu_si128(rk + Nr)); \
+    } while (0)
+
+#define LOADU(p)     _mm_loadu_si128((const __m128i *)(p))
+#define STOREU(p, x) _mm_storeu_si128((__m128i *)(p), (x))
+
+/* independent blocks are interleaved four at a time to hide the latency of the round instructions */
+__attribute__((target("aes,sse2")))
+static void aesni_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, const aes_key *skey)
+{
+    const __m128i *rk = (const __m128i *)skey->ni_eK;
+    __m128i b0, b1, b2, b3;
+
+    for (; blocks >= 4; blocks -= 4, pt += 64, ct += 64) {
+        b0 = LOADU(pt); b1 = LOADU(pt + 16); b2 = LOADU(pt + 32); b3 = LOADU(pt + 48);
+        AESNI_ROUNDS4(aesenc, rk, skey->Nr, b0, b1, b2, b3);
+        STOREU(ct, b0); STOREU(ct + 16, b1); STOREU(ct + 32, b2); STOREU(ct + 48, b3);
+    }
+    for (; blocks; blocks--, pt += 16, ct += 16) {
+        b0 = LOADU(pt);
+        AESNI_ROUNDS1(aesenc, rk, skey->Nr, b0);
+        STOREU(ct, b0);
+    }
+}
+
+__attribute__((target("aes,sse2")))
+static void aesni_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, const aes_key *skey)
+{
+    const __m128i *rk = (const __m128i *)skey->ni_dK;
+    __m128i b0, b1, b2, b3;
+
+    for (; blocks >= 4; blocks -= 4, ct += 64, pt += 64) {
+        b0 = LOADU(ct); b1 = LOADU(ct + 16); b2 = LOADU(ct + 32); b3 = LOADU(ct + 48);
+        AESNI_ROUNDS4(aesdec, rk, skey->Nr, b0, b1, b2, b3);
+        STOREU(pt, b0); STOREU(pt + 16, b1); STOREU(pt + 32, b2); STOREU(pt + 48, b3);
+    }
+    for (; blocks; blocks--, ct += 16, pt += 16) {
+        b0 = LOADU(ct);
+        AESNI_ROUNDS1(aesdec, rk, skey->Nr, b0);
+        STOREU(pt, b0);
+    }
+}
+
+__attribute__((target("aes,sse2")))
+static void aesni_cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks,
+                              unsigned char *iv, const aes_key *skey)
+{
+    const __m128i *rk = (const __m128i *)skey->ni_eK;
+    __m128i b = LOADU(iv);
+
+    for (; blocks; blocks--, pt += 16, ct += 16) {
+        b = _mm_xor_si128(b, LOADU(pt));
+        AESNI_ROUNDS1(aesenc, rk, skey->Nr, b);
+        STOREU(ct, b);
+    }
+    STOREU(iv, b);
+}
+
+/* all ciphertext is loaded before the plaintext is stored, so ct may equal pt */
+__attribute__((target("aes,sse2")))
+static void aesni_cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks,
+                              unsigned char *iv, const aes_key *skey)
+{
+    const __m128i *rk = (const __m128i *)skey->ni_dK;
+    __m128i prev = LOADU(iv), c0, c1, c2, c3, b0, b1, b2, b3;
+
+    for (; blocks >= 4; blocks -= 4, ct += 64, pt += 64) {
+        b0 = c0 = LOADU(ct); b1 = c1 = LOADU(ct + 16);
+        b2 = c2 = LOADU(ct + 32); b3 = c3 = LOADU(ct + 48);
+        AESNI_ROUNDS4(aesdec, rk, skey->Nr, b0, b1, b2, b3);
+        STOREU(pt, _mm_xor_si128(b0, prev));
+        STOREU(pt + 16, _mm_xor_si128(b1, c0));
+        STOREU(pt + 32, _mm_xor_si128(b2, c1));
+        STOREU(pt + 48, _mm_xor_si128(b3, c2));
+        prev = c3;
+    }
+    for (; blocks; blocks--, ct += 16, pt += 16) {
+        b0 = c0 = LOADU(ct);
+        AESNI_ROUNDS1(aesdec, rk, skey->Nr, b0);
+        STOREU(pt, _mm_xor_si128(b0, prev));
+        prev = c0;
+    }
+    STOREU(iv, prev);
+}
+
+#undef LOADU
+#undef STOREU
+
+#endif /* HAVE_AESNI */
+
 int aes_setup(const unsigned char *key, int keylen, int rounds, aes_key *skey)
 {
     int i, j;
@@ -1058,6 +1189,18 @@ int aes_setup(const unsigned char *key, int keylen, int rounds, aes_key *skey)
     *rk++ = *rrk++;
     *rk   = *rrk;
 
+    /* AES-NI uses the same schedule, but with the words in memory order */
+    skey->ni = 0;
+#ifdef HAVE_AESNI
+    if (have_aesni()) {
+        for (i = 0; i < 4 * (skey->Nr + 1); i++) {
+            STORE32H(skey->eK[i], skey->ni_eK + 4 * i);
+            STORE32H(skey->dK[i], skey->ni_dK + 4 * i);
+        }
+        skey->ni = 1;
+    }
+#endif
+
     return CRYPT_OK;
 }
 
@@ -1066,6 +1209,13 @@ void aes_ecb_encrypt(const unsigned char *pt, unsigned char *ct, aes_key *skey)
     ulong32 s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
+#ifdef HAVE_AESNI
+    if (skey->ni) {
+        aesni_ecb_encrypt(pt, ct, 1, skey);
+        return;
+    }
+#endif
+
     Nr = skey->Nr;
     rk = skey->eK;
 
@@ -1167,6 +1317,13 @@ void aes_ecb_decrypt(const unsigned char *ct, unsigned char *pt, aes_key *skey)
     ulong32 s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
+#ifdef HAVE_AESNI
+    if (skey->ni) {
+        aesni_ecb_decrypt(ct, pt, 1, skey);
+        return;
+    }
+#endif
+
     Nr = skey->Nr;
     rk = skey->dK;
 
@@ -1264,3 +1421,63 @@ void aes_ecb_decrypt(const unsigned char *ct, unsigned char *pt, aes_key *skey)
         rk[3];
     STORE32H(s3, pt+12);
 }
+
+void aes_ecb_encrypt_blocks(const unsigned char *pt, unsigned char *ct, unsigned long len, aes_key *skey)
+{
+#ifdef HAVE_AESNI
+    if (skey->ni) {
+        aesni_ecb_encrypt(pt, ct, len / 16, skey);
+        return;
+    }
+#endif
+    for (; len >= 16; len -= 16, pt += 16, ct += 16)
+        aes_ecb_encrypt(pt, ct, skey);
+}
+
+void aes_ecb_decrypt_blocks(const unsigned char *ct, unsigned char *pt, unsigned long len, aes_key *skey)
+{
+#ifdef HAVE_AESNI
+    if (skey->ni) {
+        aesni_ecb_decrypt(ct, pt, len / 16, skey);
+        return;
+    }
+#endif
+    for (; len >= 16; len -= 16, ct += 16, pt += 16)
+        aes_ecb_decrypt(ct, pt, skey);
+}
+
+void aes_cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, unsigned char *iv, aes_key *skey)
+{
+    int i;
+
+#ifdef HAVE_AESNI
+    if (skey->ni) {
+        aesni_cbc_encrypt(pt, ct, len / 16, iv, skey);
+        return;
+    }
+#endif
+    for (; len >= 16; len -= 16, pt += 16, ct += 16) {
+        for (i = 0; i < 16; i++) iv[i] ^= pt[i];
+        aes_ecb_encrypt(iv, ct, skey);
+        memcpy(iv, ct, 16);
+    }
+}
+
+void aes_cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long len, unsigned char *iv, aes_key *skey)
+{
+    unsigned char block[16];
+    int i;
+
+#ifdef HAVE_AESNI
+    if (skey->ni) {
+        aesni_cbc_decrypt(ct, pt, len / 16, iv, skey);
+        return;
+    }
+#endif
+    for (; len >= 16; len -= 16, ct += 16, pt += 16) {
+        memcpy(block, ct, 16);
+        aes_ecb_decrypt(block, pt, skey);
+        for (i = 0; i < 16; i++) pt[i] ^= iv[i];
+        memcpy(iv, block, 16);
+    }
+}
@@ -282,6 +282,31 @@ BOOL encrypt_block_impl(ALG_ID aiAlgid, DWORD dwKeySpec, KEY_CONTEXT *pKeyContex
     return TRUE;
 }
 
+BOOL encrypt_blocks_impl(ALG_ID aiAlgid, DWORD dwMode, KEY_CONTEXT *pKeyContext, const BYTE *in,
+                         BYTE *out, DWORD len, BYTE *chain_vector, DWORD enc)
+{
+    switch (aiAlgid) {
+        case CALG_AES:
+        case CALG_AES_128:
+        case CALG_AES_192:
+        case CALG_AES_256:
+            if (dwMode == CRYPT_MODE_ECB) {
+                if (enc) aes_ecb_encrypt_blocks(in, out, len, &pKeyContext->aes);
+                else aes_ecb_decrypt_blocks(in, out, len, &pKeyContext->aes);
+                return TRUE;
+            }
+            if (dwMode == CRYPT_MODE_CBC) {
+                if (enc) aes_cbc_encrypt(in, out, len, chain_vector, &pKeyContext->aes);
+                else aes_cbc_decrypt(in, out, len, chain_vector, &pKeyContext->aes);
+                return TRUE;
+            }
+            return FALSE;
+
+        default:
+            return FALSE;
+    }
+}
+
 BOOL encrypt_stream_impl(ALG_ID aiAlgid, KEY_CONTEXT *pKeyContext, BYTE *stream, DWORD dwLen)
 {
     switch (aiAlgid) {
@@ -552,6 +552,10 @@ BOOL block_encrypt(CRYPTKEY *key, BYTE *data, DWORD *data_len, DWORD buf_len,
     for (i = *data_len; i < encrypted_len; i++) data[i] = encrypted_len - *data_len;
     *data_len = encrypted_len;
 
+    if (encrypt_blocks_impl(key->aiAlgid, key->dwMode, context, data, data, *data_len,
+                            chain_vector, RSAENH_ENCRYPT))
+        return TRUE;
+
     for (i = 0, in = data; i < *data_len; i += key->dwBlockLen, in += key->dwBlockLen)
     {
         switch (key->dwMode) {
@@ -2766,7 +2770,12 @@ BOOL WINAPI RSAENH_CPDecrypt(HCRYPTPROV hProv, HCRYPTKEY hKey, HCRYPTHASH hHash,
     dwMax=*pdwDataLen;
 
     if (GET_ALG_TYPE(pCryptKey->aiAlgid) == ALG_TYPE_BLOCK) {
-        for (i=0, in=pbData; i<*pdwDataLen; i+=pCryptKey->dwBlockLen, in+=pCryptKey->dwBlockLen) {
+        i = 0;
+        if (!(*pdwDataLen % pCryptKey->dwBlockLen) &&
+            encrypt_blocks_impl(pCryptKey->aiAlgid, pCryptKey->dwMode, &pCryptKey->context, pbData, pbData,
+                                *pdwDataLen, pCryptKey->abChainVector, RSAENH_DECRYPT))
+            i = *pdwDataLen;
+        for (in=pbData+i; i<*pdwDataLen; i+=pCryptKey->dwBlockLen, in+=pCryptKey->dwBlockLen) {
             switch (pCryptKey->dwMode) {
                 case CRYPT_MODE_ECB:
                     encrypt_block_impl(pCryptKey->aiAlgid, 0, &pCryptKey->context, in, out, 
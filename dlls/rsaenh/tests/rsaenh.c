@@ -1122,7 +1122,7 @@ static void test_aes(int keylen)
     HCRYPTKEY hKey;
     BOOL result;
     DWORD dwLen, dwMode;
-    unsigned char pbData[48], enc_data[16], bad_data[16];
+    unsigned char pbData[48], enc_data[16], bad_data[16], chain_data[2][176];
     int i;
     static const BYTE aes_plain[32] = {
         "AES Test With 2 Blocks Of Data." };
@@ -1248,6 +1248,37 @@ static void test_aes(int keylen)
           printBytes("got",pbData,dwLen);
       }
     }
+
+    /* data split across several calls must be chained like a single call */
+    for (i=0; i<160; i++) chain_data[0][i] = chain_data[1][i] = (unsigned char)(i * 7);
+
+    dwLen = 160;
+    result = CryptEncrypt(hKey, 0, TRUE, 0, chain_data[0], &dwLen, sizeof(chain_data[0]));
+    ok(result, "%08lx\n", GetLastError());
+    ok(dwLen == 176, "got %ld\n", dwLen);
+
+    dwLen = 80;
+    result = CryptEncrypt(hKey, 0, FALSE, 0, chain_data[1], &dwLen, sizeof(chain_data[1]));
+    ok(result, "%08lx\n", GetLastError());
+    ok(dwLen == 80, "got %ld\n", dwLen);
+    dwLen = 80;
+    result = CryptEncrypt(hKey, 0, TRUE, 0, chain_data[1] + 80, &dwLen, sizeof(chain_data[1]) - 80);
+    ok(result, "%08lx\n", GetLastError());
+    ok(dwLen == 96, "got %ld\n", dwLen);
+    ok(!memcmp(chain_data[0], chain_data[1], 176), "Expected equal data sequences\n");
+
+    dwLen = 64;
+    result = CryptDecrypt(hKey, 0, FALSE, 0, chain_data[0], &dwLen);
+    ok(result, "%08lx\n", GetLastError());
+    ok(dwLen == 64, "got %ld\n", dwLen);
+    dwLen = 112;
+    result = CryptDecrypt(hKey, 0, TRUE, 0, chain_data[0] + 64, &dwLen);
+    ok(result, "%08lx\n", GetLastError());
+    ok(dwLen == 96, "got %ld\n", dwLen);
+    for (i=0; i<160; i++)
+        if (chain_data[0][i] != (unsigned char)(i * 7)) break;
+    ok(i == 160, "decryption incorrect at %d\n", i);
+
     result = CryptDestroyKey(hKey);
     ok(result, "%08lx\n", GetLastError());
 }
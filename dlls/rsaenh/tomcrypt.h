@@ -132,6 +132,8 @@ typedef struct tag_des3_key {
 typedef struct tag_aes_key {
    ulong32 eK[64], dK[64];
    int Nr;
+   int ni;  /* ni_eK and ni_dK hold the round keys for AES-NI */
+   unsigned char ni_eK[240], ni_dK[240];
 } aes_key;
 
 int rc2_setup(const unsigned char *key, int keylen, int bits, int num_rounds, rc2_key *skey);
@@ -149,6 +151,10 @@ void des3_ecb_decrypt(const unsigned char *ct, unsigned char *pt, const des3_key
 int aes_setup(const unsigned char *key, int keylen, int rounds, aes_key *skey);
 void aes_ecb_encrypt(const unsigned char *pt, unsigned char *ct, aes_key *skey);
 void aes_ecb_decrypt(const unsigned char *ct, unsigned char *pt, aes_key *skey);
+void aes_ecb_encrypt_blocks(const unsigned char *pt, unsigned char *ct, unsigned long len, aes_key *skey);
+void aes_ecb_decrypt_blocks(const unsigned char *ct, unsigned char *pt, unsigned long len, aes_key *skey);
+void aes_cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, unsigned char *iv, aes_key *skey);
+void aes_cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long len, unsigned char *iv, aes_key *skey);
 
 struct rc4_prng {
     int x, y;
@@ -25,6 +25,7 @@
 #include "rtworkq.h"
 #include "wine/debug.h"
 #include "wine/list.h"
+#include "wine/rbtree.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(mfplat);
 
@@ -129,6 +130,7 @@ struct work_item
     IRtwqAsyncResult *reply_result;
     struct queue *queue;
     RTWQWORKITEM_KEY key;
+    struct wine_rb_entry key_entry;
     LONG priority;
     DWORD flags;
     PTP_SIMPLE_CALLBACK finalization_callback;
@@ -176,6 +178,7 @@ struct queue
     TP_CALLBACK_ENVIRON_V3 envs[ARRAY_SIZE(priorities)];
     CRITICAL_SECTION cs;
     struct list pending_items;
+    struct wine_rb_tree pending_keys;
     DWORD id;
     /* Data used for serial queues only. */
     PTP_SIMPLE_CALLBACK finalization_callback;
@@ -184,6 +187,14 @@ struct queue
 
 static void shutdown_queue(struct queue *queue);
 
+static int pending_key_compare(const void *key, const struct wine_rb_entry *entry)
+{
+    const struct work_item *item = WINE_RB_ENTRY_VALUE(entry, const struct work_item, key_entry);
+    RTWQWORKITEM_KEY k = *(const RTWQWORKITEM_KEY *)key;
+
+    return k < item->key ? -1 : k > item->key;
+}
+
 static HRESULT lock_user_queue(DWORD queue)
 {
     HRESULT hr = RTWQ_E_INVALID_WORKQUEUE;
@@ -329,6 +340,7 @@ static HRESULT pool_queue_init(const struct queue_desc *desc, struct queue *queu
         queue->envs[i].CallbackPriority = priorities[i];
     }
     list_init(&queue->pending_items);
+    wine_rb_init(&queue->pending_keys, pending_key_compare);
     InitializeCriticalSection(&queue->cs);
 
     max_thread = (desc->queue_type == RTWQ_STANDARD_WORKQUEUE || desc->queue_type == RTWQ_WINDOW_WORKQUEUE) ? 1 : 4;
@@ -354,7 +366,7 @@ static BOOL pool_queue_shutdown(struct queue *queue)
     return TRUE;
 }
 
-static void CALLBACK standard_queue_worker(TP_CALLBACK_INSTANCE *instance, void *context, TP_WORK *work)
+static void CALLBACK standard_queue_worker(TP_CALLBACK_INSTANCE *instance, void *context)
 {
     struct work_item *item = context;
     RTWQASYNCRESULT *result = (RTWQASYNCRESULT *)item->result;
@@ -374,7 +386,6 @@ static void pool_queue_submit(struct queue *queue, struct work_item *item)
 {
     TP_CALLBACK_PRIORITY callback_priority;
     TP_CALLBACK_ENVIRON_V3 env;
-    TP_WORK *work_object;
 
     if (item->priority == 0)
         callback_priority = TP_CALLBACK_PRIORITY_NORMAL;
@@ -389,8 +400,16 @@ static void pool_queue_submit(struct queue *queue, struct work_item *item)
        we need finalization callback. */
     if (item->finalization_callback)
         IUnknown_AddRef(&item->IUnknown_iface);
-    work_object = CreateThreadpoolWork(standard_queue_worker, item, (TP_CALLBACK_ENVIRON *)&env);
-    SubmitThreadpoolWork(work_object);
+    /* Use one-shot callbacks, they are released once executed. Work objects would stay
+       in the cleanup group until the queue is shut down. */
+    if (!TrySubmitThreadpoolCallback(standard_queue_worker, item, (TP_CALLBACK_ENVIRON *)&env))
+    {
+        WARN("Failed to submit item %p, error %lu.\n", item, GetLastError());
+        if (item->finalization_callback)
+            IUnknown_Release(&item->IUnknown_iface);
+        IUnknown_Release(&item->IUnknown_iface);
+        return;
+    }
 
     TRACE("dispatched %p.\n", item->result);
 }
@@ -597,6 +616,7 @@ static void init_work_queue(const struct queue_desc *desc, struct queue *queue)
     if (SUCCEEDED(queue->ops->init(desc, queue)))
     {
         list_init(&queue->pending_items);
+        wine_rb_init(&queue->pending_keys, pending_key_compare);
         InitializeCriticalSection(&queue->cs);
     }
 }
@@ -717,6 +737,7 @@ static void queue_release_pending_item(struct work_item *item)
     if (item->key)
     {
         list_remove(&item->entry);
+        wine_rb_remove(&item->queue->pending_keys, &item->key_entry);
         item->key = 0;
         IUnknown_Release(&item->IUnknown_iface);
     }
@@ -791,6 +812,7 @@ static void queue_mark_item_pending(DWORD mask, struct work_item *item, RTWQWORK
 
     EnterCriticalSection(&item->queue->cs);
     list_add_tail(&item->queue->pending_items, &item->entry);
+    wine_rb_put(&item->queue->pending_keys, &item->key, &item->key_entry);
     IUnknown_AddRef(&item->IUnknown_iface);
     LeaveCriticalSection(&item->queue->cs);
 }
@@ -858,28 +880,26 @@ static HRESULT queue_submit_timer(struct queue *queue, IRtwqAsyncResult *result,
 static HRESULT queue_cancel_item(struct queue *queue, RTWQWORKITEM_KEY key)
 {
     HRESULT hr = RTWQ_E_NOT_FOUND;
+    struct wine_rb_entry *entry;
     struct work_item *item;
 
     EnterCriticalSection(&queue->cs);
-    LIST_FOR_EACH_ENTRY(item, &queue->pending_items, struct work_item, entry)
+    if ((entry = wine_rb_get(&queue->pending_keys, &key)))
     {
-        if (item->key == key)
+        item = WINE_RB_ENTRY_VALUE(entry, struct work_item, key_entry);
+        key >>= 32;
+        if ((key & WAIT_ITEM_KEY_MASK) == WAIT_ITEM_KEY_MASK)
         {
-            key >>= 32;
-            if ((key & WAIT_ITEM_KEY_MASK) == WAIT_ITEM_KEY_MASK)
-            {
-                IRtwqAsyncResult_SetStatus(item->result, RTWQ_E_OPERATION_CANCELLED);
-                invoke_async_callback(item->result);
-                CloseThreadpoolWait(item->u.wait_object);
-            }
-            else if ((key & SCHEDULED_ITEM_KEY_MASK) == SCHEDULED_ITEM_KEY_MASK)
-                CloseThreadpoolTimer(item->u.timer_object);
-            else
-                WARN("Unknown item key mask %#I64x.\n", key);
-            queue_release_pending_item(item);
-            hr = S_OK;
-            break;
+            IRtwqAsyncResult_SetStatus(item->result, RTWQ_E_OPERATION_CANCELLED);
+            invoke_async_callback(item->result);
+            CloseThreadpoolWait(item->u.wait_object);
         }
+        else if ((key & SCHEDULED_ITEM_KEY_MASK) == SCHEDULED_ITEM_KEY_MASK)
+            CloseThreadpoolTimer(item->u.timer_object);
+        else
+            WARN("Unknown item key mask %#I64x.\n", key);
+        queue_release_pending_item(item);
+        hr = S_OK;
     }
     LeaveCriticalSection(&queue->cs);
 
@@ -1832,19 +1832,13 @@ static BOOL lookup_script_identifier(compile_ctx_t *ctx, script_ctx_t *script, c
     class_desc_t *class;
     vbscode_t *code;
     unsigned c, i;
+    size_t idx;
 
     for(c = 0; c < ARRAY_SIZE(contexts); c++) {
         if(!contexts[c]) continue;
 
-        for(i = 0; i < contexts[c]->global_vars_cnt; i++) {
-            if(!wcsicmp(contexts[c]->global_vars[i]->name, identifier))
-                return TRUE;
-        }
-
-        for(i = 0; i < contexts[c]->global_funcs_cnt; i++) {
-            if(!wcsicmp(contexts[c]->global_funcs[i]->name, identifier))
-                return TRUE;
-        }
+        if(find_global_var(contexts[c], identifier, &idx) || find_global_func(contexts[c], identifier, &idx))
+            return TRUE;
 
         for(class = contexts[c]->classes; class; class = class->next) {
             if(!wcsicmp(class->name, identifier))
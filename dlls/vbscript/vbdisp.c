@@ -1252,6 +1252,106 @@ static ULONG WINAPI ScriptDisp_AddRef(IDispatchEx *iface)
     return ref;
 }
 
+static unsigned global_name_hash(const WCHAR *name)
+{
+    unsigned h = 0;
+
+    for(; *name; name++)
+        h = h * 31 + towlower(*name);
+    return h;
+}
+
+static const WCHAR *global_var_name(ScriptDisp *obj, size_t i)
+{
+    return obj->global_vars[i]->name;
+}
+
+static const WCHAR *global_func_name(ScriptDisp *obj, size_t i)
+{
+    return obj->global_funcs[i]->name;
+}
+
+/* Adds names appended to the array since the last call. Earlier entries win, like in a linear search. */
+static BOOL update_global_index(ScriptDisp *obj, global_index_t *index, size_t cnt,
+        const WCHAR *(*get_name)(ScriptDisp*,size_t))
+{
+    unsigned pos, mask;
+    size_t i;
+
+    if(index->cnt == cnt)
+        return TRUE;
+
+    if(cnt * 2 > index->size) {
+        unsigned size = index->size ? index->size : 32, *entries;
+
+        while(cnt * 2 > size)
+            size *= 2;
+        if(!(entries = heap_alloc_zero(size * sizeof(*entries))))
+            return FALSE;
+
+        heap_free(index->entries);
+        index->entries = entries;
+        index->size = size;
+        index->cnt = 0;
+    }
+
+    mask = index->size - 1;
+    for(i = index->cnt; i < cnt; i++) {
+        const WCHAR *name = get_name(obj, i);
+
+        for(pos = global_name_hash(name) & mask; index->entries[pos]; pos = (pos + 1) & mask) {
+            if(!wcsicmp(get_name(obj, index->entries[pos] - 1), name))
+                break;
+        }
+        if(!index->entries[pos])
+            index->entries[pos] = i + 1;
+    }
+
+    index->cnt = cnt;
+    return TRUE;
+}
+
+static BOOL find_global_name(ScriptDisp *obj, global_index_t *index, size_t cnt,
+        const WCHAR *(*get_name)(ScriptDisp*,size_t), const WCHAR *name, size_t *ret)
+{
+    unsigned pos, mask;
+    size_t i;
+
+    if(!update_global_index(obj, index, cnt, get_name)) {
+        for(i = 0; i < cnt; i++) {
+            if(!wcsicmp(get_name(obj, i), name)) {
+                *ret = i;
+                return TRUE;
+            }
+        }
+        return FALSE;
+    }
+
+    if(!index->size)
+        return FALSE;
+
+    mask = index->size - 1;
+    for(pos = global_name_hash(name) & mask; index->entries[pos]; pos = (pos + 1) & mask) {
+        i = index->entries[pos] - 1;
+        if(!wcsicmp(get_name(obj, i), name)) {
+            *ret = i;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+BOOL find_global_var(ScriptDisp *obj, const WCHAR *name, size_t *ret)
+{
+    return find_global_name(obj, &obj->global_vars_index, obj->global_vars_cnt, global_var_name, name, ret);
+}
+
+BOOL find_global_func(ScriptDisp *obj, const WCHAR *name, size_t *ret)
+{
+    return find_global_name(obj, &obj->global_funcs_index, obj->global_funcs_cnt, global_func_name, name, ret);
+}
+
 static ULONG WINAPI ScriptDisp_Release(IDispatchEx *iface)
 {
     ScriptDisp *This = ScriptDisp_from_IDispatchEx(iface);
@@ -1269,6 +1369,8 @@ static ULONG WINAPI ScriptDisp_Release(IDispatchEx *iface)
         heap_pool_free(&This->heap);
         heap_free(This->global_vars);
         heap_free(This->global_funcs);
+        heap_free(This->global_vars_index.entries);
+        heap_free(This->global_funcs_index.entries);
         heap_free(This);
     }
 
@@ -1376,25 +1478,21 @@ static HRESULT WINAPI ScriptDisp_Invoke(IDispatchEx *iface, DISPID dispIdMember,
 static HRESULT WINAPI ScriptDisp_GetDispID(IDispatchEx *iface, BSTR bstrName, DWORD grfdex, DISPID *pid)
 {
     ScriptDisp *This = ScriptDisp_from_IDispatchEx(iface);
-    unsigned i;
+    size_t i;
 
     TRACE("(%p)->(%s %lx %p)\n", This, debugstr_w(bstrName), grfdex, pid);
 
     if(!This->ctx)
         return E_UNEXPECTED;
 
-    for(i = 0; i < This->global_vars_cnt; i++) {
-        if(!wcsicmp(This->global_vars[i]->name, bstrName)) {
-            *pid = i + 1;
-            return S_OK;
-        }
+    if(find_global_var(This, bstrName, &i)) {
+        *pid = i + 1;
+        return S_OK;
     }
 
-    for(i = 0; i < This->global_funcs_cnt; i++) {
-        if(!wcsicmp(This->global_funcs[i]->name, bstrName)) {
-            *pid = i + 1 + DISPID_FUNCTION_MASK;
-            return S_OK;
-        }
+    if(find_global_func(This, bstrName, &i)) {
+        *pid = i + 1 + DISPID_FUNCTION_MASK;
+        return S_OK;
     }
 
     *pid = -1;
@@ -154,16 +154,12 @@ static HRESULT exec_global_code(script_ctx_t *ctx, vbscode_t *code, VARIANT *res
 
     for (func_iter = code->funcs; func_iter; func_iter = func_iter->next)
     {
-        for (i = 0; i < obj->global_funcs_cnt; i++)
+        if (find_global_func(obj, func_iter->name, &i))
         {
-            if (!wcsicmp(obj->global_funcs[i]->name, func_iter->name))
-            {
-                /* global function already exists, replace it */
-                obj->global_funcs[i] = func_iter;
-                break;
-            }
+            /* global function already exists, replace it */
+            obj->global_funcs[i] = func_iter;
         }
-        if (i == obj->global_funcs_cnt)
+        else
             obj->global_funcs[obj->global_funcs_cnt++] = func_iter;
     }
 
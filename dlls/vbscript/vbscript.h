@@ -120,6 +120,13 @@ typedef struct _dynamic_var_t {
     SAFEARRAY *array;
 } dynamic_var_t;
 
+/* Case insensitive open addressing index of global names, entries are array indexes + 1. */
+typedef struct {
+    unsigned *entries;
+    unsigned size;
+    size_t cnt;
+} global_index_t;
+
 typedef struct {
     IDispatchEx IDispatchEx_iface;
     LONG ref;
@@ -127,10 +134,12 @@ typedef struct {
     dynamic_var_t **global_vars;
     size_t global_vars_cnt;
     size_t global_vars_size;
+    global_index_t global_vars_index;
 
     function_t **global_funcs;
     size_t global_funcs_cnt;
     size_t global_funcs_size;
+    global_index_t global_funcs_index;
 
     class_desc_t *classes;
 
@@ -166,6 +175,8 @@ HRESULT disp_propput(script_ctx_t*,IDispatch*,DISPID,WORD,DISPPARAMS*) DECLSPEC_
 HRESULT get_disp_value(script_ctx_t*,IDispatch*,VARIANT*) DECLSPEC_HIDDEN;
 void collect_objects(script_ctx_t*) DECLSPEC_HIDDEN;
 HRESULT create_script_disp(script_ctx_t*,ScriptDisp**) DECLSPEC_HIDDEN;
+BOOL find_global_var(ScriptDisp*,const WCHAR*,size_t*) DECLSPEC_HIDDEN;
+BOOL find_global_func(ScriptDisp*,const WCHAR*,size_t*) DECLSPEC_HIDDEN;
 
 HRESULT to_int(VARIANT*,int*) DECLSPEC_HIDDEN;
 
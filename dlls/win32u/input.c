@@ -216,22 +216,38 @@ BOOL WINAPI NtUserSetCursorPos( INT x, INT y )
  */
 BOOL get_cursor_pos( POINT *pt )
 {
+    const desktop_shm_t *shm;
     BOOL ret;
     DWORD last_change;
+    LONG seq;
     UINT dpi;
 
     if (!pt) return FALSE;
 
-    SERVER_START_REQ( set_cursor )
+    if ((shm = get_desktop_shared_memory()))
     {
-        if ((ret = !wine_server_call( req )))
+        do
+        {
+            seq = shared_read_begin( &shm->seq );
+            pt->x = shm->cursor_x;
+            pt->y = shm->cursor_y;
+            last_change = shm->cursor_last_change;
+        } while (shared_read_retry( &shm->seq, seq ));
+        ret = TRUE;
+    }
+    else
+    {
+        SERVER_START_REQ( set_cursor )
         {
-            pt->x = reply->new_x;
-            pt->y = reply->new_y;
-            last_change = reply->last_change;
+            if ((ret = !wine_server_call( req )))
+            {
+                pt->x = reply->new_x;
+                pt->y = reply->new_y;
+                last_change = reply->last_change;
+            }
         }
+        SERVER_END_REQ;
     }
-    SERVER_END_REQ;
 
     /* query new position from graphics driver if we haven't updated recently */
     if (ret && NtGetTickCount() - last_change > 100) ret = user_driver->pGetCursorPos( pt );
@@ -280,13 +296,18 @@ SHORT WINAPI NtUserGetAsyncKeyState( INT key )
 {
     struct user_key_state_info *key_state_info = get_user_thread_info()->key_state;
     INT counter = global_key_state_counter;
-    BYTE prev_key_state;
+    const desktop_shm_t *shm;
+    BYTE prev_key_state, state;
     SHORT ret;
 
     if (key < 0 || key >= 256) return 0;
 
     check_for_events( QS_INPUT );
 
+    /* the server has to clear the "pressed since last call" bit, otherwise a single byte read is enough */
+    if ((shm = get_desktop_shared_memory()) && !((state = shm->keystate[key]) & 0x40))
+        return (state & 0x80) ? 0x8000 : 0;
+
     if (key_state_info && !(key_state_info->state[key] & 0xc0) &&
         key_state_info->counter == counter && NtGetTickCount() - key_state_info->time < 50)
     {
@@ -336,7 +357,10 @@ SHORT WINAPI NtUserGetAsyncKeyState( INT key )
  */
 DWORD WINAPI NtUserGetQueueStatus( UINT flags )
 {
+    const queue_shm_t *shm = get_user_thread_info()->queue_shm;
+    UINT wake_bits, changed_bits;
     DWORD ret;
+    LONG seq;
 
     if (flags & ~(QS_ALLINPUT | QS_ALLPOSTMESSAGE | QS_SMRESULT))
     {
@@ -346,6 +370,19 @@ DWORD WINAPI NtUserGetQueueStatus( UINT flags )
 
     check_for_events( flags );
 
+    if (shm)
+    {
+        do
+        {
+            seq = shared_read_begin( &shm->seq );
+            wake_bits = shm->wake_bits;
+            changed_bits = shm->changed_bits;
+        } while (shared_read_retry( &shm->seq, seq ));
+
+        /* nothing to clear, no need to ask the server */
+        if (!(changed_bits & flags)) return MAKELONG( 0, wake_bits & flags );
+    }
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = flags;
@@ -361,10 +398,13 @@ DWORD WINAPI NtUserGetQueueStatus( UINT flags )
  */
 DWORD get_input_state(void)
 {
+    const queue_shm_t *shm = get_user_thread_info()->queue_shm;
     DWORD ret;
 
     check_for_events( QS_INPUT );
 
+    if (shm) return shm->wake_bits & (QS_KEY | QS_MOUSEBUTTON);
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = 0;
@@ -2062,7 +2062,7 @@ static void process_sent_messages(void)
 static HANDLE get_server_queue_handle(void)
 {
     struct user_thread_info *thread_info = get_user_thread_info();
-    HANDLE ret;
+    HANDLE ret, shm = 0;
 
     if (!(ret = thread_info->server_queue))
     {
@@ -2070,10 +2070,12 @@ static HANDLE get_server_queue_handle(void)
         {
             wine_server_call( req );
             ret = wine_server_ptr_handle( reply->handle );
+            shm = wine_server_ptr_handle( reply->shm_handle );
         }
         SERVER_END_REQ;
         thread_info->server_queue = ret;
         if (!ret) ERR( "Cannot get server thread queue\n" );
+        if (shm) thread_info->queue_shm = map_shared_memory( shm, sizeof(queue_shm_t) );
     }
     return ret;
 }
@@ -120,6 +120,8 @@ struct user_thread_info
 {
     struct ntuser_thread_info     client_info;            /* Data shared with client */
     HANDLE                        server_queue;           /* Handle to server-side queue */
+    const queue_shm_t            *queue_shm;              /* Shared memory of the server-side queue */
+    const desktop_shm_t          *desktop_shm;            /* Shared memory of the thread desktop */
     DWORD                         wake_mask;              /* Current queue wake mask */
     DWORD                         changed_mask;           /* Current queue changed mask */
     WORD                          message_count;          /* Get/PeekMessage loop counter */
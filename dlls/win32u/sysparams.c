@@ -5369,6 +5369,8 @@ static void thread_detach(void)
     destroy_thread_windows();
     cleanup_imm_thread();
     NtClose( thread_info->server_queue );
+    unmap_shared_memory( thread_info->queue_shm );
+    unmap_shared_memory( thread_info->desktop_shm );
 
     exiting_thread_id = 0;
 }
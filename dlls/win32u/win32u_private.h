@@ -358,6 +358,11 @@ extern void user_lock(void) DECLSPEC_HIDDEN;
 extern void user_unlock(void) DECLSPEC_HIDDEN;
 extern void user_check_not_lock(void) DECLSPEC_HIDDEN;
 
+/* winstation.c */
+extern const void *map_shared_memory( HANDLE handle, SIZE_T size ) DECLSPEC_HIDDEN;
+extern void unmap_shared_memory( const volatile void *ptr ) DECLSPEC_HIDDEN;
+extern const desktop_shm_t *get_desktop_shared_memory(void) DECLSPEC_HIDDEN;
+
 /* window.c */
 struct tagWND;
 extern HDWP begin_defer_window_pos( INT count ) DECLSPEC_HIDDEN;
@@ -442,6 +447,21 @@ static inline BOOL set_ntstatus( NTSTATUS status )
     return !status;
 }
 
+/* start reading server shared memory, returns the sequence number to check afterwards */
+static inline LONG shared_read_begin( const volatile int *seq )
+{
+    LONG ret;
+    while ((ret = ReadAcquire( (const volatile LONG *)seq )) & 1) YieldProcessor();
+    return ret;
+}
+
+/* check whether the server updated the shared memory while we were reading it */
+static inline BOOL shared_read_retry( const volatile int *seq, LONG start )
+{
+    MemoryBarrier();
+    return ReadNoFence( (const volatile LONG *)seq ) != start;
+}
+
 static inline WCHAR win32u_towupper( WCHAR ch )
 {
     return RtlUpcaseUnicodeChar( ch );
@@ -1531,6 +1531,89 @@ static void mirror_rect( const RECT *window_rect, RECT *rect )
     rect->right = width - tmp;
 }
 
+#define WINDOW_SHM_ENTRIES ((LAST_USER_HANDLE - FIRST_USER_HANDLE + 1) >> 1)
+
+/* get the shared memory entry of a window, mapping the shared memory on first use */
+static const window_shm_t *get_window_shm_entry( HWND hwnd )
+{
+    static const window_shm_t *window_shm;
+    static BOOL failed;
+    UINT index = (LOWORD(hwnd) - FIRST_USER_HANDLE) >> 1;
+    const window_shm_t *ptr;
+    HANDLE handle = 0;
+
+    if (index >= WINDOW_SHM_ENTRIES) return NULL;
+    if (!window_shm && !failed)
+    {
+        SERVER_START_REQ( get_window_shm )
+        {
+            if (!wine_server_call( req )) handle = wine_server_ptr_handle( reply->handle );
+        }
+        SERVER_END_REQ;
+
+        if (!handle || !(ptr = map_shared_memory( handle, WINDOW_SHM_ENTRIES * sizeof(*ptr) )))
+        {
+            failed = TRUE;
+            return NULL;
+        }
+        if (InterlockedCompareExchangePointer( (void **)&window_shm, (void *)ptr, NULL ))
+            unmap_shared_memory( ptr );
+    }
+    return window_shm ? &window_shm[index] : NULL;
+}
+
+/* get the window and client rectangles of another process window from the server shared memory */
+static BOOL get_shared_window_rects( HWND hwnd, enum coords_relative relative, RECT *window_rect,
+                                     RECT *client_rect, UINT dpi )
+{
+    const window_shm_t *shm;
+    RECT window, client, orig;
+    UINT handle, flags, window_dpi;
+    LONG seq;
+
+    if (!(shm = get_window_shm_entry( hwnd ))) return FALSE;
+    do
+    {
+        seq = shared_read_begin( &shm->seq );
+        handle     = shm->handle;
+        window_dpi = shm->dpi;
+        flags      = shm->flags;
+        SetRect( &window, shm->window.left, shm->window.top, shm->window.right, shm->window.bottom );
+        SetRect( &client, shm->client.left, shm->client.top, shm->client.right, shm->client.bottom );
+    } while (shared_read_retry( &shm->seq, seq ));
+
+    if (!handle || LOWORD(handle) != LOWORD(hwnd)) return FALSE;
+    if (HIWORD(hwnd) && HIWORD(hwnd) != 0xffff && HIWORD(hwnd) != HIWORD(handle)) return FALSE;
+    /* let the server map between DPI values */
+    if (window_dpi != dpi) return FALSE;
+
+    switch (relative)
+    {
+    case COORDS_CLIENT:
+        orig = client;
+        OffsetRect( &window, -orig.left, -orig.top );
+        OffsetRect( &client, -orig.left, -orig.top );
+        if (flags & WINDOW_SHM_LAYOUTRTL) mirror_rect( &orig, &window );
+        break;
+    case COORDS_WINDOW:
+        orig = window;
+        OffsetRect( &window, -orig.left, -orig.top );
+        OffsetRect( &client, -orig.left, -orig.top );
+        if (flags & WINDOW_SHM_LAYOUTRTL) mirror_rect( &orig, &client );
+        break;
+    case COORDS_PARENT:
+    case COORDS_SCREEN:
+        /* child windows need the parent chain, ask the server */
+        if (!(flags & WINDOW_SHM_TOPLEVEL)) return FALSE;
+        break;
+    default:
+        return FALSE;
+    }
+    if (window_rect) *window_rect = window;
+    if (client_rect) *client_rect = client;
+    return TRUE;
+}
+
 /***********************************************************************
  *           get_window_rects
  *
@@ -1641,6 +1724,8 @@ BOOL get_window_rects( HWND hwnd, enum coords_relative relative, RECT *window_re
     }
 
 other_process:
+    if (get_shared_window_rects( hwnd, relative, window_rect, client_rect, dpi )) return TRUE;
+
     SERVER_START_REQ( get_window_rectangles )
     {
         req->handle = wine_server_user_handle( hwnd );
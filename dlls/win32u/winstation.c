@@ -221,6 +221,46 @@ HDESK WINAPI NtUserGetThreadDesktop( DWORD thread )
     return ret;
 }
 
+/* map a read-only view of a server shared memory section, the handle is closed */
+const void *map_shared_memory( HANDLE handle, SIZE_T size )
+{
+    void *ptr = NULL;
+    NTSTATUS status;
+
+    status = NtMapViewOfSection( handle, GetCurrentProcess(), &ptr, 0, 0, NULL, &size,
+                                 ViewShare, 0, PAGE_READONLY );
+    NtClose( handle );
+    if (status)
+    {
+        WARN( "failed to map shared memory %#x\n", status );
+        return NULL;
+    }
+    return ptr;
+}
+
+void unmap_shared_memory( const volatile void *ptr )
+{
+    if (ptr) NtUnmapViewOfSection( GetCurrentProcess(), (void *)ptr );
+}
+
+/* get the shared memory of the thread desktop, mapping it on first use */
+const desktop_shm_t *get_desktop_shared_memory(void)
+{
+    struct user_thread_info *thread_info = get_user_thread_info();
+    HANDLE handle = 0;
+
+    if (thread_info->desktop_shm) return thread_info->desktop_shm;
+
+    SERVER_START_REQ( get_desktop_shm )
+    {
+        if (!wine_server_call( req )) handle = wine_server_ptr_handle( reply->handle );
+    }
+    SERVER_END_REQ;
+
+    if (handle) thread_info->desktop_shm = map_shared_memory( handle, sizeof(desktop_shm_t) );
+    return thread_info->desktop_shm;
+}
+
 /***********************************************************************
  *           NtUserSetThreadDesktop   (win32u.@)
  */
@@ -242,6 +282,8 @@ BOOL WINAPI NtUserSetThreadDesktop( HDESK handle )
         thread_info->client_info.top_window = 0;
         thread_info->client_info.msg_window = 0;
         if (key_state_info) key_state_info->time = 0;
+        unmap_shared_memory( thread_info->desktop_shm );
+        thread_info->desktop_shm = NULL;
     }
     return ret;
 }
@@ -80,6 +80,7 @@ typedef struct FormatConverter {
     WICBitmapDitherType dither;
     double alpha_threshold;
     IWICPalette *palette;
+    const struct row_converter *row_converter;
     CRITICAL_SECTION lock; /* must be held when initialized */
 } FormatConverter;
 
@@ -132,6 +133,357 @@ static void to_sRGB(BYTE *bgr)
 }
 #endif
 
+static INIT_ONCE conversion_tables_once = INIT_ONCE_STATIC_INIT;
+
+/* Smallest linear value converted to each sRGB byte value, so the conversion
+ * is a binary search instead of a powf call per pixel. */
+static float sRGB_thresholds[256];
+
+/* 255 / alpha in 16.16 fixed point, rounded up so that the quotient is exact
+ * for all 8-bit inputs. */
+static DWORD unpremultiply_factor[256];
+
+static inline BYTE float_to_sRGB_byte_slow(float f)
+{
+    return (BYTE)floorf(to_sRGB_component(f) * 255.0f + 0.51f);
+}
+
+static BOOL WINAPI init_conversion_tables(INIT_ONCE *once, void *param, void **context)
+{
+    UINT i;
+
+    sRGB_thresholds[0] = 0.0f;
+    for (i = 1; i < 256; i++)
+    {
+        /* non-negative floats compare like their bit patterns */
+        DWORD low = 0, high = 0x3f800000; /* 1.0f */
+
+        while (low < high)
+        {
+            DWORD mid = low + (high - low) / 2;
+            float f = *(float *)&mid;
+
+            if (float_to_sRGB_byte_slow(f) >= i) high = mid;
+            else low = mid + 1;
+        }
+        sRGB_thresholds[i] = *(float *)&low;
+    }
+
+    unpremultiply_factor[0] = 1 << 16;
+    for (i = 1; i < 256; i++)
+        unpremultiply_factor[i] = ((255 << 16) + i - 1) / i;
+
+    return TRUE;
+}
+
+static void init_conversion_tables_once(void)
+{
+    InitOnceExecuteOnce(&conversion_tables_once, init_conversion_tables, NULL, NULL);
+}
+
+static inline BYTE float_to_sRGB_byte(float f)
+{
+    UINT i = 0, step;
+
+    for (step = 128; step; step >>= 1)
+        if (f >= sRGB_thresholds[i + step]) i += step;
+
+    return i;
+}
+
+/* (x + 127) / 255 without a division, exact for x < 65535 */
+static inline BYTE div255(UINT x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+/* Row conversion kernels. They convert a single row of pixels and are
+ * written as simple loops without per-pixel branches or calls, so the compiler
+ * can vectorize them. Kernels between formats of the same size may be used in
+ * place. */
+typedef void (*row_convert_func)(const BYTE *src, BYTE *dst, UINT width);
+
+static void convert_row_8bppGray_to_32bppBGRA(const BYTE *src, BYTE *dst, UINT width)
+{
+    DWORD *dstpixel = (DWORD *)dst;
+    UINT x;
+
+    for (x = 0; x < width; x++)
+        dstpixel[x] = 0xff000000 | src[x] * 0x010101;
+}
+
+static void convert_row_16bppBGR555_to_32bppBGRA(const BYTE *src, BYTE *dst, UINT width)
+{
+    const WORD *srcpixel = (const WORD *)src;
+    DWORD *dstpixel = (DWORD *)dst;
+    UINT x;
+
+    for (x = 0; x < width; x++)
+    {
+        DWORD srcval = srcpixel[x];
+        dstpixel[x] = 0xff000000 | /* constant 255 alpha */
+                      ((srcval << 9) & 0xf80000) | /* r */
+                      ((srcval << 4) & 0x070000) | /* r - 3 bits */
+                      ((srcval << 6) & 0x00f800) | /* g */
+                      ((srcval << 1) & 0x000700) | /* g - 3 bits */
+                      ((srcval << 3) & 0x0000f8) | /* b */
+                      ((srcval >> 2) & 0x000007);  /* b - 3 bits */
+    }
+}
+
+static void convert_row_16bppBGR565_to_32bppBGRA(const BYTE *src, BYTE *dst, UINT width)
+{
+    const WORD *srcpixel = (const WORD *)src;
+    DWORD *dstpixel = (DWORD *)dst;
+    UINT x;
+
+    for (x = 0; x < width; x++)
+    {
+        DWORD srcval = srcpixel[x];
+        dstpixel[x] = 0xff000000 | /* constant 255 alpha */
+                      ((srcval << 8) & 0xf80000) | /* r */
+                      ((srcval << 3) & 0x070000) | /* r - 3 bits */
+                      ((srcval << 5) & 0x00fc00) | /* g */
+                      ((srcval >> 1) & 0x000300) | /* g - 2 bits */
+                      ((srcval << 3) & 0x0000f8) | /* b */
+                      ((srcval >> 2) & 0x000007);  /* b - 3 bits */
+    }
+}
+
+static void convert_row_16bppBGRA5551_to_32bppBGRA(const BYTE *src, BYTE *dst, UINT width)
+{
+    const WORD *srcpixel = (const WORD *)src;
+    DWORD *dstpixel = (DWORD *)dst;
+    UINT x;
+
+    for (x = 0; x < width; x++)
+    {
+        DWORD srcval = srcpixel[x];
+        dstpixel[x] = (srcval >> 15) * 0xff000000 | /* alpha */
+                      ((srcval << 9) & 0xf80000) | /* r */
+                      ((srcval << 4) & 0x070000) | /* r - 3 bits */
+                      ((srcval << 6) & 0x00f800) | /* g */
+                      ((srcval << 1) & 0x000700) | /* g - 3 bits */
+                      ((srcval << 3) & 0x0000f8) | /* b */
+                      ((srcval >> 2) & 0x000007);  /* b - 3 bits */
+    }
+}
+
+static void convert_row_24bppBGR_to_32bppBGRA(const BYTE *src, BYTE *dst, UINT width)
+{
+    DWORD *dstpixel = (DWORD *)dst;
+    UINT x;
+
+    for (x = 0; x < width; x++, src += 3)
+        dstpixel[x] = 0xff000000 | src[2] << 16 | src[1] << 8 | src[0];
+}
+
+static void convert_row_24bppBGR_to_32bppRGBA(const BYTE *src, BYTE *dst, UINT width)
+{
+    DWORD *dstpixel = (DWORD *)dst;
+    UINT x;
+
+    for (x = 0; x < width; x++, src += 3)
+        dstpixel[x] = 0xff000000 | src[0] << 16 | src[1] << 8 | src[2];
+}
+
+static void convert_row_32bppBGRA_to_24bppBGR(const BYTE *src, BYTE *dst, UINT width)
+{
+    UINT x;
+
+    for (x = 0; x < width; x++, src += 4, dst += 3)
+    {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+    }
+}
+
+static void convert_row_32bppBGRA_to_24bppRGB(const BYTE *src, BYTE *dst, UINT width)
+{
+    UINT x;
+
+    for (x = 0; x < width; x++, src += 4, dst += 3)
+    {
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = src[0];
+    }
+}
+
+static void convert_row_swap_24bpp(const BYTE *src, BYTE *dst, UINT width)
+{
+    UINT x;
+
+    for (x = 0; x < width; x++, src += 3, dst += 3)
+    {
+        BYTE b = src[0], g = src[1], r = src[2];
+        dst[0] = r;
+        dst[1] = g;
+        dst[2] = b;
+    }
+}
+
+static void convert_row_swap_32bpp(const BYTE *src, BYTE *dst, UINT width)
+{
+    const DWORD *srcpixel = (const DWORD *)src;
+    DWORD *dstpixel = (DWORD *)dst;
+    UINT x;
+
+    for (x = 0; x < width; x++)
+    {
+        DWORD srcval = srcpixel[x];
+        dstpixel[x] = (srcval & 0xff00ff00) | (srcval << 16 & 0xff0000) | (srcval >> 16 & 0xff);
+    }
+}
+
+static void convert_row_set_alpha(const BYTE *src, BYTE *dst, UINT width)
+{
+    const DWORD *srcpixel = (const DWORD *)src;
+    DWORD *dstpixel = (DWORD *)dst;
+    UINT x;
+
+    for (x = 0; x < width; x++)
+        dstpixel[x] = srcpixel[x] | 0xff000000;
+}
+
+static void convert_row_premultiply(const BYTE *src, BYTE *dst, UINT width)
+{
+    UINT x;
+
+    for (x = 0; x < width; x++, src += 4, dst += 4)
+    {
+        BYTE alpha = src[3];
+        dst[0] = div255(src[0] * alpha);
+        dst[1] = div255(src[1] * alpha);
+        dst[2] = div255(src[2] * alpha);
+        dst[3] = alpha;
+    }
+}
+
+static void convert_row_unpremultiply(const BYTE *src, BYTE *dst, UINT width)
+{
+    UINT x;
+
+    for (x = 0; x < width; x++, src += 4, dst += 4)
+    {
+        BYTE alpha = src[3];
+        DWORD factor = unpremultiply_factor[alpha];
+        dst[0] = (src[0] * factor) >> 16;
+        dst[1] = (src[1] * factor) >> 16;
+        dst[2] = (src[2] * factor) >> 16;
+        dst[3] = alpha;
+    }
+}
+
+struct row_converter
+{
+    enum pixelformat src_format, dst_format;
+    UINT src_bpp, dst_bpp;
+    row_convert_func convert;
+};
+
+/* Conversions that can be done one row at a time, without state. Pairs not
+ * listed here use the generic copypixels_to_* functions. */
+static const struct row_converter row_converters[] =
+{
+    {format_8bppGray, format_32bppBGRA, 8, 32, convert_row_8bppGray_to_32bppBGRA},
+    {format_8bppGray, format_32bppBGR, 8, 32, convert_row_8bppGray_to_32bppBGRA},
+    {format_8bppGray, format_32bppPBGRA, 8, 32, convert_row_8bppGray_to_32bppBGRA},
+    {format_8bppGray, format_32bppRGBA, 8, 32, convert_row_8bppGray_to_32bppBGRA},
+    {format_8bppGray, format_32bppRGB, 8, 32, convert_row_8bppGray_to_32bppBGRA},
+    {format_8bppGray, format_32bppPRGBA, 8, 32, convert_row_8bppGray_to_32bppBGRA},
+    {format_16bppBGR555, format_32bppBGRA, 16, 32, convert_row_16bppBGR555_to_32bppBGRA},
+    {format_16bppBGR555, format_32bppBGR, 16, 32, convert_row_16bppBGR555_to_32bppBGRA},
+    {format_16bppBGR555, format_32bppPBGRA, 16, 32, convert_row_16bppBGR555_to_32bppBGRA},
+    {format_16bppBGR565, format_32bppBGRA, 16, 32, convert_row_16bppBGR565_to_32bppBGRA},
+    {format_16bppBGR565, format_32bppBGR, 16, 32, convert_row_16bppBGR565_to_32bppBGRA},
+    {format_16bppBGR565, format_32bppPBGRA, 16, 32, convert_row_16bppBGR565_to_32bppBGRA},
+    {format_16bppBGRA5551, format_32bppBGRA, 16, 32, convert_row_16bppBGRA5551_to_32bppBGRA},
+    {format_24bppBGR, format_32bppBGRA, 24, 32, convert_row_24bppBGR_to_32bppBGRA},
+    {format_24bppBGR, format_32bppBGR, 24, 32, convert_row_24bppBGR_to_32bppBGRA},
+    {format_24bppBGR, format_32bppPBGRA, 24, 32, convert_row_24bppBGR_to_32bppBGRA},
+    {format_24bppBGR, format_32bppRGBA, 24, 32, convert_row_24bppBGR_to_32bppRGBA},
+    {format_24bppBGR, format_32bppRGB, 24, 32, convert_row_24bppBGR_to_32bppRGBA},
+    {format_24bppBGR, format_32bppPRGBA, 24, 32, convert_row_24bppBGR_to_32bppRGBA},
+    {format_24bppBGR, format_24bppRGB, 24, 24, convert_row_swap_24bpp},
+    {format_24bppRGB, format_32bppBGRA, 24, 32, convert_row_24bppBGR_to_32bppRGBA},
+    {format_24bppRGB, format_32bppBGR, 24, 32, convert_row_24bppBGR_to_32bppRGBA},
+    {format_24bppRGB, format_32bppPBGRA, 24, 32, convert_row_24bppBGR_to_32bppRGBA},
+    {format_24bppRGB, format_32bppRGBA, 24, 32, convert_row_24bppBGR_to_32bppBGRA},
+    {format_24bppRGB, format_32bppRGB, 24, 32, convert_row_24bppBGR_to_32bppBGRA},
+    {format_24bppRGB, format_32bppPRGBA, 24, 32, convert_row_24bppBGR_to_32bppBGRA},
+    {format_24bppRGB, format_24bppBGR, 24, 24, convert_row_swap_24bpp},
+    {format_32bppBGR, format_32bppBGRA, 32, 32, convert_row_set_alpha},
+    {format_32bppBGR, format_24bppBGR, 32, 24, convert_row_32bppBGRA_to_24bppBGR},
+    {format_32bppBGR, format_24bppRGB, 32, 24, convert_row_32bppBGRA_to_24bppRGB},
+    {format_32bppRGB, format_32bppRGBA, 32, 32, convert_row_set_alpha},
+    {format_32bppBGRA, format_32bppRGBA, 32, 32, convert_row_swap_32bpp},
+    {format_32bppBGRA, format_32bppPBGRA, 32, 32, convert_row_premultiply},
+    {format_32bppBGRA, format_24bppBGR, 32, 24, convert_row_32bppBGRA_to_24bppBGR},
+    {format_32bppBGRA, format_24bppRGB, 32, 24, convert_row_32bppBGRA_to_24bppRGB},
+    {format_32bppRGBA, format_32bppBGRA, 32, 32, convert_row_swap_32bpp},
+    {format_32bppRGBA, format_32bppPRGBA, 32, 32, convert_row_premultiply},
+    {format_32bppRGBA, format_24bppBGR, 32, 24, convert_row_32bppBGRA_to_24bppRGB},
+    {format_32bppPBGRA, format_32bppBGRA, 32, 32, convert_row_unpremultiply},
+    {format_32bppPBGRA, format_24bppBGR, 32, 24, convert_row_32bppBGRA_to_24bppBGR},
+    {format_32bppPBGRA, format_24bppRGB, 32, 24, convert_row_32bppBGRA_to_24bppRGB},
+    {format_32bppPRGBA, format_32bppRGBA, 32, 32, convert_row_unpremultiply},
+};
+
+static const struct row_converter *get_row_converter(enum pixelformat src_format,
+    enum pixelformat dst_format)
+{
+    UINT i;
+
+    for (i = 0; i < ARRAY_SIZE(row_converters); i++)
+    {
+        if (row_converters[i].src_format == src_format && row_converters[i].dst_format == dst_format)
+            return &row_converters[i];
+    }
+
+    return NULL;
+}
+
+static HRESULT copypixels_convert_rows(struct FormatConverter *This, const WICRect *prc,
+    UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
+{
+    const struct row_converter *converter = This->row_converter;
+    UINT srcstride, srcdatasize;
+    BYTE *srcdata;
+    HRESULT hr;
+    INT y;
+
+    if (converter->src_bpp == converter->dst_bpp)
+    {
+        /* convert in place */
+        hr = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
+        if (SUCCEEDED(hr))
+        {
+            for (y = 0; y < prc->Height; y++)
+                converter->convert(pbBuffer + cbStride * y, pbBuffer + cbStride * y, prc->Width);
+        }
+        return hr;
+    }
+
+    srcstride = (converter->src_bpp * prc->Width + 7) / 8;
+    srcdatasize = srcstride * prc->Height;
+
+    srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
+    if (!srcdata) return E_OUTOFMEMORY;
+
+    hr = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
+    if (SUCCEEDED(hr))
+    {
+        for (y = 0; y < prc->Height; y++)
+            converter->convert(srcdata + srcstride * y, pbBuffer + cbStride * y, prc->Width);
+    }
+
+    HeapFree(GetProcessHeap(), 0, srcdata);
+    return hr;
+}
+
 static inline FormatConverter *impl_from_IWICFormatConverter(IWICFormatConverter *iface)
 {
     return CONTAINING_RECORD(iface, FormatConverter, IWICFormatConverter_iface);
@@ -738,22 +1090,13 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
         if (prc)
         {
             HRESULT res;
-            INT x, y;
+            INT y;
 
             res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (FAILED(res)) return res;
 
             for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 0 && alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * 255 / alpha;
-                    }
-                }
+                convert_row_unpremultiply(pbBuffer + cbStride * y, pbBuffer + cbStride * y, prc->Width);
         }
         return S_OK;
     case format_48bppRGB:
@@ -902,22 +1245,13 @@ static HRESULT copypixels_to_32bppRGBA(struct FormatConverter *This, const WICRe
     case format_32bppPRGBA:
         if (prc)
         {
-            INT x, y;
+            INT y;
 
             hr = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (FAILED(hr)) return hr;
 
             for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 0 && alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * 255 / alpha;
-                    }
-                }
+                convert_row_unpremultiply(pbBuffer + cbStride * y, pbBuffer + cbStride * y, prc->Width);
         }
         return S_OK;
 
@@ -976,19 +1310,10 @@ static HRESULT copypixels_to_32bppPBGRA(struct FormatConverter *This, const WICR
         hr = copypixels_to_32bppBGRA(This, prc, cbStride, cbBufferSize, pbBuffer, source_format);
         if (SUCCEEDED(hr) && prc)
         {
-            INT x, y;
+            INT y;
 
             for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = (pbBuffer[cbStride*y+4*x] * alpha + 127) / 255;
-                        pbBuffer[cbStride*y+4*x+1] = (pbBuffer[cbStride*y+4*x+1] * alpha + 127) / 255;
-                        pbBuffer[cbStride*y+4*x+2] = (pbBuffer[cbStride*y+4*x+2] * alpha + 127) / 255;
-                    }
-                }
+                convert_row_premultiply(pbBuffer + cbStride * y, pbBuffer + cbStride * y, prc->Width);
         }
         return hr;
     }
@@ -1009,19 +1334,10 @@ static HRESULT copypixels_to_32bppPRGBA(struct FormatConverter *This, const WICR
         hr = copypixels_to_32bppRGBA(This, prc, cbStride, cbBufferSize, pbBuffer, source_format);
         if (SUCCEEDED(hr) && prc)
         {
-            INT x, y;
+            INT y;
 
             for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = (pbBuffer[cbStride*y+4*x] * alpha + 127) / 255;
-                        pbBuffer[cbStride*y+4*x+1] = (pbBuffer[cbStride*y+4*x+1] * alpha + 127) / 255;
-                        pbBuffer[cbStride*y+4*x+2] = (pbBuffer[cbStride*y+4*x+2] * alpha + 127) / 255;
-                    }
-                }
+                convert_row_premultiply(pbBuffer + cbStride * y, pbBuffer + cbStride * y, prc->Width);
         }
         return hr;
     }
@@ -1138,7 +1454,7 @@ static HRESULT copypixels_to_24bppBGR(struct FormatConverter *This, const WICRec
 
                     for (x = 0; x < prc->Width; x++)
                     {
-                        BYTE gray = (BYTE)floorf(to_sRGB_component(gray_float[x]) * 255.0f + 0.51f);
+                        BYTE gray = float_to_sRGB_byte(gray_float[x]);
                         *bgr++ = gray;
                         *bgr++ = gray;
                         *bgr++ = gray;
@@ -1357,7 +1673,7 @@ static HRESULT copypixels_to_8bppGray(struct FormatConverter *This, const WICRec
                     BYTE *dstpixel = dst;
 
                     for (x=0; x < prc->Width; x++)
-                        *dstpixel++ = (BYTE)floorf(to_sRGB_component(*srcpixel++) * 255.0f + 0.51f);
+                        *dstpixel++ = float_to_sRGB_byte(*srcpixel++);
 
                     src += srcstride;
                     dst += cbStride;
@@ -1393,8 +1709,7 @@ static HRESULT copypixels_to_8bppGray(struct FormatConverter *This, const WICRec
             {
                 float gray = (bgr[2] * 0.2126f + bgr[1] * 0.7152f + bgr[0] * 0.0722f) / 255.0f;
 
-                gray = to_sRGB_component(gray) * 255.0f;
-                dst[x] = (BYTE)floorf(gray + 0.51f);
+                dst[x] = float_to_sRGB_byte(gray);
                 bgr += 3;
             }
             src += srcstride;
@@ -1666,6 +1981,9 @@ static HRESULT WINAPI FormatConverter_CopyPixels(IWICFormatConverter *iface,
             prc = &rc;
         }
 
+        if (This->row_converter)
+            return copypixels_convert_rows(This, prc, cbStride, cbBufferSize, pbBuffer);
+
         return This->dst_format->copy_function(This, prc, cbStride, cbBufferSize,
             pbBuffer, This->src_format->format);
     }
@@ -1761,7 +2079,9 @@ static HRESULT WINAPI FormatConverter_Initialize(IWICFormatConverter *iface,
         This->dither = dither;
         This->alpha_threshold = alpha_threshold;
         This->palette = palette;
+        This->row_converter = get_row_converter(srcinfo->format, dstinfo->format);
         This->source = source;
+        init_conversion_tables_once();
     }
     else
     {
@@ -1844,6 +2164,7 @@ HRESULT FormatConverter_CreateInstance(REFIID iid, void** ppv)
     This->ref = 1;
     This->source = NULL;
     This->palette = NULL;
+    This->row_converter = NULL;
     InitializeCriticalSection(&This->lock);
     This->lock.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": FormatConverter.lock");
 
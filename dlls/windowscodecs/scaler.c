@@ -18,6 +18,7 @@
  */
 
 #include <stdarg.h>
+#include <math.h>
 
 #define COBJMACROS
 
@@ -31,6 +32,20 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(wincodecs);
 
+/* Filter weights are stored in 2.14 fixed point. The vertical pass keeps 6
+ * fractional bits in its 16-bit intermediate, the horizontal pass removes the
+ * remaining 14 + 6 bits. */
+#define WEIGHT_BITS 14
+#define COLUMN_SHIFT 8
+#define OUTPUT_SHIFT (2 * WEIGHT_BITS - COLUMN_SHIFT)
+
+struct scaler_taps
+{
+    UINT count;     /* number of taps per destination pixel */
+    UINT *start;    /* first source pixel for each destination pixel */
+    INT16 *weights; /* count weights for each destination pixel */
+};
+
 typedef struct BitmapScaler {
     IWICBitmapScaler IWICBitmapScaler_iface;
     LONG ref;
@@ -42,6 +57,14 @@ typedef struct BitmapScaler {
     UINT bpp;
     void (*fn_get_required_source_rect)(struct BitmapScaler*,UINT,UINT,WICRect*);
     void (*fn_copy_scanline)(struct BitmapScaler*,UINT,UINT,UINT,BYTE**,UINT,UINT,BYTE*);
+    /* separable filter state, used by all modes except nearest neighbor */
+    struct scaler_taps x_taps, y_taps;
+    BYTE *rows;         /* ring buffer of y_taps.count full source rows */
+    UINT row_stride;
+    UINT rows_start, rows_end; /* source rows currently held in the ring buffer */
+    UINT next_row;      /* destination row following the last CopyPixels call */
+    INT32 *accum;
+    INT16 *columns;
     CRITICAL_SECTION lock; /* must be held when initialized */
 } BitmapScaler;
 
@@ -94,6 +117,27 @@ static ULONG WINAPI BitmapScaler_AddRef(IWICBitmapScaler *iface)
     return ref;
 }
 
+static void free_taps(struct scaler_taps *taps)
+{
+    HeapFree(GetProcessHeap(), 0, taps->start);
+    HeapFree(GetProcessHeap(), 0, taps->weights);
+    taps->start = NULL;
+    taps->weights = NULL;
+    taps->count = 0;
+}
+
+static void Filter_Cleanup(BitmapScaler *This)
+{
+    free_taps(&This->x_taps);
+    free_taps(&This->y_taps);
+    HeapFree(GetProcessHeap(), 0, This->rows);
+    HeapFree(GetProcessHeap(), 0, This->accum);
+    HeapFree(GetProcessHeap(), 0, This->columns);
+    This->rows = NULL;
+    This->accum = NULL;
+    This->columns = NULL;
+}
+
 static ULONG WINAPI BitmapScaler_Release(IWICBitmapScaler *iface)
 {
     BitmapScaler *This = impl_from_IWICBitmapScaler(iface);
@@ -106,6 +150,7 @@ static ULONG WINAPI BitmapScaler_Release(IWICBitmapScaler *iface)
         This->lock.DebugInfo->Spare[0] = 0;
         DeleteCriticalSection(&This->lock);
         if (This->source) IWICBitmapSource_Release(This->source);
+        Filter_Cleanup(This);
         HeapFree(GetProcessHeap(), 0, This);
     }
 
@@ -203,6 +248,291 @@ static void NearestNeighbor_CopyScanline(BitmapScaler *This,
     }
 }
 
+static double linear_filter(double x, double scale)
+{
+    x = fabs(x / scale);
+    return x < 1.0 ? 1.0 - x : 0.0;
+}
+
+/* Catmull-Rom spline, a = -0.5 */
+static double cubic_filter(double x, double scale)
+{
+    x = fabs(x / scale);
+    if (x < 1.0) return (1.5 * x - 2.5) * x * x + 1.0;
+    if (x < 2.0) return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+    return 0.0;
+}
+
+/* Fant resampling: a source pixel contributes in proportion to the part of
+ * it covered by the destination pixel, which is scale source pixels wide. */
+static double fant_filter(double x, double scale)
+{
+    double left = max(x - 0.5, -scale / 2), right = min(x + 0.5, scale / 2);
+    return right > left ? right - left : 0.0;
+}
+
+struct scaler_filter
+{
+    double (*eval)(double x, double scale);
+    double radius;  /* in units of scale */
+    double margin;  /* added to the scaled radius */
+    BOOL widen;     /* stretch the filter over the source footprint when downscaling */
+};
+
+static const struct scaler_filter linear = { linear_filter, 1.0, 0.0, FALSE };
+static const struct scaler_filter cubic = { cubic_filter, 2.0, 0.0, FALSE };
+static const struct scaler_filter fant = { fant_filter, 0.5, 0.5, TRUE };
+static const struct scaler_filter high_quality_cubic = { cubic_filter, 2.0, 0.0, TRUE };
+
+static HRESULT init_taps(struct scaler_taps *taps, const struct scaler_filter *filter,
+    UINT src_size, UINT dst_size)
+{
+    double ratio = (double)src_size / dst_size, scale, center, support, sum;
+    double *weights;
+    int left, right, j, first;
+    UINT i, k, count, max_k;
+    INT16 *w;
+    INT32 total;
+
+    scale = filter->widen && ratio > 1.0 ? ratio : 1.0;
+    support = filter->radius * scale + filter->margin;
+
+    count = (UINT)ceil(2.0 * support) + 1;
+    if (count > src_size) count = src_size;
+
+    taps->count = count;
+    taps->start = HeapAlloc(GetProcessHeap(), 0, dst_size * sizeof(*taps->start));
+    taps->weights = HeapAlloc(GetProcessHeap(), 0, dst_size * count * sizeof(*taps->weights));
+    weights = HeapAlloc(GetProcessHeap(), 0, count * sizeof(*weights));
+    if (!taps->start || !taps->weights || !weights)
+    {
+        HeapFree(GetProcessHeap(), 0, weights);
+        free_taps(taps);
+        return E_OUTOFMEMORY;
+    }
+
+    for (i = 0; i < dst_size; i++)
+    {
+        /* pixel centers, in source pixel coordinates */
+        center = (i + 0.5) * ratio - 0.5;
+        left = (int)ceil(center - support);
+        right = (int)floor(center + support);
+
+        first = max(left, 0);
+        if (first > (int)(src_size - count)) first = src_size - count;
+        taps->start[i] = first;
+
+        /* samples past the edges are clamped to the edge pixels */
+        memset(weights, 0, count * sizeof(*weights));
+        sum = 0.0;
+        for (j = left; j <= right; j++)
+        {
+            double weight = filter->eval(j - center, scale);
+            int pos = min(max(j, 0), (int)src_size - 1) - first;
+
+            if (pos < 0 || pos >= (int)count) continue;
+            weights[pos] += weight;
+            sum += weight;
+        }
+
+        if (sum == 0.0)
+        {
+            weights[min(max((int)floor(center + 0.5), first), first + (int)count - 1) - first] = 1.0;
+            sum = 1.0;
+        }
+
+        w = taps->weights + i * count;
+        total = 0;
+        max_k = 0;
+        for (k = 0; k < count; k++)
+        {
+            w[k] = (INT16)floor(weights[k] / sum * (1 << WEIGHT_BITS) + 0.5);
+            total += w[k];
+            if (w[k] > w[max_k]) max_k = k;
+        }
+        /* make sure the weights add up to exactly one */
+        w[max_k] += (1 << WEIGHT_BITS) - total;
+    }
+
+    HeapFree(GetProcessHeap(), 0, weights);
+    return S_OK;
+}
+
+static HRESULT Filter_Initialize(BitmapScaler *This, const struct scaler_filter *filter)
+{
+    UINT bytesperpixel = This->bpp / 8;
+    HRESULT hr;
+
+    if (FAILED(hr = init_taps(&This->x_taps, filter, This->src_width, This->width)))
+        return hr;
+    if (FAILED(hr = init_taps(&This->y_taps, filter, This->src_height, This->height)))
+        return hr;
+
+    This->row_stride = This->src_width * bytesperpixel;
+    This->rows = HeapAlloc(GetProcessHeap(), 0, This->row_stride * This->y_taps.count);
+    This->accum = HeapAlloc(GetProcessHeap(), 0, This->row_stride * sizeof(*This->accum));
+    This->columns = HeapAlloc(GetProcessHeap(), 0, This->row_stride * sizeof(*This->columns));
+    if (!This->rows || !This->accum || !This->columns)
+        return E_OUTOFMEMORY;
+
+    This->rows_start = This->rows_end = 0;
+    This->next_row = 0;
+
+    return S_OK;
+}
+
+static inline BYTE *Filter_GetRow(BitmapScaler *This, UINT y)
+{
+    return This->rows + (y % This->y_taps.count) * This->row_stride;
+}
+
+/* Makes sure source rows [first, first + y_taps.count) are available,
+ * reading only the ones not already held from a previous scanline. */
+static HRESULT Filter_FetchRows(BitmapScaler *This, UINT first)
+{
+    UINT last = first + This->y_taps.count, y;
+    WICRect rc;
+    HRESULT hr;
+
+    if (first < This->rows_start || first >= This->rows_end)
+        This->rows_start = This->rows_end = first;
+
+    rc.X = 0;
+    rc.Width = This->src_width;
+    rc.Height = 1;
+
+    for (y = This->rows_end; y < last; y++)
+    {
+        rc.Y = y;
+        hr = IWICBitmapSource_CopyPixels(This->source, &rc, This->row_stride,
+            This->row_stride, Filter_GetRow(This, y));
+        if (FAILED(hr))
+        {
+            This->rows_start = This->rows_end = 0;
+            return hr;
+        }
+        This->rows_end = y + 1;
+    }
+
+    This->rows_start = first;
+    return S_OK;
+}
+
+/* The inner loops below work on plain arrays with no dependencies between
+ * iterations, which lets the compiler vectorize them. */
+static void Filter_VerticalPass(BitmapScaler *This, UINT dst_y, UINT offset, UINT length)
+{
+    const INT16 *weights = This->y_taps.weights + dst_y * This->y_taps.count;
+    UINT first = This->y_taps.start[dst_y], i, k;
+    INT32 *accum = This->accum;
+    INT16 *columns = This->columns;
+
+    for (i = 0; i < length; i++)
+        accum[i] = 1 << (COLUMN_SHIFT - 1);
+
+    for (k = 0; k < This->y_taps.count; k++)
+    {
+        const BYTE *row = Filter_GetRow(This, first + k) + offset;
+        INT32 weight = weights[k];
+
+        if (!weight) continue;
+        for (i = 0; i < length; i++)
+            accum[i] += weight * row[i];
+    }
+
+    for (i = 0; i < length; i++)
+        columns[i] = accum[i] >> COLUMN_SHIFT;
+}
+
+static void Filter_HorizontalPass(BitmapScaler *This, UINT dst_x, UINT dst_width,
+    UINT src_x, BYTE *buffer)
+{
+    UINT bytesperpixel = This->bpp / 8, count = This->x_taps.count;
+    UINT i, k, c;
+
+    for (i = 0; i < dst_width; i++)
+    {
+        const INT16 *weights = This->x_taps.weights + (dst_x + i) * count;
+        const INT16 *columns = This->columns + (This->x_taps.start[dst_x + i] - src_x) * bytesperpixel;
+
+        for (c = 0; c < bytesperpixel; c++)
+        {
+            INT32 sum = 1 << (OUTPUT_SHIFT - 1);
+
+            for (k = 0; k < count; k++)
+                sum += weights[k] * columns[k * bytesperpixel + c];
+
+            sum >>= OUTPUT_SHIFT;
+            buffer[i * bytesperpixel + c] = sum < 0 ? 0 : sum > 255 ? 255 : sum;
+        }
+    }
+}
+
+static HRESULT Filter_CopyPixels(BitmapScaler *This, const WICRect *dest_rect,
+    UINT cbStride, BYTE *pbBuffer)
+{
+    UINT bytesperpixel = This->bpp / 8;
+    UINT src_x, src_end, y;
+    HRESULT hr = S_OK;
+
+    if (!dest_rect->Width || !dest_rect->Height)
+        return S_OK;
+
+    /* Rows held from the previous call are only reused when the caller reads
+     * the image scanline by scanline, as MSDN recommends. */
+    if (dest_rect->Y != This->next_row)
+        This->rows_start = This->rows_end = 0;
+
+    src_x = This->x_taps.start[dest_rect->X];
+    src_end = This->x_taps.start[dest_rect->X + dest_rect->Width - 1] + This->x_taps.count;
+
+    for (y = 0; y < dest_rect->Height; y++)
+    {
+        UINT dst_y = dest_rect->Y + y;
+
+        if (FAILED(hr = Filter_FetchRows(This, This->y_taps.start[dst_y])))
+            break;
+
+        Filter_VerticalPass(This, dst_y, src_x * bytesperpixel, (src_end - src_x) * bytesperpixel);
+        Filter_HorizontalPass(This, dest_rect->X, dest_rect->Width, src_x, pbBuffer + cbStride * y);
+    }
+
+    This->next_row = SUCCEEDED(hr) ? dest_rect->Y + dest_rect->Height : 0;
+    return hr;
+}
+
+static BOOL is_filterable_format(const WICPixelFormatGUID *format)
+{
+    static const WICPixelFormatGUID *formats[] =
+    {
+        &GUID_WICPixelFormat8bppGray,
+        &GUID_WICPixelFormat24bppBGR,
+        &GUID_WICPixelFormat24bppRGB,
+        &GUID_WICPixelFormat32bppBGR,
+        &GUID_WICPixelFormat32bppBGRA,
+        &GUID_WICPixelFormat32bppPBGRA,
+        &GUID_WICPixelFormat32bppRGB,
+        &GUID_WICPixelFormat32bppRGBA,
+        &GUID_WICPixelFormat32bppPRGBA,
+    };
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(formats); i++)
+        if (IsEqualGUID(format, formats[i])) return TRUE;
+
+    return FALSE;
+}
+
+/* Indexed and packed formats, which are filtered once expanded to 32bppBGRA. */
+static BOOL is_expandable_format(const WICPixelFormatGUID *format, UINT bpp)
+{
+    return (bpp % 8) != 0 ||
+        IsEqualGUID(format, &GUID_WICPixelFormat8bppIndexed) ||
+        IsEqualGUID(format, &GUID_WICPixelFormat16bppBGR555) ||
+        IsEqualGUID(format, &GUID_WICPixelFormat16bppBGR565) ||
+        IsEqualGUID(format, &GUID_WICPixelFormat16bppBGRA5551);
+}
+
 static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
     const WICRect *prc, UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
 {
@@ -257,6 +587,12 @@ static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
         goto end;
     }
 
+    if (This->x_taps.count)
+    {
+        hr = Filter_CopyPixels(This, &dest_rect, cbStride, pbBuffer);
+        goto end;
+    }
+
     /* MSDN recommends calling CopyPixels once for each scanline from top to
      * bottom, and claims codecs optimize for this. Ideally, when called in this
      * way, we should avoid requesting a scanline from the source more than
@@ -349,26 +685,63 @@ static HRESULT WINAPI BitmapScaler_Initialize(IWICBitmapScaler *iface,
 
     if (SUCCEEDED(hr))
     {
+        const struct scaler_filter *filter = NULL;
+
         switch (mode)
         {
+        case WICBitmapInterpolationModeNearestNeighbor:
+            break;
+        case WICBitmapInterpolationModeLinear:
+            filter = &linear;
+            break;
+        case WICBitmapInterpolationModeCubic:
+            filter = &cubic;
+            break;
+        case WICBitmapInterpolationModeFant:
+            filter = &fant;
+            break;
+        case WICBitmapInterpolationModeHighQualityCubic:
+            filter = &high_quality_cubic;
+            break;
         default:
             FIXME("unsupported mode %i\n", mode);
-            /* fall-through */
-        case WICBitmapInterpolationModeNearestNeighbor:
-            if ((This->bpp % 8) == 0)
-            {
-                IWICBitmapSource_AddRef(pISource);
-                This->source = pISource;
-            }
-            else
+            break;
+        }
+
+        /* Filters work on 8 bits per channel. Indexed and 16bpp packed formats
+         * are expanded to 32bppBGRA first, other formats are point sampled. */
+        if (filter && !is_filterable_format(&src_pixelformat) &&
+            !is_expandable_format(&src_pixelformat, This->bpp))
+        {
+            FIXME("filtering not supported for format %s\n", debugstr_guid(&src_pixelformat));
+            filter = NULL;
+        }
+
+        if (filter ? is_filterable_format(&src_pixelformat) : (This->bpp % 8) == 0)
+        {
+            IWICBitmapSource_AddRef(pISource);
+            This->source = pISource;
+        }
+        else
+        {
+            hr = WICConvertBitmapSource(&GUID_WICPixelFormat32bppBGRA,
+                pISource, &This->source);
+            This->bpp = 32;
+        }
+
+        if (SUCCEEDED(hr) && filter)
+        {
+            if (FAILED(hr = Filter_Initialize(This, filter)))
             {
-                hr = WICConvertBitmapSource(&GUID_WICPixelFormat32bppBGRA,
-                    pISource, &This->source);
-                This->bpp = 32;
+                Filter_Cleanup(This);
+                IWICBitmapSource_Release(This->source);
+                This->source = NULL;
             }
+        }
+        else
+        {
             This->fn_get_required_source_rect = NearestNeighbor_GetRequiredSourceRect;
             This->fn_copy_scanline = NearestNeighbor_CopyScanline;
-            break;
         }
     }
 
@@ -527,6 +900,11 @@ HRESULT BitmapScaler_Create(IWICBitmapScaler **scaler)
     This->src_height = 0;
     This->mode = 0;
     This->bpp = 0;
+    memset(&This->x_taps, 0, sizeof(This->x_taps));
+    memset(&This->y_taps, 0, sizeof(This->y_taps));
+    This->rows = NULL;
+    This->accum = NULL;
+    This->columns = NULL;
     InitializeCriticalSection(&This->lock);
     This->lock.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": BitmapScaler.lock");
 
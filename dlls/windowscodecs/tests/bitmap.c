@@ -1315,6 +1315,166 @@ static void test_bitmap_scaler(void)
     IWICBitmap_Release(bitmap);
 }
 
+static void check_scaled_gray(WICBitmapInterpolationMode mode, const BYTE *values, UINT src_width,
+        UINT src_height, UINT width, UINT height, const BYTE *expected, BOOL vertical)
+{
+    DWORD src[8 * 2], dst[8 * 2];
+    IWICBitmapScaler *scaler;
+    IWICBitmap *bitmap;
+    unsigned int i;
+    HRESULT hr;
+    BYTE v;
+
+    for (i = 0; i < src_width * src_height; i++)
+        src[i] = 0xff000000 | values[i] * 0x010101;
+
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, src_width, src_height, &GUID_WICPixelFormat32bppBGRA,
+        src_width * sizeof(DWORD), src_width * src_height * sizeof(DWORD), (BYTE *)src, &bitmap);
+    ok(hr == S_OK, "Failed to create a bitmap, hr %#lx.\n", hr);
+
+    hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+    ok(hr == S_OK, "Failed to create bitmap scaler, hr %#lx.\n", hr);
+    hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap, width, height, mode);
+    ok(hr == S_OK, "Failed to initialize bitmap scaler, hr %#lx.\n", hr);
+
+    memset(dst, 0, sizeof(dst));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, width * sizeof(DWORD), width * height * sizeof(DWORD),
+        (BYTE *)dst);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#lx.\n", hr);
+
+    /* Sources vary along a single axis, so every row (or column) of the result is the same. */
+    for (i = 0; i < width * height; i++)
+    {
+        BYTE e = expected[vertical ? i / width : i % width];
+
+        v = dst[i] & 0xff;
+        ok(dst[i] == (0xff000000 | v * 0x010101) && abs(v - e) <= 1,
+            "Got pixel %#08lx at %u, expected %#02x.\n", dst[i], i, e);
+    }
+
+    IWICBitmapScaler_Release(scaler);
+    IWICBitmap_Release(bitmap);
+}
+
+static void test_bitmap_scaler_modes(void)
+{
+    static const WICBitmapInterpolationMode modes[] =
+    {
+        WICBitmapInterpolationModeNearestNeighbor,
+        WICBitmapInterpolationModeLinear,
+        WICBitmapInterpolationModeCubic,
+        WICBitmapInterpolationModeFant,
+        WICBitmapInterpolationModeHighQualityCubic,
+    };
+    static const struct
+    {
+        UINT width, height;
+    }
+    sizes[] =
+    {
+        { 3, 2 },
+        { 8, 6 },
+        { 21, 13 },
+    };
+    static const BYTE gradient[] = { 0x00, 0x40, 0x80, 0xff, 0x00, 0x40, 0x80, 0xff };
+    static const BYTE stripes[] = { 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff,
+                                    0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff };
+    static const BYTE vgradient[] = { 0x00, 0x00, 0x40, 0x40, 0x80, 0x80, 0xff, 0xff };
+    static const struct
+    {
+        BYTE up[8];
+        BYTE down[3];
+    }
+    filtered[] =
+    {
+        /* NearestNeighbor */
+        { { 0x00, 0x00, 0x40, 0x40, 0x80, 0x80, 0xff, 0xff }, { 0x00, 0x00, 0xff } },
+        /* Linear */
+        { { 0x00, 0x10, 0x30, 0x50, 0x70, 0xa0, 0xdf, 0xff }, { 0xd4, 0x80, 0x2b } },
+        /* Cubic */
+        { { 0x00, 0x0c, 0x2f, 0x4f, 0x6c, 0x9e, 0xe7, 0xff }, { 0xef, 0x80, 0x10 } },
+        /* Fant */
+        { { 0x00, 0x10, 0x30, 0x50, 0x70, 0xa0, 0xdf, 0xff }, { 0x60, 0x80, 0x9f } },
+        /* HighQualityCubic */
+        { { 0x00, 0x0c, 0x2f, 0x4f, 0x6c, 0x9e, 0xe7, 0xff }, { 0x68, 0x80, 0x97 } },
+    };
+    DWORD src[8 * 6], dst[21 * 13], row[21];
+    IWICBitmapScaler *scaler;
+    WICPixelFormatGUID format;
+    IWICBitmap *bitmap;
+    unsigned int i, j, k;
+    HRESULT hr;
+    UINT y;
+
+    for (i = 0; i < ARRAY_SIZE(src); i++)
+        src[i] = 0x80c01040;
+
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 8, 6, &GUID_WICPixelFormat32bppBGRA,
+        8 * sizeof(DWORD), sizeof(src), (BYTE *)src, &bitmap);
+    ok(hr == S_OK, "Failed to create a bitmap, hr %#lx.\n", hr);
+
+    for (i = 0; i < ARRAY_SIZE(modes); i++)
+    {
+        for (j = 0; j < ARRAY_SIZE(sizes); j++)
+        {
+            winetest_push_context("mode %d, %ux%u", modes[i], sizes[j].width, sizes[j].height);
+
+            hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+            ok(hr == S_OK, "Failed to create bitmap scaler, hr %#lx.\n", hr);
+
+            hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap,
+                sizes[j].width, sizes[j].height, modes[i]);
+            if (hr == WINCODEC_ERR_UNSUPPORTEDOPERATION || hr == E_INVALIDARG)
+            {
+                /* HighQualityCubic is not available before Windows 10. */
+                win_skip("Mode %d is not supported.\n", modes[i]);
+                IWICBitmapScaler_Release(scaler);
+                winetest_pop_context();
+                continue;
+            }
+            ok(hr == S_OK, "Failed to initialize bitmap scaler, hr %#lx.\n", hr);
+
+            if (!j)
+            {
+                /* Each mode interpolates differently between distinct source pixels. */
+                check_scaled_gray(modes[i], gradient, 4, 2, 8, 2, filtered[i].up, FALSE);
+                check_scaled_gray(modes[i], vgradient, 2, 4, 2, 8, filtered[i].up, TRUE);
+                check_scaled_gray(modes[i], stripes, 8, 2, 3, 2, filtered[i].down, FALSE);
+            }
+
+            hr = IWICBitmapScaler_GetPixelFormat(scaler, &format);
+            ok(hr == S_OK, "Failed to get pixel format, hr %#lx.\n", hr);
+            ok(IsEqualGUID(&format, &GUID_WICPixelFormat32bppBGRA), "Unexpected pixel format %s.\n",
+                wine_dbgstr_guid(&format));
+
+            memset(dst, 0, sizeof(dst));
+            hr = IWICBitmapScaler_CopyPixels(scaler, NULL, sizes[j].width * sizeof(DWORD),
+                sizeof(dst), (BYTE *)dst);
+            ok(hr == S_OK, "Failed to copy pixels, hr %#lx.\n", hr);
+
+            for (k = 0; k < sizes[j].width * sizes[j].height; k++)
+                if (dst[k] != 0x80c01040) break;
+            ok(k == sizes[j].width * sizes[j].height, "Unexpected pixel at %u.\n", k);
+
+            /* Reading one scanline at a time gives the same result. */
+            for (y = 0; y < sizes[j].height; y++)
+            {
+                WICRect rc = { 0, y, sizes[j].width, 1 };
+
+                hr = IWICBitmapScaler_CopyPixels(scaler, &rc, sizeof(row), sizeof(row), (BYTE *)row);
+                ok(hr == S_OK, "Failed to copy pixels, hr %#lx.\n", hr);
+                ok(!memcmp(row, dst + y * sizes[j].width, sizes[j].width * sizeof(DWORD)),
+                    "Unexpected data in row %u.\n", y);
+            }
+
+            IWICBitmapScaler_Release(scaler);
+            winetest_pop_context();
+        }
+    }
+
+    IWICBitmap_Release(bitmap);
+}
+
 static LONG obj_refcount(void *obj)
 {
     IUnknown_AddRef((IUnknown *)obj);
@@ -1485,6 +1645,7 @@ START_TEST(bitmap)
     test_CreateBitmapFromHBITMAP();
     test_clipper();
     test_bitmap_scaler();
+    test_bitmap_scaler_modes();
 
     IWICImagingFactory_Release(factory);
 
@@ -2041,6 +2041,11 @@ START_TEST(converter)
     test_conversion(&testdata_32bppBGRA, &testdata_24bppRGB, "32bppBGRA -> 24bppRGB", FALSE);
     test_conversion(&testdata_32bppRGBA, &testdata_24bppBGR, "32bppRGBA -> 24bppBGR", FALSE);
 
+    test_conversion(&testdata_24bppBGR, &testdata_32bppBGRA, "24bppBGR -> 32bppBGRA", FALSE);
+    test_conversion(&testdata_24bppBGR, &testdata_32bppRGBA, "24bppBGR -> 32bppRGBA", FALSE);
+    test_conversion(&testdata_24bppRGB, &testdata_32bppBGRA, "24bppRGB -> 32bppBGRA", FALSE);
+    test_conversion(&testdata_32bppBGRA, &testdata_24bppBGR, "32bppBGRA -> 24bppBGR", FALSE);
+
     test_conversion(&testdata_32bppRGBA, &testdata_32bppBGRA, "32bppRGBA -> 32bppBGRA", FALSE);
     test_conversion(&testdata_32bppBGRA, &testdata_32bppRGBA, "32bppBGRA -> 32bppRGBA", FALSE);
 
@@ -126,6 +126,21 @@ bool wg_parser_get_next_read_offset(struct wg_parser *parser, uint64_t *offset,
     return true;
 }
 
+void *wg_parser_get_read_buffer(struct wg_parser *parser, uint32_t size)
+{
+    struct wg_parser_get_read_buffer_params params =
+    {
+        .parser = parser,
+        .size = size,
+    };
+
+    TRACE("parser %p, size %u.\n", parser, size);
+
+    if (__wine_unix_call(unix_handle, unix_wg_parser_get_read_buffer, &params))
+        return NULL;
+    return params.data;
+}
+
 void wg_parser_push_data(struct wg_parser *parser, const void *data, uint32_t size)
 {
     struct wg_parser_push_data_params params =
@@ -596,12 +596,7 @@ static DWORD CALLBACK read_thread(void *arg)
 {
     struct media_source *source = arg;
     IMFByteStream *byte_stream = source->byte_stream;
-    size_t buffer_size = 4096;
     uint64_t file_size;
-    void *data;
-
-    if (!(data = malloc(buffer_size)))
-        return 0;
 
     IMFByteStream_GetLength(byte_stream, &file_size);
 
@@ -613,6 +608,7 @@ static DWORD CALLBACK read_thread(void *arg)
         ULONG ret_size;
         uint32_t size;
         HRESULT hr;
+        void *data;
 
         if (!wg_parser_get_next_read_offset(source->wg_parser, &offset, &size))
             continue;
@@ -626,14 +622,15 @@ static DWORD CALLBACK read_thread(void *arg)
          * an error when reading past the file size. */
         if (!size)
         {
-            wg_parser_push_data(source->wg_parser, data, 0);
+            wg_parser_push_data(source->wg_parser, "", 0);
             continue;
         }
 
-        if (!array_reserve(&data, &buffer_size, size, 1))
+        /* Read straight into the buffer which will be handed to GStreamer. */
+        if (!(data = wg_parser_get_read_buffer(source->wg_parser, size)))
         {
-            free(data);
-            return 0;
+            wg_parser_push_data(source->wg_parser, NULL, 0);
+            continue;
         }
 
         ret_size = 0;
@@ -647,7 +644,6 @@ static DWORD CALLBACK read_thread(void *arg)
         wg_parser_push_data(source->wg_parser, SUCCEEDED(hr) ? data : NULL, ret_size);
     }
 
-    free(data);
     TRACE("Media source is shutting down; exiting.\n");
     return 0;
 }
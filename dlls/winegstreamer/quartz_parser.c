@@ -960,11 +960,6 @@ static DWORD CALLBACK read_thread(void *arg)
 {
     struct parser *filter = arg;
     LONGLONG file_size, unused;
-    size_t buffer_size = 4096;
-    void *data = NULL;
-
-    if (!(data = malloc(buffer_size)))
-        return 0;
 
     IAsyncReader_Length(filter->reader, &file_size, &unused);
 
@@ -975,6 +970,7 @@ static DWORD CALLBACK read_thread(void *arg)
         uint64_t offset;
         uint32_t size;
         HRESULT hr;
+        void *data;
 
         if (!wg_parser_get_next_read_offset(filter->wg_parser, &offset, &size))
             continue;
@@ -984,10 +980,17 @@ static DWORD CALLBACK read_thread(void *arg)
         else if (offset + size >= file_size)
             size = file_size - offset;
 
-        if (!array_reserve(&data, &buffer_size, size, 1))
+        if (!size)
         {
-            free(data);
-            return 0;
+            wg_parser_push_data(filter->wg_parser, "", 0);
+            continue;
+        }
+
+        /* Read straight into the buffer which will be handed to GStreamer. */
+        if (!(data = wg_parser_get_read_buffer(filter->wg_parser, size)))
+        {
+            wg_parser_push_data(filter->wg_parser, NULL, 0);
+            continue;
         }
 
         hr = IAsyncReader_SyncRead(filter->reader, offset, size, data);
@@ -997,7 +1000,6 @@ static DWORD CALLBACK read_thread(void *arg)
         wg_parser_push_data(filter->wg_parser, SUCCEEDED(hr) ? data : NULL, size);
     }
 
-    free(data);
     TRACE("Streaming stopped; exiting.\n");
     return 0;
 }
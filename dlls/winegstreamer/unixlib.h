@@ -188,6 +188,13 @@ struct wg_parser_get_next_read_offset_params
     UINT64 offset;
 };
 
+struct wg_parser_get_read_buffer_params
+{
+    struct wg_parser *parser;
+    UINT32 size;
+    void *data;
+};
+
 struct wg_parser_push_data_params
 {
     struct wg_parser *parser;
@@ -294,6 +301,7 @@ enum unix_funcs
     unix_wg_parser_disconnect,
 
     unix_wg_parser_get_next_read_offset,
+    unix_wg_parser_get_read_buffer,
     unix_wg_parser_push_data,
 
     unix_wg_parser_get_stream_count,
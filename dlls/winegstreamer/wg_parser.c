@@ -86,6 +86,9 @@ struct wg_parser
         uint32_t size;
         bool done;
         GstFlowReturn ret;
+        /* buffer is mapped for the read thread to fill in place */
+        GstMapInfo map_info;
+        bool mapped, allocated;
     } read_request;
 
     bool sink_connected;
@@ -150,29 +153,91 @@ static NTSTATUS wg_parser_get_next_read_offset(void *args)
     return S_OK;
 }
 
+static NTSTATUS wg_parser_get_read_buffer(void *args)
+{
+    struct wg_parser_get_read_buffer_params *params = args;
+    struct wg_parser *parser = params->parser;
+    uint32_t size = params->size;
+    GstBuffer *buffer;
+
+    params->data = NULL;
+
+    pthread_mutex_lock(&parser->mutex);
+
+    if (!size || size > parser->read_request.size || parser->read_request.mapped)
+    {
+        pthread_mutex_unlock(&parser->mutex);
+        return E_INVALIDARG;
+    }
+
+    /* As in wg_parser_push_data(), don't allocate more than the read thread
+     * is actually going to fill. */
+    if (!(buffer = parser->read_request.buffer) && !(buffer = gst_buffer_new_and_alloc(size)))
+    {
+        pthread_mutex_unlock(&parser->mutex);
+        return E_OUTOFMEMORY;
+    }
+
+    if (!gst_buffer_map(buffer, &parser->read_request.map_info, GST_MAP_WRITE))
+    {
+        if (!parser->read_request.buffer)
+            gst_buffer_unref(buffer);
+        pthread_mutex_unlock(&parser->mutex);
+        return E_FAIL;
+    }
+
+    if (!parser->read_request.buffer)
+    {
+        parser->read_request.buffer = buffer;
+        parser->read_request.allocated = true;
+    }
+    parser->read_request.mapped = true;
+    params->data = parser->read_request.map_info.data;
+
+    pthread_mutex_unlock(&parser->mutex);
+    return S_OK;
+}
+
 static NTSTATUS wg_parser_push_data(void *args)
 {
     const struct wg_parser_push_data_params *params = args;
     struct wg_parser *parser = params->parser;
     const void *data = params->data;
     uint32_t size = params->size;
+    const void *mapped_data = NULL;
 
     pthread_mutex_lock(&parser->mutex);
 
+    if (parser->read_request.mapped)
+    {
+        mapped_data = parser->read_request.map_info.data;
+        gst_buffer_unmap(parser->read_request.buffer, &parser->read_request.map_info);
+        parser->read_request.mapped = false;
+    }
+
     if (data)
     {
         if (size)
         {
             GstMapInfo map_info;
 
-            /* Note that we don't allocate the buffer until we have a size.
-             * midiparse passes a NULL buffer and a size of UINT_MAX, in an
-             * apparent attempt to read the whole input stream at once. */
-            if (!parser->read_request.buffer)
-                parser->read_request.buffer = gst_buffer_new_and_alloc(size);
-            gst_buffer_map(parser->read_request.buffer, &map_info, GST_MAP_WRITE);
-            memcpy(map_info.data, data, size);
-            gst_buffer_unmap(parser->read_request.buffer, &map_info);
+            if (data == mapped_data)
+            {
+                /* The read thread filled the buffer in place. */
+                if (parser->read_request.allocated)
+                    gst_buffer_set_size(parser->read_request.buffer, size);
+            }
+            else
+            {
+                /* Note that we don't allocate the buffer until we have a size.
+                 * midiparse passes a NULL buffer and a size of UINT_MAX, in an
+                 * apparent attempt to read the whole input stream at once. */
+                if (!parser->read_request.buffer)
+                    parser->read_request.buffer = gst_buffer_new_and_alloc(size);
+                gst_buffer_map(parser->read_request.buffer, &map_info, GST_MAP_WRITE);
+                memcpy(map_info.data, data, size);
+                gst_buffer_unmap(parser->read_request.buffer, &map_info);
+            }
             parser->read_request.ret = GST_FLOW_OK;
         }
         else
@@ -184,6 +249,13 @@ static NTSTATUS wg_parser_push_data(void *args)
     {
         parser->read_request.ret = GST_FLOW_ERROR;
     }
+
+    if (parser->read_request.ret != GST_FLOW_OK && parser->read_request.allocated)
+    {
+        gst_buffer_unref(parser->read_request.buffer);
+        parser->read_request.buffer = NULL;
+    }
+    parser->read_request.allocated = false;
     parser->read_request.done = true;
     parser->read_request.size = 0;
 
@@ -900,6 +972,8 @@ static GstFlowReturn src_getrange_cb(GstPad *pad, GstObject *parent,
     parser->read_request.offset = offset;
     parser->read_request.size = size;
     parser->read_request.done = false;
+    parser->read_request.mapped = false;
+    parser->read_request.allocated = false;
     pthread_cond_signal(&parser->read_cond);
 
     /* Note that we don't unblock this wait on GST_EVENT_FLUSH_START. We expect
@@ -1613,6 +1687,7 @@ const unixlib_entry_t __wine_unix_call_funcs[] =
     X(wg_parser_disconnect),
 
     X(wg_parser_get_next_read_offset),
+    X(wg_parser_get_read_buffer),
     X(wg_parser_push_data),
 
     X(wg_parser_get_stream_count),
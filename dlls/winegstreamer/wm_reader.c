@@ -585,12 +585,7 @@ static DWORD CALLBACK read_thread(void *arg)
     struct wm_reader *reader = arg;
     IStream *stream = reader->source_stream;
     HANDLE file = reader->file;
-    size_t buffer_size = 4096;
     uint64_t file_size;
-    void *data;
-
-    if (!(data = malloc(buffer_size)))
-        return 0;
 
     if (file)
     {
@@ -616,6 +611,7 @@ static DWORD CALLBACK read_thread(void *arg)
         ULONG ret_size;
         uint32_t size;
         HRESULT hr;
+        void *data;
 
         if (!wg_parser_get_next_read_offset(reader->wg_parser, &offset, &size))
             continue;
@@ -627,14 +623,15 @@ static DWORD CALLBACK read_thread(void *arg)
 
         if (!size)
         {
-            wg_parser_push_data(reader->wg_parser, data, 0);
+            wg_parser_push_data(reader->wg_parser, "", 0);
             continue;
         }
 
-        if (!array_reserve(&data, &buffer_size, size, 1))
+        /* Read straight into the buffer which will be handed to GStreamer. */
+        if (!(data = wg_parser_get_read_buffer(reader->wg_parser, size)))
         {
-            free(data);
-            return 0;
+            wg_parser_push_data(reader->wg_parser, NULL, 0);
+            continue;
         }
 
         ret_size = 0;
@@ -667,7 +664,6 @@ static DWORD CALLBACK read_thread(void *arg)
         wg_parser_push_data(reader->wg_parser, data, ret_size);
     }
 
-    free(data);
     TRACE("Reader is shutting down; exiting.\n");
     return 0;
 }
@@ -832,6 +832,36 @@ typedef struct
 } cursor_pos_t;
 
 
+typedef volatile struct
+{
+    int                  seq;
+    int                  cursor_x;
+    int                  cursor_y;
+    unsigned int         cursor_last_change;
+    unsigned char        keystate[256];
+} desktop_shm_t;
+
+typedef volatile struct
+{
+    int                  seq;
+    unsigned int         wake_bits;
+    unsigned int         changed_bits;
+} queue_shm_t;
+
+
+typedef volatile struct
+{
+    int                  seq;
+    user_handle_t        handle;
+    unsigned int         dpi;
+    unsigned int         flags;
+    rectangle_t          window;
+    rectangle_t          client;
+} window_shm_t;
+#define WINDOW_SHM_LAYOUTRTL 0x01
+#define WINDOW_SHM_TOPLEVEL  0x02
+
+
 
 
 
@@ -2627,7 +2657,7 @@ struct get_msg_queue_reply
 {
     struct reply_header __header;
     obj_handle_t handle;
-    char __pad_12[4];
+    obj_handle_t shm_handle;
 };
 
 
@@ -3352,6 +3382,20 @@ enum coords_relative
 
 
 
+struct get_window_shm_request
+{
+    struct request_header __header;
+    char __pad_12[4];
+};
+struct get_window_shm_reply
+{
+    struct reply_header __header;
+    obj_handle_t   handle;
+    char __pad_12[4];
+};
+
+
+
 struct get_window_text_request
 {
     struct request_header __header;
@@ -3751,6 +3795,20 @@ struct get_thread_desktop_reply
 
 
 
+struct get_desktop_shm_request
+{
+    struct request_header __header;
+    char __pad_12[4];
+};
+struct get_desktop_shm_reply
+{
+    struct reply_header __header;
+    obj_handle_t handle;
+    char __pad_12[4];
+};
+
+
+
 struct set_thread_desktop_request
 {
     struct request_header __header;
@@ -5635,6 +5693,7 @@ enum request
     REQ_get_window_tree,
     REQ_set_window_pos,
     REQ_get_window_rectangles,
+    REQ_get_window_shm,
     REQ_get_window_text,
     REQ_set_window_text,
     REQ_get_windows_offset,
@@ -5660,6 +5719,7 @@ enum request
     REQ_open_input_desktop,
     REQ_close_desktop,
     REQ_get_thread_desktop,
+    REQ_get_desktop_shm,
     REQ_set_thread_desktop,
     REQ_enum_desktop,
     REQ_set_user_object_info,
@@ -5920,6 +5980,7 @@ union generic_request
     struct get_window_tree_request get_window_tree_request;
     struct set_window_pos_request set_window_pos_request;
     struct get_window_rectangles_request get_window_rectangles_request;
+    struct get_window_shm_request get_window_shm_request;
     struct get_window_text_request get_window_text_request;
     struct set_window_text_request set_window_text_request;
     struct get_windows_offset_request get_windows_offset_request;
@@ -5945,6 +6006,7 @@ union generic_request
     struct open_input_desktop_request open_input_desktop_request;
     struct close_desktop_request close_desktop_request;
     struct get_thread_desktop_request get_thread_desktop_request;
+    struct get_desktop_shm_request get_desktop_shm_request;
     struct set_thread_desktop_request set_thread_desktop_request;
     struct enum_desktop_request enum_desktop_request;
     struct set_user_object_info_request set_user_object_info_request;
@@ -6203,6 +6265,7 @@ union generic_reply
     struct get_window_tree_reply get_window_tree_reply;
     struct set_window_pos_reply set_window_pos_reply;
     struct get_window_rectangles_reply get_window_rectangles_reply;
+    struct get_window_shm_reply get_window_shm_reply;
     struct get_window_text_reply get_window_text_reply;
     struct set_window_text_reply set_window_text_reply;
     struct get_windows_offset_reply get_windows_offset_reply;
@@ -6228,6 +6291,7 @@ union generic_reply
     struct open_input_desktop_reply open_input_desktop_reply;
     struct close_desktop_reply close_desktop_reply;
     struct get_thread_desktop_reply get_thread_desktop_reply;
+    struct get_desktop_shm_reply get_desktop_shm_reply;
     struct set_thread_desktop_reply set_thread_desktop_reply;
     struct enum_desktop_reply enum_desktop_reply;
     struct set_user_object_info_reply set_user_object_info_reply;
@@ -6338,7 +6402,7 @@ union generic_reply
 
 /* ### protocol_version begin ### */
 
-#define SERVER_PROTOCOL_VERSION 756
+#define SERVER_PROTOCOL_VERSION 758
 
 /* ### protocol_version end ### */
 
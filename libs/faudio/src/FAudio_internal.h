@@ -699,6 +699,12 @@ extern void (*FAudio_INTERNAL_Amplify)(
 );
 
 extern FAudioMixCallback FAudio_INTERNAL_Mix_Generic;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_1in_2out;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_1in_6out;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_1in_8out;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_2in_2out;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_2in_6out;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_2in_8out;
 
 #define MIX_FUNC(type) \
 	extern void FAudio_INTERNAL_Mix_##type##_Scalar( \
@@ -1543,6 +1543,342 @@ void FAudio_INTERNAL_Mix_2in_8out_Scalar(
 	}
 }
 
+/* The SIMD mixers handle the common mono/stereo to stereo/5.1/7.1 sends.
+ * Frames that do not fill a whole vector are left to the scalar versions.
+ * Products are summed before being added to dst, in the same order as the
+ * scalar mixers.
+ */
+
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_Mix_1in_2out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	const __m128 vols = _mm_setr_ps(
+		coefficients[0], coefficients[1],
+		coefficients[0], coefficients[1]
+	);
+	for (i = 0; toMix - i >= 2; i += 2, src += 2, dst += 4)
+	{
+		const __m128 dat = _mm_setr_ps(src[0], src[0], src[1], src[1]);
+		_mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(dat, vols)));
+	}
+	FAudio_INTERNAL_Mix_1in_2out_Scalar(toMix - i, 1, 2, src, dst, coefficients);
+}
+
+void FAudio_INTERNAL_Mix_1in_6out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	/* Two frames fill three vectors: 0-3, 4-5|0-1, 2-5 */
+	const __m128 vols0 = _mm_loadu_ps(&coefficients[0]);
+	const __m128 vols1 = _mm_setr_ps(
+		coefficients[4], coefficients[5],
+		coefficients[0], coefficients[1]
+	);
+	const __m128 vols2 = _mm_loadu_ps(&coefficients[2]);
+	for (i = 0; toMix - i >= 2; i += 2, src += 2, dst += 12)
+	{
+		const __m128 dat0 = _mm_set1_ps(src[0]);
+		const __m128 dat1 = _mm_setr_ps(src[0], src[0], src[1], src[1]);
+		const __m128 dat2 = _mm_set1_ps(src[1]);
+		_mm_storeu_ps(dst + 0, _mm_add_ps(_mm_loadu_ps(dst + 0), _mm_mul_ps(dat0, vols0)));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(dat1, vols1)));
+		_mm_storeu_ps(dst + 8, _mm_add_ps(_mm_loadu_ps(dst + 8), _mm_mul_ps(dat2, vols2)));
+	}
+	FAudio_INTERNAL_Mix_1in_6out_Scalar(toMix - i, 1, 6, src, dst, coefficients);
+}
+
+void FAudio_INTERNAL_Mix_1in_8out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	const __m128 vols0 = _mm_loadu_ps(&coefficients[0]);
+	const __m128 vols1 = _mm_loadu_ps(&coefficients[4]);
+	for (i = 0; i < toMix; i += 1, src += 1, dst += 8)
+	{
+		const __m128 dat = _mm_set1_ps(src[0]);
+		_mm_storeu_ps(dst + 0, _mm_add_ps(_mm_loadu_ps(dst + 0), _mm_mul_ps(dat, vols0)));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(dat, vols1)));
+	}
+}
+
+void FAudio_INTERNAL_Mix_2in_2out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	/* Left and right input coefficients, for two frames of output */
+	const __m128 volsL = _mm_setr_ps(
+		coefficients[0], coefficients[2],
+		coefficients[0], coefficients[2]
+	);
+	const __m128 volsR = _mm_setr_ps(
+		coefficients[1], coefficients[3],
+		coefficients[1], coefficients[3]
+	);
+	for (i = 0; toMix - i >= 2; i += 2, src += 4, dst += 4)
+	{
+		const __m128 dat = _mm_loadu_ps(src);
+		const __m128 datL = _mm_shuffle_ps(dat, dat, _MM_SHUFFLE(2, 2, 0, 0));
+		const __m128 datR = _mm_shuffle_ps(dat, dat, _MM_SHUFFLE(3, 3, 1, 1));
+		_mm_storeu_ps(dst, _mm_add_ps(
+			_mm_loadu_ps(dst),
+			_mm_add_ps(_mm_mul_ps(datL, volsL), _mm_mul_ps(datR, volsR))
+		));
+	}
+	FAudio_INTERNAL_Mix_2in_2out_Scalar(toMix - i, 2, 2, src, dst, coefficients);
+}
+
+void FAudio_INTERNAL_Mix_2in_6out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	/* Two frames fill three vectors: 0-3, 4-5|0-1, 2-5 */
+	const __m128 volsL0 = _mm_setr_ps(
+		coefficients[0], coefficients[2],
+		coefficients[4], coefficients[6]
+	);
+	const __m128 volsR0 = _mm_setr_ps(
+		coefficients[1], coefficients[3],
+		coefficients[5], coefficients[7]
+	);
+	const __m128 volsL1 = _mm_setr_ps(
+		coefficients[8], coefficients[10],
+		coefficients[0], coefficients[2]
+	);
+	const __m128 volsR1 = _mm_setr_ps(
+		coefficients[9], coefficients[11],
+		coefficients[1], coefficients[3]
+	);
+	const __m128 volsL2 = _mm_setr_ps(
+		coefficients[4], coefficients[6],
+		coefficients[8], coefficients[10]
+	);
+	const __m128 volsR2 = _mm_setr_ps(
+		coefficients[5], coefficients[7],
+		coefficients[9], coefficients[11]
+	);
+	for (i = 0; toMix - i >= 2; i += 2, src += 4, dst += 12)
+	{
+		const __m128 dat = _mm_loadu_ps(src);
+		const __m128 datL0 = _mm_shuffle_ps(dat, dat, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 datR0 = _mm_shuffle_ps(dat, dat, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m128 datL1 = _mm_shuffle_ps(dat, dat, _MM_SHUFFLE(2, 2, 0, 0));
+		const __m128 datR1 = _mm_shuffle_ps(dat, dat, _MM_SHUFFLE(3, 3, 1, 1));
+		const __m128 datL2 = _mm_shuffle_ps(dat, dat, _MM_SHUFFLE(2, 2, 2, 2));
+		const __m128 datR2 = _mm_shuffle_ps(dat, dat, _MM_SHUFFLE(3, 3, 3, 3));
+		_mm_storeu_ps(dst + 0, _mm_add_ps(
+			_mm_loadu_ps(dst + 0),
+			_mm_add_ps(_mm_mul_ps(datL0, volsL0), _mm_mul_ps(datR0, volsR0))
+		));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(
+			_mm_loadu_ps(dst + 4),
+			_mm_add_ps(_mm_mul_ps(datL1, volsL1), _mm_mul_ps(datR1, volsR1))
+		));
+		_mm_storeu_ps(dst + 8, _mm_add_ps(
+			_mm_loadu_ps(dst + 8),
+			_mm_add_ps(_mm_mul_ps(datL2, volsL2), _mm_mul_ps(datR2, volsR2))
+		));
+	}
+	FAudio_INTERNAL_Mix_2in_6out_Scalar(toMix - i, 2, 6, src, dst, coefficients);
+}
+
+void FAudio_INTERNAL_Mix_2in_8out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	const __m128 volsL0 = _mm_setr_ps(
+		coefficients[0], coefficients[2],
+		coefficients[4], coefficients[6]
+	);
+	const __m128 volsR0 = _mm_setr_ps(
+		coefficients[1], coefficients[3],
+		coefficients[5], coefficients[7]
+	);
+	const __m128 volsL1 = _mm_setr_ps(
+		coefficients[8], coefficients[10],
+		coefficients[12], coefficients[14]
+	);
+	const __m128 volsR1 = _mm_setr_ps(
+		coefficients[9], coefficients[11],
+		coefficients[13], coefficients[15]
+	);
+	for (i = 0; i < toMix; i += 1, src += 2, dst += 8)
+	{
+		const __m128 datL = _mm_set1_ps(src[0]);
+		const __m128 datR = _mm_set1_ps(src[1]);
+		_mm_storeu_ps(dst + 0, _mm_add_ps(
+			_mm_loadu_ps(dst + 0),
+			_mm_add_ps(_mm_mul_ps(datL, volsL0), _mm_mul_ps(datR, volsR0))
+		));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(
+			_mm_loadu_ps(dst + 4),
+			_mm_add_ps(_mm_mul_ps(datL, volsL1), _mm_mul_ps(datR, volsR1))
+		));
+	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_Mix_1in_2out_NEON(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	const float32x2_t vols = vld1_f32(coefficients);
+	const float32x4_t vols2 = vcombine_f32(vols, vols);
+	for (i = 0; toMix - i >= 2; i += 2, src += 2, dst += 4)
+	{
+		const float32x4_t dat = vcombine_f32(vdup_n_f32(src[0]), vdup_n_f32(src[1]));
+		vst1q_f32(dst, vaddq_f32(vld1q_f32(dst), vmulq_f32(dat, vols2)));
+	}
+	FAudio_INTERNAL_Mix_1in_2out_Scalar(toMix - i, 1, 2, src, dst, coefficients);
+}
+
+void FAudio_INTERNAL_Mix_1in_6out_NEON(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	const float32x4_t vols0 = vld1q_f32(&coefficients[0]);
+	const float32x2_t vols1 = vld1_f32(&coefficients[4]);
+	for (i = 0; i < toMix; i += 1, src += 1, dst += 6)
+	{
+		vst1q_f32(dst, vaddq_f32(vld1q_f32(dst), vmulq_n_f32(vols0, src[0])));
+		vst1_f32(dst + 4, vadd_f32(vld1_f32(dst + 4), vmul_n_f32(vols1, src[0])));
+	}
+}
+
+void FAudio_INTERNAL_Mix_1in_8out_NEON(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	const float32x4_t vols0 = vld1q_f32(&coefficients[0]);
+	const float32x4_t vols1 = vld1q_f32(&coefficients[4]);
+	for (i = 0; i < toMix; i += 1, src += 1, dst += 8)
+	{
+		vst1q_f32(dst + 0, vaddq_f32(vld1q_f32(dst + 0), vmulq_n_f32(vols0, src[0])));
+		vst1q_f32(dst + 4, vaddq_f32(vld1q_f32(dst + 4), vmulq_n_f32(vols1, src[0])));
+	}
+}
+
+void FAudio_INTERNAL_Mix_2in_2out_NEON(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	/* De-interleaved coefficients: {0, 2} for left, {1, 3} for right */
+	const float32x2x2_t vols = vld2_f32(coefficients);
+	const float32x4_t volsL = vcombine_f32(vols.val[0], vols.val[0]);
+	const float32x4_t volsR = vcombine_f32(vols.val[1], vols.val[1]);
+	for (i = 0; toMix - i >= 2; i += 2, src += 4, dst += 4)
+	{
+		const float32x4_t datL = vcombine_f32(vdup_n_f32(src[0]), vdup_n_f32(src[2]));
+		const float32x4_t datR = vcombine_f32(vdup_n_f32(src[1]), vdup_n_f32(src[3]));
+		vst1q_f32(dst, vaddq_f32(
+			vld1q_f32(dst),
+			vaddq_f32(vmulq_f32(datL, volsL), vmulq_f32(datR, volsR))
+		));
+	}
+	FAudio_INTERNAL_Mix_2in_2out_Scalar(toMix - i, 2, 2, src, dst, coefficients);
+}
+
+void FAudio_INTERNAL_Mix_2in_6out_NEON(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	const float32x4x2_t vols0 = vld2q_f32(&coefficients[0]);
+	const float32x2x2_t vols1 = vld2_f32(&coefficients[8]);
+	for (i = 0; i < toMix; i += 1, src += 2, dst += 6)
+	{
+		vst1q_f32(dst, vaddq_f32(
+			vld1q_f32(dst),
+			vaddq_f32(vmulq_n_f32(vols0.val[0], src[0]), vmulq_n_f32(vols0.val[1], src[1]))
+		));
+		vst1_f32(dst + 4, vadd_f32(
+			vld1_f32(dst + 4),
+			vadd_f32(vmul_n_f32(vols1.val[0], src[0]), vmul_n_f32(vols1.val[1], src[1]))
+		));
+	}
+}
+
+void FAudio_INTERNAL_Mix_2in_8out_NEON(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	const float32x4x2_t vols0 = vld2q_f32(&coefficients[0]);
+	const float32x4x2_t vols1 = vld2q_f32(&coefficients[8]);
+	for (i = 0; i < toMix; i += 1, src += 2, dst += 8)
+	{
+		vst1q_f32(dst + 0, vaddq_f32(
+			vld1q_f32(dst + 0),
+			vaddq_f32(vmulq_n_f32(vols0.val[0], src[0]), vmulq_n_f32(vols0.val[1], src[1]))
+		));
+		vst1q_f32(dst + 4, vaddq_f32(
+			vld1q_f32(dst + 4),
+			vaddq_f32(vmulq_n_f32(vols1.val[0], src[0]), vmulq_n_f32(vols1.val[1], src[1]))
+		));
+	}
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
 /* SECTION 5: InitSIMDFunctions. Assigns based on SSE2/NEON support. */
 
 void (*FAudio_INTERNAL_Convert_U8_To_F32)(
@@ -1571,6 +1907,12 @@ void (*FAudio_INTERNAL_Amplify)(
 );
 
 FAudioMixCallback FAudio_INTERNAL_Mix_Generic;
+FAudioMixCallback FAudio_INTERNAL_Mix_1in_2out;
+FAudioMixCallback FAudio_INTERNAL_Mix_1in_6out;
+FAudioMixCallback FAudio_INTERNAL_Mix_1in_8out;
+FAudioMixCallback FAudio_INTERNAL_Mix_2in_2out;
+FAudioMixCallback FAudio_INTERNAL_Mix_2in_6out;
+FAudioMixCallback FAudio_INTERNAL_Mix_2in_8out;
 
 void FAudio_INTERNAL_InitSIMDFunctions(uint8_t hasSSE2, uint8_t hasNEON)
 {
@@ -1584,6 +1926,12 @@ void FAudio_INTERNAL_InitSIMDFunctions(uint8_t hasSSE2, uint8_t hasNEON)
 		FAudio_INTERNAL_ResampleStereo = FAudio_INTERNAL_ResampleStereo_SSE2;
 		FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_SSE2;
 		FAudio_INTERNAL_Mix_Generic = FAudio_INTERNAL_Mix_Generic_SSE2;
+		FAudio_INTERNAL_Mix_1in_2out = FAudio_INTERNAL_Mix_1in_2out_SSE2;
+		FAudio_INTERNAL_Mix_1in_6out = FAudio_INTERNAL_Mix_1in_6out_SSE2;
+		FAudio_INTERNAL_Mix_1in_8out = FAudio_INTERNAL_Mix_1in_8out_SSE2;
+		FAudio_INTERNAL_Mix_2in_2out = FAudio_INTERNAL_Mix_2in_2out_SSE2;
+		FAudio_INTERNAL_Mix_2in_6out = FAudio_INTERNAL_Mix_2in_6out_SSE2;
+		FAudio_INTERNAL_Mix_2in_8out = FAudio_INTERNAL_Mix_2in_8out_SSE2;
 		return;
 	}
 #endif
@@ -1597,6 +1945,12 @@ void FAudio_INTERNAL_InitSIMDFunctions(uint8_t hasSSE2, uint8_t hasNEON)
 		FAudio_INTERNAL_ResampleStereo = FAudio_INTERNAL_ResampleStereo_NEON;
 		FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_NEON;
 		FAudio_INTERNAL_Mix_Generic = FAudio_INTERNAL_Mix_Generic_Scalar;
+		FAudio_INTERNAL_Mix_1in_2out = FAudio_INTERNAL_Mix_1in_2out_NEON;
+		FAudio_INTERNAL_Mix_1in_6out = FAudio_INTERNAL_Mix_1in_6out_NEON;
+		FAudio_INTERNAL_Mix_1in_8out = FAudio_INTERNAL_Mix_1in_8out_NEON;
+		FAudio_INTERNAL_Mix_2in_2out = FAudio_INTERNAL_Mix_2in_2out_NEON;
+		FAudio_INTERNAL_Mix_2in_6out = FAudio_INTERNAL_Mix_2in_6out_NEON;
+		FAudio_INTERNAL_Mix_2in_8out = FAudio_INTERNAL_Mix_2in_8out_NEON;
 		return;
 	}
 #endif
@@ -1608,6 +1962,12 @@ void FAudio_INTERNAL_InitSIMDFunctions(uint8_t hasSSE2, uint8_t hasNEON)
 	FAudio_INTERNAL_ResampleStereo = FAudio_INTERNAL_ResampleStereo_Scalar;
 	FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_Scalar;
 	FAudio_INTERNAL_Mix_Generic = FAudio_INTERNAL_Mix_Generic_Scalar;
+	FAudio_INTERNAL_Mix_1in_2out = FAudio_INTERNAL_Mix_1in_2out_Scalar;
+	FAudio_INTERNAL_Mix_1in_6out = FAudio_INTERNAL_Mix_1in_6out_Scalar;
+	FAudio_INTERNAL_Mix_1in_8out = FAudio_INTERNAL_Mix_1in_8out_Scalar;
+	FAudio_INTERNAL_Mix_2in_2out = FAudio_INTERNAL_Mix_2in_2out_Scalar;
+	FAudio_INTERNAL_Mix_2in_6out = FAudio_INTERNAL_Mix_2in_6out_Scalar;
+	FAudio_INTERNAL_Mix_2in_8out = FAudio_INTERNAL_Mix_2in_8out_Scalar;
 #else
 	FAudio_assert(0 && "Need converter functions!");
 #endif
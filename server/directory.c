@@ -183,7 +183,13 @@ static struct object_type *create_object_type( struct object *root, unsigned int
 
 static void directory_dump( struct object *obj, int verbose )
 {
-    fputs( "Directory\n", stderr );
+    struct directory *dir = (struct directory *)obj;
+    unsigned int count, used, max_chain;
+
+    assert( obj->ops == &directory_ops );
+
+    get_namespace_stats( dir->entries, &count, &used, &max_chain );
+    fprintf( stderr, "Directory entries=%u used buckets=%u longest chain=%u\n", count, used, max_chain );
 }
 
 static struct object *directory_lookup_name( struct object *obj, struct unicode_str *name,
@@ -245,7 +251,7 @@ static void directory_destroy( struct object *obj )
 {
     struct directory *dir = (struct directory *)obj;
     assert( obj->ops == &directory_ops );
-    free( dir->entries );
+    free_namespace( dir->entries );
 }
 
 static struct directory *create_directory( struct object *root, const struct unicode_str *name,
@@ -46,9 +46,13 @@
 struct namespace
 {
     unsigned int        hash_size;       /* size of hash table */
-    struct list         names[1];        /* array of hash entry lists */
+    unsigned int        min_hash_size;   /* initial size, the table never shrinks below it */
+    unsigned int        count;           /* number of names in the table */
+    struct list        *names;           /* array of hash entry lists */
 };
 
+#define NAMESPACE_MAX_LOAD 4  /* average chain length that triggers a grow */
+
 
 struct type_descr no_type =
 {
@@ -134,11 +138,71 @@ void *memdup( const void *data, size_t len )
 
 /*****************************************************************/
 
+/* move all the names of a namespace to a hash table of a new size */
+static void namespace_resize( struct namespace *namespace, unsigned int hash_size )
+{
+    struct list *names;
+    unsigned int i, max_chain;
+
+    if (!(names = malloc( hash_size * sizeof(*names) ))) return;  /* keep using the current table */
+    for (i = 0; i < hash_size; i++) list_init( &names[i] );
+
+    /* walk the chains backwards so that names which compare equal keep their relative order */
+    for (i = 0; i < namespace->hash_size; i++)
+    {
+        struct list *ptr;
+        while ((ptr = list_tail( &namespace->names[i] )))
+        {
+            struct object_name *name = LIST_ENTRY( ptr, struct object_name, entry );
+            list_remove( &name->entry );
+            list_add_head( &names[name->hash % hash_size], &name->entry );
+        }
+    }
+    free( namespace->names );
+    namespace->names = names;
+    namespace->hash_size = hash_size;
+
+    if (debug_level > 1)
+    {
+        get_namespace_stats( namespace, NULL, NULL, &max_chain );
+        fprintf( stderr, "%04x: namespace %p resized to %u buckets, %u names, longest chain %u\n",
+                 current ? current->id : 0, namespace, hash_size, namespace->count, max_chain );
+    }
+}
+
 void namespace_add( struct namespace *namespace, struct object_name *ptr )
 {
-    unsigned int hash = hash_strW( ptr->name, ptr->len, namespace->hash_size );
+    ptr->namespace = namespace;
+    list_add_head( &namespace->names[ptr->hash % namespace->hash_size], &ptr->entry );
+    if (++namespace->count > namespace->hash_size * NAMESPACE_MAX_LOAD)
+        namespace_resize( namespace, namespace->hash_size * 2 + 1 );
+}
 
-    list_add_head( &namespace->names[hash], &ptr->entry );
+static void namespace_remove( struct namespace *namespace, struct object_name *ptr )
+{
+    list_remove( &ptr->entry );
+    ptr->namespace = NULL;
+    namespace->count--;
+    if (namespace->hash_size > namespace->min_hash_size &&
+        namespace->count < namespace->hash_size / NAMESPACE_MAX_LOAD)
+        namespace_resize( namespace, max( namespace->hash_size / 2, namespace->min_hash_size ));
+}
+
+/* retrieve the number of names, the number of used buckets and the longest chain of a namespace */
+void get_namespace_stats( const struct namespace *namespace, unsigned int *count,
+                          unsigned int *used_buckets, unsigned int *max_chain )
+{
+    unsigned int i, len, used = 0, longest = 0;
+
+    for (i = 0; i < namespace->hash_size; i++)
+    {
+        if (!(len = list_count( &namespace->names[i] ))) continue;
+        used++;
+        longest = max( longest, len );
+    }
+    if (count) *count = namespace->count;
+    if (used_buckets) *used_buckets = used;
+    if (max_chain) *max_chain = longest;
 }
 
 /* allocate a name for an object */
@@ -149,7 +213,9 @@ static struct object_name *alloc_name( const struct unicode_str *name )
     if ((ptr = mem_alloc( sizeof(*ptr) + name->len - sizeof(ptr->name) )))
     {
         ptr->len = name->len;
+        ptr->hash = hash_nameW( name->str, name->len );
         ptr->parent = NULL;
+        ptr->namespace = NULL;
         memcpy( ptr->name, name->str, name->len );
     }
     return ptr;
@@ -459,14 +525,16 @@ struct object *find_object( const struct namespace *namespace, const struct unic
 {
     const struct list *list;
     struct list *p;
+    unsigned int hash;
 
     if (!name || !name->len) return NULL;
 
-    list = &namespace->names[ hash_strW( name->str, name->len, namespace->hash_size ) ];
+    hash = hash_nameW( name->str, name->len );
+    list = &namespace->names[hash % namespace->hash_size];
     LIST_FOR_EACH( p, list )
     {
         const struct object_name *ptr = LIST_ENTRY( p, struct object_name, entry );
-        if (ptr->len != name->len) continue;
+        if (ptr->hash != hash || ptr->len != name->len) continue;
         if (attributes & OBJ_CASE_INSENSITIVE)
         {
             if (!memicmp_strW( ptr->name, name->str, name->len ))
@@ -505,15 +573,28 @@ struct namespace *create_namespace( unsigned int hash_size )
     struct namespace *namespace;
     unsigned int i;
 
-    namespace = mem_alloc( sizeof(*namespace) + (hash_size - 1) * sizeof(namespace->names[0]) );
-    if (namespace)
+    if (!(namespace = mem_alloc( sizeof(*namespace) ))) return NULL;
+    if (!(namespace->names = mem_alloc( hash_size * sizeof(namespace->names[0]) )))
     {
-        namespace->hash_size      = hash_size;
-        for (i = 0; i < hash_size; i++) list_init( &namespace->names[i] );
+        free( namespace );
+        return NULL;
     }
+    namespace->hash_size      = hash_size;
+    namespace->min_hash_size  = hash_size;
+    namespace->count          = 0;
+    for (i = 0; i < hash_size; i++) list_init( &namespace->names[i] );
     return namespace;
 }
 
+/* free a namespace, it must not contain any names */
+void free_namespace( struct namespace *namespace )
+{
+    if (!namespace) return;
+    assert( !namespace->count );
+    free( namespace->names );
+    free( namespace );
+}
+
 /* functions for unimplemented/default object operations */
 
 int no_add_queue( struct object *obj, struct wait_queue_entry *entry )
@@ -700,7 +781,8 @@ int no_link_name( struct object *obj, struct object_name *name, struct object *p
 
 void default_unlink_name( struct object *obj, struct object_name *name )
 {
-    list_remove( &name->entry );
+    if (name->namespace) namespace_remove( name->namespace, name );
+    else list_remove( &name->entry );
 }
 
 struct object *no_open_file( struct object *obj, unsigned int access, unsigned int sharing,
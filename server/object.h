@@ -128,6 +128,8 @@ struct object_name
     struct list         entry;           /* entry in the hash list */
     struct object      *obj;             /* object owning this name */
     struct object      *parent;          /* parent object */
+    struct namespace   *namespace;       /* namespace containing the name */
+    unsigned int        hash;            /* case-insensitive hash of the name */
     data_size_t         len;             /* name length in bytes */
     WCHAR               name[1];
 };
@@ -156,6 +158,9 @@ extern void *open_named_object( struct object *parent, const struct object_ops *
                                 const struct unicode_str *name, unsigned int attributes );
 extern void unlink_named_object( struct object *obj );
 extern struct namespace *create_namespace( unsigned int hash_size );
+extern void free_namespace( struct namespace *namespace );
+extern void get_namespace_stats( const struct namespace *namespace, unsigned int *count,
+                                 unsigned int *used_buckets, unsigned int *max_chain );
 extern void free_kernel_objects( struct object *obj );
 /* grab/release_object can take any pointer, but you better make sure */
 /* that the thing pointed to starts with a struct object... */
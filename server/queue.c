@@ -26,6 +26,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <poll.h>
+#include <sys/mman.h>
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -124,6 +125,8 @@ struct msg_queue
     unsigned int           wake_mask;       /* wakeup mask */
     unsigned int           changed_bits;    /* changed wakeup bits */
     unsigned int           changed_mask;    /* changed wakeup mask */
+    struct object         *shm_mapping;     /* mapping of the shared memory */
+    queue_shm_t           *shared;          /* wakeup bits shared with the client */
     int                    paint_count;     /* pending paint messages count */
     int                    hotkey_count;    /* pending hotkey messages count */
     int                    quit_message;    /* is there a pending quit message? */
@@ -315,7 +318,12 @@ static struct msg_queue *create_msg_queue( struct thread *thread, struct thread_
         list_init( &queue->expired_timers );
         for (i = 0; i < NB_MSG_KINDS; i++) list_init( &queue->msg_list[i] );
 
-        thread->queue = queue;
+        if (!(queue->shm_mapping = create_shared_mapping( sizeof(*queue->shared), (void **)&queue->shared )))
+        {
+            release_object( queue );
+            queue = NULL;
+        }
+        else thread->queue = queue;
     }
     if (new_input) release_object( new_input );
     return queue;
@@ -403,6 +411,16 @@ static struct message *alloc_hardware_message( lparam_t info, struct hw_msg_sour
     return msg;
 }
 
+/* publish the cursor position to the desktop shared memory */
+static void update_desktop_shared_cursor( struct desktop *desktop )
+{
+    shared_write_begin( &desktop->shared->seq );
+    desktop->shared->cursor_x = desktop->cursor.x;
+    desktop->shared->cursor_y = desktop->cursor.y;
+    desktop->shared->cursor_last_change = desktop->cursor.last_change;
+    shared_write_end( &desktop->shared->seq );
+}
+
 static int update_desktop_cursor_pos( struct desktop *desktop, int x, int y )
 {
     int updated;
@@ -413,6 +431,7 @@ static int update_desktop_cursor_pos( struct desktop *desktop, int x, int y )
     desktop->cursor.x = x;
     desktop->cursor.y = y;
     desktop->cursor.last_change = get_tick_count();
+    update_desktop_shared_cursor( desktop );
 
     return updated;
 }
@@ -500,6 +519,15 @@ void set_queue_hooks( struct thread *thread, struct hook_table *hooks )
     queue->hooks = hooks;
 }
 
+/* publish the queue bits to the client shared memory */
+static void update_queue_shared( struct msg_queue *queue )
+{
+    shared_write_begin( &queue->shared->seq );
+    queue->shared->wake_bits = queue->wake_bits;
+    queue->shared->changed_bits = queue->changed_bits;
+    shared_write_end( &queue->shared->seq );
+}
+
 /* check the queue status */
 static inline int is_signaled( struct msg_queue *queue )
 {
@@ -516,6 +544,7 @@ static inline void set_queue_bits( struct msg_queue *queue, unsigned int bits )
     }
     queue->wake_bits |= bits;
     queue->changed_bits |= bits;
+    update_queue_shared( queue );
     if (is_signaled( queue )) wake_up( &queue->obj, 0 );
 }
 
@@ -524,6 +553,7 @@ static inline void clear_queue_bits( struct msg_queue *queue, unsigned int bits
 {
     queue->wake_bits &= ~bits;
     queue->changed_bits &= ~bits;
+    update_queue_shared( queue );
     if (!(queue->wake_bits & (QS_KEY | QS_MOUSEBUTTON)))
     {
         if (queue->keystate_lock) unlock_input_keystate( queue->input );
@@ -1077,6 +1107,11 @@ static void msg_queue_destroy( struct object *obj )
     release_object( queue->input );
     if (queue->hooks) release_object( queue->hooks );
     if (queue->fd) release_object( queue->fd );
+    if (queue->shm_mapping)
+    {
+        munmap( (void *)queue->shared, sizeof(*queue->shared) );
+        release_object( queue->shm_mapping );
+    }
 }
 
 static void msg_queue_poll_event( struct fd *fd, int event )
@@ -1785,6 +1820,7 @@ static int queue_mouse_message( struct desktop *desktop, user_handle_t win, cons
     };
 
     desktop->cursor.last_change = get_tick_count();
+    update_desktop_shared_cursor( desktop );
     flags = input->mouse.flags;
     time  = input->mouse.time;
     if (!time) time = desktop->cursor.last_change;
@@ -2402,7 +2438,10 @@ DECL_HANDLER(get_msg_queue)
     struct msg_queue *queue = get_current_queue();
 
     reply->handle = 0;
-    if (queue) reply->handle = alloc_handle( current->process, queue, SYNCHRONIZE, 0 );
+    reply->shm_handle = 0;
+    if (!queue) return;
+    reply->handle = alloc_handle( current->process, queue, SYNCHRONIZE, 0 );
+    reply->shm_handle = alloc_handle( current->process, queue->shm_mapping, SECTION_MAP_READ | SECTION_QUERY, 0 );
 }
 
 
@@ -2461,6 +2500,7 @@ DECL_HANDLER(get_queue_status)
         reply->wake_bits    = queue->wake_bits;
         reply->changed_bits = queue->changed_bits;
         queue->changed_bits &= ~req->clear_bits;
+        update_queue_shared( queue );
     }
     else reply->wake_bits = reply->changed_bits = 0;
 }
@@ -2643,6 +2683,7 @@ DECL_HANDLER(get_message)
     }
     if (filter & QS_INPUT) queue->changed_bits &= ~QS_INPUT;
     if (filter & QS_PAINT) queue->changed_bits &= ~QS_PAINT;
+    update_queue_shared( queue );
 
     /* then check for posted messages */
     if ((filter & QS_POSTMESSAGE) &&
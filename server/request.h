@@ -266,6 +266,7 @@ DECL_HANDLER(get_window_children_from_point);
 DECL_HANDLER(get_window_tree);
 DECL_HANDLER(set_window_pos);
 DECL_HANDLER(get_window_rectangles);
+DECL_HANDLER(get_window_shm);
 DECL_HANDLER(get_window_text);
 DECL_HANDLER(set_window_text);
 DECL_HANDLER(get_windows_offset);
@@ -291,6 +292,7 @@ DECL_HANDLER(open_desktop);
 DECL_HANDLER(open_input_desktop);
 DECL_HANDLER(close_desktop);
 DECL_HANDLER(get_thread_desktop);
+DECL_HANDLER(get_desktop_shm);
 DECL_HANDLER(set_thread_desktop);
 DECL_HANDLER(enum_desktop);
 DECL_HANDLER(set_user_object_info);
@@ -550,6 +552,7 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_get_window_tree,
     (req_handler)req_set_window_pos,
     (req_handler)req_get_window_rectangles,
+    (req_handler)req_get_window_shm,
     (req_handler)req_get_window_text,
     (req_handler)req_set_window_text,
     (req_handler)req_get_windows_offset,
@@ -575,6 +578,7 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_open_input_desktop,
     (req_handler)req_close_desktop,
     (req_handler)req_get_thread_desktop,
+    (req_handler)req_get_desktop_shm,
     (req_handler)req_set_thread_desktop,
     (req_handler)req_enum_desktop,
     (req_handler)req_set_user_object_info,
@@ -1310,6 +1314,7 @@ C_ASSERT( FIELD_OFFSET(struct get_atom_information_reply, total) == 16 );
 C_ASSERT( sizeof(struct get_atom_information_reply) == 24 );
 C_ASSERT( sizeof(struct get_msg_queue_request) == 16 );
 C_ASSERT( FIELD_OFFSET(struct get_msg_queue_reply, handle) == 8 );
+C_ASSERT( FIELD_OFFSET(struct get_msg_queue_reply, shm_handle) == 12 );
 C_ASSERT( sizeof(struct get_msg_queue_reply) == 16 );
 C_ASSERT( FIELD_OFFSET(struct set_queue_fd_request, handle) == 12 );
 C_ASSERT( sizeof(struct set_queue_fd_request) == 16 );
@@ -1577,6 +1582,9 @@ C_ASSERT( sizeof(struct get_window_rectangles_request) == 24 );
 C_ASSERT( FIELD_OFFSET(struct get_window_rectangles_reply, window) == 8 );
 C_ASSERT( FIELD_OFFSET(struct get_window_rectangles_reply, client) == 24 );
 C_ASSERT( sizeof(struct get_window_rectangles_reply) == 40 );
+C_ASSERT( sizeof(struct get_window_shm_request) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_window_shm_reply, handle) == 8 );
+C_ASSERT( sizeof(struct get_window_shm_reply) == 16 );
 C_ASSERT( FIELD_OFFSET(struct get_window_text_request, handle) == 12 );
 C_ASSERT( sizeof(struct get_window_text_request) == 16 );
 C_ASSERT( FIELD_OFFSET(struct get_window_text_reply, length) == 8 );
@@ -1693,6 +1701,9 @@ C_ASSERT( FIELD_OFFSET(struct get_thread_desktop_request, tid) == 12 );
 C_ASSERT( sizeof(struct get_thread_desktop_request) == 16 );
 C_ASSERT( FIELD_OFFSET(struct get_thread_desktop_reply, handle) == 8 );
 C_ASSERT( sizeof(struct get_thread_desktop_reply) == 16 );
+C_ASSERT( sizeof(struct get_desktop_shm_request) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_desktop_shm_reply, handle) == 8 );
+C_ASSERT( sizeof(struct get_desktop_shm_reply) == 16 );
 C_ASSERT( FIELD_OFFSET(struct set_thread_desktop_request, handle) == 12 );
 C_ASSERT( sizeof(struct set_thread_desktop_request) == 16 );
 C_ASSERT( FIELD_OFFSET(struct enum_desktop_request, winstation) == 12 );
@@ -2581,6 +2581,7 @@ static void dump_get_msg_queue_request( const struct get_msg_queue_request *req
 static void dump_get_msg_queue_reply( const struct get_msg_queue_reply *req )
 {
     fprintf( stderr, " handle=%04x", req->handle );
+    fprintf( stderr, ", shm_handle=%04x", req->shm_handle );
 }
 
 static void dump_set_queue_fd_request( const struct set_queue_fd_request *req )
@@ -3069,6 +3070,15 @@ static void dump_get_window_rectangles_reply( const struct get_window_rectangles
     dump_rectangle( ", client=", &req->client );
 }
 
+static void dump_get_window_shm_request( const struct get_window_shm_request *req )
+{
+}
+
+static void dump_get_window_shm_reply( const struct get_window_shm_reply *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+}
+
 static void dump_get_window_text_request( const struct get_window_text_request *req )
 {
     fprintf( stderr, " handle=%08x", req->handle );
@@ -3328,6 +3338,15 @@ static void dump_get_thread_desktop_reply( const struct get_thread_desktop_reply
     fprintf( stderr, " handle=%04x", req->handle );
 }
 
+static void dump_get_desktop_shm_request( const struct get_desktop_shm_request *req )
+{
+}
+
+static void dump_get_desktop_shm_reply( const struct get_desktop_shm_reply *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+}
+
 static void dump_set_thread_desktop_request( const struct set_thread_desktop_request *req )
 {
     fprintf( stderr, " handle=%04x", req->handle );
@@ -4653,6 +4672,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_get_window_tree_request,
     (dump_func)dump_set_window_pos_request,
     (dump_func)dump_get_window_rectangles_request,
+    (dump_func)dump_get_window_shm_request,
     (dump_func)dump_get_window_text_request,
     (dump_func)dump_set_window_text_request,
     (dump_func)dump_get_windows_offset_request,
@@ -4678,6 +4698,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_open_input_desktop_request,
     (dump_func)dump_close_desktop_request,
     (dump_func)dump_get_thread_desktop_request,
+    (dump_func)dump_get_desktop_shm_request,
     (dump_func)dump_set_thread_desktop_request,
     (dump_func)dump_enum_desktop_request,
     (dump_func)dump_set_user_object_info_request,
@@ -4934,6 +4955,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_get_window_tree_reply,
     (dump_func)dump_set_window_pos_reply,
     (dump_func)dump_get_window_rectangles_reply,
+    (dump_func)dump_get_window_shm_reply,
     (dump_func)dump_get_window_text_reply,
     NULL,
     (dump_func)dump_get_windows_offset_reply,
@@ -4959,6 +4981,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_open_input_desktop_reply,
     NULL,
     (dump_func)dump_get_thread_desktop_reply,
+    (dump_func)dump_get_desktop_shm_reply,
     NULL,
     (dump_func)dump_enum_desktop_reply,
     (dump_func)dump_set_user_object_info_reply,
@@ -5215,6 +5238,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "get_window_tree",
     "set_window_pos",
     "get_window_rectangles",
+    "get_window_shm",
     "get_window_text",
     "set_window_text",
     "get_windows_offset",
@@ -5240,6 +5264,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "open_input_desktop",
     "close_desktop",
     "get_thread_desktop",
+    "get_desktop_shm",
     "set_thread_desktop",
     "enum_desktop",
     "set_user_object_info",
@@ -76,7 +76,9 @@ struct desktop
     struct thread_input *foreground_input; /* thread input of foreground thread */
     unsigned int         users;            /* processes and threads using this desktop */
     struct global_cursor cursor;           /* global cursor information */
-    unsigned char        keystate[256];    /* asynchronous key state */
+    unsigned char       *keystate;         /* asynchronous key state, stored in shared memory */
+    struct object       *shm_mapping;      /* mapping of the shared memory */
+    desktop_shm_t       *shared;           /* state shared with clients */
 };
 
 /* user handles functions */
@@ -251,4 +253,16 @@ static inline user_handle_t get_valid_window_handle( user_handle_t win )
     return 0;
 }
 
+/* start updating shared memory, clients retry their reads while the sequence number is odd */
+static inline void shared_write_begin( volatile int *seq )
+{
+    __atomic_add_fetch( seq, 1, __ATOMIC_SEQ_CST );
+}
+
+/* finish updating shared memory */
+static inline void shared_write_end( volatile int *seq )
+{
+    __atomic_add_fetch( seq, 1, __ATOMIC_SEQ_CST );
+}
+
 #endif  /* __WINE_SERVER_USER_H */
@@ -30,10 +30,12 @@
 #include "ntuser.h"
 
 #include "object.h"
+#include "handle.h"
 #include "request.h"
 #include "thread.h"
 #include "process.h"
 #include "user.h"
+#include "file.h"
 #include "unicode.h"
 
 /* a window property */
@@ -150,6 +152,11 @@ static struct window *shell_listview;
 static struct window *progman_window;
 static struct window *taskman_window;
 
+/* window rectangles shared with clients */
+#define WINDOW_SHM_ENTRIES ((LAST_USER_HANDLE - FIRST_USER_HANDLE + 1) >> 1)
+static struct object *window_shm_mapping;
+static window_shm_t *window_shm;
+
 /* magic HWND_TOP etc. pointers */
 #define WINPTR_TOP       ((struct window *)1L)
 #define WINPTR_BOTTOM    ((struct window *)2L)
@@ -201,6 +208,48 @@ static inline int is_desktop_window( const struct window *win )
     return !win->parent;  /* only desktop windows have no parent */
 }
 
+/* create the window rectangles shared memory on first use */
+static int init_window_shm(void)
+{
+    if (window_shm_mapping) return 1;
+    window_shm_mapping = create_shared_mapping( WINDOW_SHM_ENTRIES * sizeof(*window_shm), (void **)&window_shm );
+    return window_shm_mapping != NULL;
+}
+
+/* publish the window rectangles to the clients */
+static void update_window_shm( struct window *win )
+{
+    window_shm_t *shm;
+    unsigned int flags = 0;
+
+    if (!window_shm) return;
+    shm = &window_shm[((win->handle & 0xffff) - FIRST_USER_HANDLE) >> 1];
+
+    if (win->ex_style & WS_EX_LAYOUTRTL) flags |= WINDOW_SHM_LAYOUTRTL;
+    if (!win->parent || (is_desktop_window( win->parent ) && !(win->parent->ex_style & WS_EX_LAYOUTRTL)))
+        flags |= WINDOW_SHM_TOPLEVEL;
+
+    shared_write_begin( &shm->seq );
+    shm->handle = win->handle;
+    shm->dpi    = win->dpi;
+    shm->flags  = flags;
+    shm->window = win->window_rect;
+    shm->client = win->client_rect;
+    shared_write_end( &shm->seq );
+}
+
+/* remove the window from the shared memory before its handle is freed */
+static void clear_window_shm( struct window *win )
+{
+    window_shm_t *shm;
+
+    if (!window_shm) return;
+    shm = &window_shm[((win->handle & 0xffff) - FIRST_USER_HANDLE) >> 1];
+    shared_write_begin( &shm->seq );
+    shm->handle = 0;
+    shared_write_end( &shm->seq );
+}
+
 /* check if window is orphaned */
 static int is_orphan_window( struct window *win )
 {
@@ -334,6 +383,7 @@ static int set_parent_window( struct window *win, struct window *parent )
             win->dpi = parent->dpi;
             win->dpi_awareness = parent->dpi_awareness;
         }
+        update_window_shm( win );
 
         /* if parent belongs to a different thread and the window isn't */
         /* top-level, attach the two threads */
@@ -1794,8 +1844,10 @@ static void set_window_pos( struct window *win, struct window *previous,
             offset_rect( &child->visible_rect, new_size - old_size, 0 );
             offset_rect( &child->surface_rect, new_size - old_size, 0 );
             offset_rect( &child->client_rect, new_size - old_size, 0 );
+            update_window_shm( child );
         }
     }
+    update_window_shm( win );
 
     /* reset cursor clip rectangle when the desktop changes size */
     if (win == win->desktop->top_window) win->desktop->cursor.clip = *window_rect;
@@ -2011,6 +2063,7 @@ void free_window_handle( struct window *win )
     detach_window_thread( win );
 
     if (win->parent) set_parent_window( win, NULL );
+    clear_window_shm( win );
     free_user_handle( win->handle );
     win->handle = 0;
     release_object( win );
@@ -2066,6 +2119,8 @@ DECL_HANDLER(create_window)
     }
     win->style = req->style;
     win->ex_style = req->ex_style;
+    if (init_window_shm()) update_window_shm( win );
+    else clear_error();
 
     reply->handle    = win->handle;
     reply->parent    = win->parent ? win->parent->handle : 0;
@@ -2244,6 +2299,13 @@ DECL_HANDLER(set_window_info)
         if (!win->is_linked) win->ex_style = req->ex_style;
         else win->ex_style = (req->ex_style & ~WS_EX_TOPMOST) | (win->ex_style & WS_EX_TOPMOST);
         if (!(win->ex_style & WS_EX_LAYERED)) win->is_layered = 0;
+        update_window_shm( win );
+        if (is_desktop_window( win ))
+        {
+            struct window *child;
+            LIST_FOR_EACH_ENTRY( child, &win->children, struct window, entry )
+                update_window_shm( child );
+        }
     }
     if (req->flags & SET_WIN_ID) win->id = req->extra_value;
     if (req->flags & SET_WIN_INSTANCE) win->instance = req->instance;
@@ -2510,6 +2572,14 @@ DECL_HANDLER(get_window_rectangles)
 }
 
 
+/* get a handle to the shared memory holding the window rectangles */
+DECL_HANDLER(get_window_shm)
+{
+    if (!init_window_shm()) return;
+    reply->handle = alloc_handle( current->process, window_shm_mapping, SECTION_MAP_READ | SECTION_QUERY, 0 );
+}
+
+
 /* get the window text */
 DECL_HANDLER(get_window_text)
 {
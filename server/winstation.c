@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <sys/types.h>
+#include <sys/mman.h>
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -200,7 +201,7 @@ static void winstation_destroy( struct object *obj )
     list_remove( &winstation->entry );
     if (winstation->clipboard) release_object( winstation->clipboard );
     if (winstation->atom_table) release_object( winstation->atom_table );
-    free( winstation->desktop_names );
+    free_namespace( winstation->desktop_names );
 }
 
 /* retrieve the process window station, checking the handle access rights */
@@ -236,9 +237,15 @@ static struct desktop *create_desktop( const struct unicode_str *name, unsigned
             desktop->foreground_input = NULL;
             desktop->users = 0;
             memset( &desktop->cursor, 0, sizeof(desktop->cursor) );
-            memset( desktop->keystate, 0, sizeof(desktop->keystate) );
             list_add_tail( &winstation->desktops, &desktop->entry );
             list_init( &desktop->hotkeys );
+            if (!(desktop->shm_mapping = create_shared_mapping( sizeof(*desktop->shared),
+                                                                (void **)&desktop->shared )))
+            {
+                release_object( desktop );
+                return NULL;
+            }
+            desktop->keystate = (unsigned char *)desktop->shared->keystate;
         }
         else clear_error();
     }
@@ -291,6 +298,11 @@ static void desktop_destroy( struct object *obj )
     if (desktop->msg_window) free_window_handle( desktop->msg_window );
     if (desktop->global_hooks) release_object( desktop->global_hooks );
     if (desktop->close_timeout) remove_timeout_user( desktop->close_timeout );
+    if (desktop->shm_mapping)
+    {
+        munmap( (void *)desktop->shared, sizeof(*desktop->shared) );
+        release_object( desktop->shm_mapping );
+    }
     list_remove( &desktop->entry );
     release_object( desktop->winstation );
 }
@@ -604,6 +616,17 @@ DECL_HANDLER(get_thread_desktop)
 }
 
 
+/* get a handle to the shared memory of the thread desktop */
+DECL_HANDLER(get_desktop_shm)
+{
+    struct desktop *desktop;
+
+    if (!(desktop = get_thread_desktop( current, 0 ))) return;
+    reply->handle = alloc_handle( current->process, desktop->shm_mapping, SECTION_MAP_READ | SECTION_QUERY, 0 );
+    release_object( desktop );
+}
+
+
 /* set the thread current desktop */
 DECL_HANDLER(set_thread_desktop)
 {
@@ -31,6 +31,12 @@
 #include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#ifdef HAVE_PTHREAD_H
+# include <pthread.h>
+# define THREAD_LOCAL __thread
+#else
+# define THREAD_LOCAL
+#endif
 
 #include "tools.h"
 #include "wine/list.h"
@@ -58,6 +64,9 @@ struct file
     char              *name;          /* full file name relative to cwd */
     void              *args;          /* custom arguments for makefile rule */
     unsigned int       flags;         /* flags (see below) */
+    unsigned int       parse_flags;   /* flags set by the parser, stored in the cache */
+    time_t             mtime;         /* modification time of the parsed file */
+    off_t              size;          /* size of the parsed file */
     unsigned int       deps_count;    /* files in use */
     unsigned int       deps_size;     /* total allocated size */
     struct dependency *deps;          /* all header dependencies */
@@ -120,6 +129,7 @@ static const struct
 #define HASH_SIZE 197
 
 static struct list files[HASH_SIZE];
+static struct list cached_files[HASH_SIZE];
 static struct list global_includes[HASH_SIZE];
 
 enum install_rules { INSTALL_LIB, INSTALL_DEV, INSTALL_TEST, NB_INSTALL_RULES };
@@ -236,13 +246,18 @@ static struct makefile **submakes;
 
 static const char separator[] = "### Dependencies";
 static const char *output_makefile_name = "Makefile";
-static const char *input_file_name;
+static const char cache_file_name[] = "makedep.cache";
+/* bump this when the parsing of source files or the cache format changes */
+static const char cache_signature[] = "makedep cache 2";
+static const char widl_cache_dir[] = "widl.cache";
+static THREAD_LOCAL const char *input_file_name;
 static const char *output_file_name;
 static const char *temp_file_name;
 static int relative_dir_mode;
 static int silent_rules;
-static int input_line;
+static THREAD_LOCAL int input_line;
 static int output_column;
+static time_t start_time;
 static FILE *output_file;
 
 static const char Usage[] =
@@ -661,8 +676,8 @@ static void strarray_addall_path( struct strarray *array, const char *dir, struc
  */
 static char *get_line( FILE *file )
 {
-    static char *buffer;
-    static size_t size;
+    static THREAD_LOCAL char *buffer;
+    static THREAD_LOCAL size_t size;
 
     if (!size)
     {
@@ -871,18 +886,18 @@ static void parse_include_directive( struct file *source, char *str )
  */
 static void parse_pragma_directive( struct file *source, char *str )
 {
-    char *flag, *p = str;
+    char *flag, *next, *p = str;
 
     if (!isspace( *p )) return;
     while (*p && isspace(*p)) p++;
-    p = strtok( p, " \t" );
+    p = strtok_r( p, " \t", &next );
     if (strcmp( p, "makedep" )) return;
 
-    while ((flag = strtok( NULL, " \t" )))
+    while ((flag = strtok_r( NULL, " \t", &next )))
     {
         if (!strcmp( flag, "depend" ))
         {
-            while ((p = strtok( NULL, " \t" ))) add_dependency( source, p, INCL_NORMAL );
+            while ((p = strtok_r( NULL, " \t", &next ))) add_dependency( source, p, INCL_NORMAL );
             return;
         }
         else if (!strcmp( flag, "install" )) source->flags |= FLAG_INSTALL;
@@ -915,7 +930,7 @@ static void parse_pragma_directive( struct file *source, char *str )
                     *array = empty_strarray;
                     source->flags |= FLAG_SFD_FONTS;
                 }
-                strarray_add( array, xstrdup( strtok( NULL, "" )));
+                strarray_add( array, xstrdup( strtok_r( NULL, "", &next )));
                 return;
             }
         }
@@ -1090,7 +1105,7 @@ static void parse_rc_file( struct file *source, FILE *file )
  */
 static void parse_in_file( struct file *source, FILE *file )
 {
-    char *p, *buffer;
+    char *p, *next, *buffer;
 
     /* make sure it gets rebuilt when the version changes */
     add_dependency( source, "config.h", INCL_SYSTEM );
@@ -1101,9 +1116,9 @@ static void parse_in_file( struct file *source, FILE *file )
     while ((buffer = get_line( file )))
     {
         if (strncmp( buffer, ".TH", 3 )) continue;
-        if (!(p = strtok( buffer, " \t" ))) continue;  /* .TH */
-        if (!(p = strtok( NULL, " \t" ))) continue;  /* program name */
-        if (!(p = strtok( NULL, " \t" ))) continue;  /* man section */
+        if (!(p = strtok_r( buffer, " \t", &next ))) continue;  /* .TH */
+        if (!(p = strtok_r( NULL, " \t", &next ))) continue;  /* program name */
+        if (!(p = strtok_r( NULL, " \t", &next ))) continue;  /* man section */
         source->args = xstrdup( p );
         return;
     }
@@ -1169,21 +1184,21 @@ static const struct
 };
 
 /*******************************************************************
- *         load_file
+ *         parse_input_file
+ *
+ * Parse the dependencies of a file. This may be called from a worker thread.
  */
-static struct file *load_file( const char *name )
+static struct file *parse_input_file( const char *name, const struct stat *st )
 {
     struct file *file;
     FILE *f;
-    unsigned int i, hash = hash_filename( name );
-
-    LIST_FOR_EACH_ENTRY( file, &files[hash], struct file, entry )
-        if (!strcmp( name, file->name )) return file;
+    unsigned int i;
 
     if (!(f = fopen( name, "r" ))) return NULL;
 
     file = add_file( name );
-    list_add_tail( &files[hash], &file->entry );
+    file->mtime = st->st_mtime;
+    file->size = st->st_size;
     input_file_name = file->name;
     input_line = 0;
 
@@ -1196,11 +1211,127 @@ static struct file *load_file( const char *name )
 
     fclose( f );
     input_file_name = NULL;
+    file->parse_flags = file->flags;
+
+    return file;
+}
+
+
+/*******************************************************************
+ *         find_cached_file
+ *
+ * Retrieve a file from the dependency cache if it hasn't been modified since.
+ */
+static struct file *find_cached_file( const char *name, const struct stat *st )
+{
+    struct file *file;
+    unsigned int hash = hash_filename( name );
+
+    LIST_FOR_EACH_ENTRY( file, &cached_files[hash], struct file, entry )
+    {
+        if (strcmp( name, file->name )) continue;
+        list_remove( &file->entry );
+        if (file->mtime != st->st_mtime || file->size != st->st_size) return NULL;
+        return file;
+    }
+    return NULL;
+}
+
+
+/*******************************************************************
+ *         load_file
+ */
+static struct file *load_file( const char *name )
+{
+    struct file *file;
+    struct stat st;
+    unsigned int hash = hash_filename( name );
+
+    LIST_FOR_EACH_ENTRY( file, &files[hash], struct file, entry )
+        if (!strcmp( name, file->name )) return file;
 
+    if (stat( name, &st ) == -1) return NULL;
+    if (!(file = find_cached_file( name, &st )) && !(file = parse_input_file( name, &st ))) return NULL;
+
+    list_add_tail( &files[hash], &file->entry );
     return file;
 }
 
 
+/*******************************************************************
+ *         load_cache
+ *
+ * Load the dependencies parsed by a previous run.
+ */
+static void load_cache( const char *prog )
+{
+    struct file *file = NULL;
+    struct strarray *array;
+    struct stat st, prog_st;
+    char *buffer, *p;
+    FILE *f;
+    unsigned int i;
+
+    /* ignore the cache if makedep itself has been rebuilt since */
+    if (stat( cache_file_name, &st ) == -1) return;
+    if (strchr( prog, '/' ) && !stat( prog, &prog_st ) && prog_st.st_mtime >= st.st_mtime) return;
+
+    if (!(f = fopen( cache_file_name, "r" ))) return;
+
+    input_line = 0;
+    if (!(buffer = get_line( f )) || strcmp( buffer, cache_signature )) goto done;
+
+    while ((buffer = get_line( f )))
+    {
+        if (buffer[0] == 'F' && buffer[1] == ' ')
+        {
+            time_t mtime = strtoll( buffer + 2, &p, 10 );
+            off_t size = strtoll( p, &p, 10 );
+            unsigned int flags = strtoul( p, &p, 10 );
+
+            if (*p++ != ' ' || !*p) goto failed;
+            file = add_file( p );
+            file->mtime = mtime;
+            file->size = size;
+            file->flags = file->parse_flags = flags;
+            list_add_tail( &cached_files[hash_filename( p )], &file->entry );
+        }
+        else if (!file) goto failed;
+        else if (buffer[0] == 'A' && buffer[1] == ' ')
+        {
+            if (file->flags & FLAG_SFD_FONTS)
+            {
+                if (!(array = file->args))
+                {
+                    file->args = array = xmalloc( sizeof(*array) );
+                    *array = empty_strarray;
+                }
+                strarray_add( array, xstrdup( buffer + 2 ));
+            }
+            else file->args = xstrdup( buffer + 2 );
+        }
+        else if (buffer[0] == 'D' && buffer[1] == ' ')
+        {
+            int line = strtol( buffer + 2, &p, 10 );
+            enum incl_type type = strtol( p, &p, 10 );
+
+            if (*p++ != ' ' || !*p) goto failed;
+            add_dependency( file, p, type );
+            file->deps[file->deps_count - 1].line = line;
+        }
+        else goto failed;
+    }
+    goto done;
+
+failed:
+    /* ignore the whole cache if it can't be parsed */
+    for (i = 0; i < HASH_SIZE; i++) list_init( &cached_files[i] );
+done:
+    fclose( f );
+    input_line = 0;
+}
+
+
 /*******************************************************************
  *         open_include_path_file
  *
@@ -2783,6 +2914,7 @@ static void output_source_idl( struct makefile *make, struct incl_file *source,
     output( "\t%s%s -o $@", cmd_prefix( "WIDL" ), tools_path( make, "widl" ) );
     output_filenames( target_flags );
     output_filename( "--nostdinc" );
+    output_filename( strmake( "--import-cache=%s", widl_cache_dir ));
     output_filename( "-Ldlls/\\*" );
     output_filenames( defines );
     output_filenames( get_expanded_make_var_array( make, "EXTRAIDLFLAGS" ));
@@ -3766,7 +3898,10 @@ static void output_sources( struct makefile *make )
     if (make->testdll) strarray_add( &make->distclean_files, "testlist.c" );
 
     if (!make->obj_dir)
+    {
         strarray_addall( &make->distclean_files, get_expanded_make_var_array( make, "CONFIGURE_TARGETS" ));
+        strarray_add( &make->distclean_files, cache_file_name );
+    }
     else if (!strcmp( make->obj_dir, "po" ))
         strarray_add( &make->distclean_files, "LINGUAS" );
 
@@ -4112,30 +4247,176 @@ static void output_dependencies( struct makefile *make )
 }
 
 
+static const char *source_vars[] =
+{
+    "SOURCES",
+    "C_SRCS",
+    "OBJC_SRCS",
+    "RC_SRCS",
+    "MC_SRCS",
+    "IDL_SRCS",
+    "BISON_SRCS",
+    "LEX_SRCS",
+    "HEADER_SRCS",
+    "XTEMPLATE_SRCS",
+    "SVG_SRCS",
+    "FONT_SRCS",
+    "IN_SRCS",
+    "PO_SRCS",
+    "MANPAGES",
+    NULL
+};
+
+#ifdef HAVE_PTHREAD_H
+
+struct prefetch_file
+{
+    const char  *name;
+    struct stat  st;
+    struct file *file;
+};
+
+static struct prefetch_file *prefetch_files;
+static unsigned int prefetch_count;
+static unsigned int prefetch_pos;
+static pthread_mutex_t prefetch_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int cmp_string( const char **a, const char **b )
+{
+    return strcmp( *a, *b );
+}
+
+
+/*******************************************************************
+ *         prefetch_thread
+ */
+static void *prefetch_thread( void *arg )
+{
+    unsigned int i;
+
+    for (;;)
+    {
+        pthread_mutex_lock( &prefetch_mutex );
+        i = prefetch_pos++;
+        pthread_mutex_unlock( &prefetch_mutex );
+        if (i >= prefetch_count) break;
+        prefetch_files[i].file = parse_input_file( prefetch_files[i].name, &prefetch_files[i].st );
+    }
+    return NULL;
+}
+
+
+/*******************************************************************
+ *         prefetch_sources
+ *
+ * Parse the source files of all the makefiles in parallel, so that
+ * load_sources() finds them already loaded.
+ */
+static void prefetch_sources(void)
+{
+    struct strarray value, names = empty_strarray;
+    struct makefile *make;
+    struct file *file;
+    pthread_t *threads;
+    unsigned int i, j, count = 0, nb_threads = 1;
+    const char **var;
+
+#ifdef _SC_NPROCESSORS_ONLN
+    nb_threads = sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+    if (nb_threads <= 1) return;
+    if (nb_threads > 16) nb_threads = 16;
+
+    for (i = 0; i <= subdirs.count; i++)
+    {
+        make = i ? submakes[i - 1] : top_makefile;
+        for (var = source_vars; *var; var++)
+        {
+            value = get_expanded_make_var_array( make, *var );
+            for (j = 0; j < value.count; j++) strarray_add( &names, src_dir_path( make, value.str[j] ));
+        }
+    }
+
+    strarray_qsort( &names, cmp_string );
+    prefetch_files = xmalloc( names.count * sizeof(*prefetch_files) );
+    for (i = 0; i < names.count; i++)
+    {
+        /* files found in the cache are cheap enough to load directly */
+        struct prefetch_file *prefetch = &prefetch_files[count];
+
+        if (i && !strcmp( names.str[i], names.str[i - 1] )) continue;
+        if (stat( names.str[i], &prefetch->st ) == -1) continue;
+        if ((file = find_cached_file( names.str[i], &prefetch->st )))
+        {
+            list_add_tail( &files[hash_filename( file->name )], &file->entry );
+            continue;
+        }
+        prefetch->name = names.str[i];
+        prefetch->file = NULL;
+        count++;
+    }
+    prefetch_count = count;
+    if (nb_threads > count / 16) nb_threads = count / 16 + 1;
+
+    threads = xmalloc( nb_threads * sizeof(*threads) );
+    for (i = 1; i < nb_threads; i++)
+        if (pthread_create( &threads[i], NULL, prefetch_thread, NULL )) break;
+    nb_threads = i;
+    prefetch_thread( NULL );
+    for (i = 1; i < nb_threads; i++) pthread_join( threads[i], NULL );
+    free( threads );
+
+    for (i = 0; i < count; i++)
+        if ((file = prefetch_files[i].file))
+            list_add_tail( &files[hash_filename( file->name )], &file->entry );
+    free( prefetch_files );
+}
+
+#endif  /* HAVE_PTHREAD_H */
+
+
+/*******************************************************************
+ *         save_cache
+ *
+ * Store the dependencies of all the files parsed so far.
+ */
+static void save_cache(void)
+{
+    struct file *file;
+    struct strarray *array;
+    unsigned int i, j;
+    FILE *f = create_temp_file( cache_file_name );
+
+    fprintf( f, "%s\n", cache_signature );
+    for (i = 0; i < HASH_SIZE; i++)
+    {
+        LIST_FOR_EACH_ENTRY( file, &files[i], struct file, entry )
+        {
+            /* the file may have been modified again within the same second */
+            if (file->mtime >= start_time) continue;
+
+            fprintf( f, "F %lld %lld %u %s\n", (long long)file->mtime, (long long)file->size,
+                     file->parse_flags, file->name );
+            if (file->parse_flags & FLAG_SFD_FONTS)
+            {
+                array = file->args;
+                for (j = 0; j < array->count; j++) fprintf( f, "A %s\n", array->str[j] );
+            }
+            else if (file->args) fprintf( f, "A %s\n", (char *)file->args );
+            for (j = 0; j < file->deps_count; j++)
+                fprintf( f, "D %d %d %s\n", file->deps[j].line, file->deps[j].type, file->deps[j].name );
+        }
+    }
+    if (fclose( f )) fatal_perror( "write" );
+    rename_temp_file( cache_file_name );
+}
+
+
 /*******************************************************************
  *         load_sources
  */
 static void load_sources( struct makefile *make )
 {
-    static const char *source_vars[] =
-    {
-        "SOURCES",
-        "C_SRCS",
-        "OBJC_SRCS",
-        "RC_SRCS",
-        "MC_SRCS",
-        "IDL_SRCS",
-        "BISON_SRCS",
-        "LEX_SRCS",
-        "HEADER_SRCS",
-        "XTEMPLATE_SRCS",
-        "SVG_SRCS",
-        "FONT_SRCS",
-        "IN_SRCS",
-        "PO_SRCS",
-        "MANPAGES",
-        NULL
-    };
     const char **var;
     unsigned int i;
     struct strarray value;
@@ -4349,8 +4630,12 @@ int main( int argc, char *argv[] )
 #endif
 
     for (i = 0; i < HASH_SIZE; i++) list_init( &files[i] );
+    for (i = 0; i < HASH_SIZE; i++) list_init( &cached_files[i] );
     for (i = 0; i < HASH_SIZE; i++) list_init( &global_includes[i] );
 
+    start_time = time( NULL );
+    load_cache( argv[0] );
+
     top_makefile = parse_makefile( NULL );
 
     target_flags       = get_expanded_make_var_array( top_makefile, "TARGETFLAGS" );
@@ -4410,6 +4695,9 @@ int main( int argc, char *argv[] )
 
     for (i = 0; i < subdirs.count; i++) submakes[i] = parse_makefile( subdirs.str[i] );
 
+#ifdef HAVE_PTHREAD_H
+    prefetch_sources();
+#endif
     load_sources( top_makefile );
     load_sources( include_makefile );
     for (i = 0; i < subdirs.count; i++)
@@ -4418,5 +4706,6 @@ int main( int argc, char *argv[] )
     output_dependencies( top_makefile );
     for (i = 0; i < subdirs.count; i++) output_dependencies( submakes[i] );
 
+    save_cache();
     return 0;
 }
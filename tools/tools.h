@@ -46,6 +46,7 @@
 #  define strtoull _strtoui64
 #  define strncasecmp _strnicmp
 #  define strcasecmp _stricmp
+#  define strtok_r strtok_s
 # endif
 #else
 # include <sys/wait.h>
@@ -47,6 +47,16 @@ static const var_t *current_func;
 static const type_t *current_iface;
 
 static struct list expr_eval_routines = LIST_INIT(expr_eval_routines);
+
+/* simple pointer descriptions already written, which parameters can share */
+struct simple_pointer_offset
+{
+    unsigned int desc;
+    unsigned int offset;
+};
+static struct simple_pointer_offset *simple_pointer_offsets;
+static unsigned int simple_pointer_count, simple_pointer_size;
+
 struct expr_eval_routine
 {
     struct list   entry;
@@ -2197,8 +2207,9 @@ static unsigned int write_nonsimple_pointer(FILE *file, const attr_list_t *attrs
     return start_offset;
 }
 
-static unsigned int write_simple_pointer(FILE *file, const attr_list_t *attrs,
-                                         const type_t *type, enum type_context context)
+/* returns the pointer, flags and base type bytes of a simple pointer description */
+static unsigned int get_simple_pointer_desc(const attr_list_t *attrs, const type_t *type,
+                                            enum type_context context)
 {
     unsigned char fc;
     unsigned char pointer_fc;
@@ -2207,11 +2218,6 @@ static unsigned int write_simple_pointer(FILE *file, const attr_list_t *attrs,
     int out_attr = is_attr(attrs, ATTR_OUT);
     unsigned char flags = FC_SIMPLE_POINTER;
 
-    /* for historical reasons, write_simple_pointer also handled string types,
-     * but no longer does. catch bad uses of the function with this check */
-    if (is_string_type(attrs, type))
-        error("write_simple_pointer: can't handle type %s which is a string type\n", type->name);
-
     pointer_fc = get_pointer_fc_context(type, attrs, context);
 
     ref = type_pointer_get_ref_type(type);
@@ -2231,6 +2237,25 @@ static unsigned int write_simple_pointer(FILE *file, const attr_list_t *attrs,
             flags |= FC_ALLOCED_ON_STACK;
     }
 
+    return pointer_fc | (flags << 8) | (fc << 16);
+}
+
+static unsigned int write_simple_pointer(FILE *file, const attr_list_t *attrs,
+                                         const type_t *type, enum type_context context)
+{
+    unsigned int desc;
+    unsigned char pointer_fc, flags, fc;
+
+    /* for historical reasons, write_simple_pointer also handled string types,
+     * but no longer does. catch bad uses of the function with this check */
+    if (is_string_type(attrs, type))
+        error("write_simple_pointer: can't handle type %s which is a string type\n", type->name);
+
+    desc = get_simple_pointer_desc(attrs, type, context);
+    pointer_fc = desc & 0xff;
+    flags = (desc >> 8) & 0xff;
+    fc = desc >> 16;
+
     print_file(file, 2, "0x%02x, 0x%x,\t/* %s %s[simple_pointer] */\n",
                pointer_fc, flags, string_of_type(pointer_fc),
                flags & FC_ALLOCED_ON_STACK ? "[allocated_on_stack] " : "");
@@ -2252,13 +2277,38 @@ static unsigned int write_pointer_tfs(FILE *file, const attr_list_t *attrs,
                                       enum type_context context,
                                       unsigned int *typestring_offset)
 {
-    unsigned int offset = *typestring_offset;
+    unsigned int i, desc, offset = *typestring_offset;
     type_t *ref = type_pointer_get_ref_type(type);
+    enum typegen_type ref_type = typegen_detect_type(ref, attrs, TDT_ALL_TYPES);
+
+    /* parameters only refer to their pointer description by offset, so
+     * they can share an identical simple pointer written previously */
+    if ((ref_type == TGT_BASIC || ref_type == TGT_ENUM) &&
+        context != TYPE_CONTEXT_CONTAINER && context != TYPE_CONTEXT_CONTAINER_NO_POINTERS &&
+        !is_string_type(attrs, type))
+    {
+        desc = get_simple_pointer_desc(attrs, type, context);
+        for (i = 0; i < simple_pointer_count; i++)
+        {
+            if (simple_pointer_offsets[i].desc != desc) continue;
+            update_tfsoff(type, simple_pointer_offsets[i].offset, file);
+            return simple_pointer_offsets[i].offset;
+        }
+        if (simple_pointer_count == simple_pointer_size)
+        {
+            simple_pointer_size = max( 16, simple_pointer_size * 2 );
+            simple_pointer_offsets = xrealloc( simple_pointer_offsets,
+                                               simple_pointer_size * sizeof(*simple_pointer_offsets) );
+        }
+        simple_pointer_offsets[simple_pointer_count].desc = desc;
+        simple_pointer_offsets[simple_pointer_count].offset = offset;
+        simple_pointer_count++;
+    }
 
     print_start_tfs_comment(file, type, offset);
     update_tfsoff(type, offset, file);
 
-    switch (typegen_detect_type(ref, attrs, TDT_ALL_TYPES))
+    switch (ref_type)
     {
     case TGT_BASIC:
     case TGT_ENUM:
@@ -3767,6 +3817,8 @@ static void process_tfs_iface(type_t *iface, FILE *file, int indent, unsigned in
 static unsigned int process_tfs(FILE *file, const statement_list_t *stmts, type_pred_t pred)
 {
     unsigned int typeformat_offset = 2;
+
+    simple_pointer_count = 0;
     for_each_iface(stmts, process_tfs_iface, pred, file, 0, &typeformat_offset);
     return typeformat_offset + 1;
 }
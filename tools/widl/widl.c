@@ -55,6 +55,7 @@ static const char usage[] =
 "   -h                 Generate headers\n"
 "   -H file            Name of header file (default is infile.h)\n"
 "   -I directory       Add directory to the include search path (multiple -I allowed)\n"
+"   --import-cache=dir Reuse preprocessed imported files from directory 'dir'\n"
 "   -L directory       Add directory to the library search path (multiple -L allowed)\n"
 "   --local-stubs=file Write empty stubs for call_as/local methods to file\n"
 "   -m32, -m64         Set the target architecture (Win32 or Win64)\n"
@@ -142,6 +143,7 @@ static const char *dlldir;
 static struct strarray dlldirs;
 static char *output_name;
 static const char *sysroot = "";
+static const char *import_cache_dir;
 
 int line_number = 1;
 
@@ -157,6 +159,7 @@ enum {
     APP_CONFIG_OPTION,
     DLLDATA_OPTION,
     DLLDATA_ONLY_OPTION,
+    IMPORT_CACHE_OPTION,
     LOCAL_STUBS_OPTION,
     NOSTDINC_OPTION,
     PREFIX_ALL_OPTION,
@@ -181,6 +184,7 @@ static const struct long_option long_options[] = {
     { "dlldata", 1, DLLDATA_OPTION },
     { "dlldata-only", 0, DLLDATA_ONLY_OPTION },
     { "help", 0, PRINT_HELP },
+    { "import-cache", 1, IMPORT_CACHE_OPTION },
     { "local-stubs", 1, LOCAL_STUBS_OPTION },
     { "nostdinc", 0, NOSTDINC_OPTION },
     { "ns_prefix", 0, RT_NS_PREFIX },
@@ -513,6 +517,9 @@ static void option_callback( int optc, char *optarg )
       do_everything = 0;
       do_dlldata = 1;
       break;
+    case IMPORT_CACHE_OPTION:
+      import_cache_dir = xstrdup(optarg);
+      break;
     case LOCAL_STUBS_OPTION:
       do_everything = 0;
       local_stubs_name = xstrdup(optarg);
@@ -748,6 +755,8 @@ int main(int argc,char *argv[])
       }
   }
 
+  if (import_cache_dir) wpp_set_cache_dir( import_cache_dir, argv[0] );
+
   if (pointer_size)
       set_target_ptr_size( &target, pointer_size );
   else
@@ -56,6 +56,18 @@ struct define
 static struct list cmdline_defines = LIST_INIT( cmdline_defines );
 static struct strarray includes;
 
+/* include file opened while preprocessing, recorded for the output cache */
+struct dependency
+{
+    struct list    entry;
+    char          *name;
+    char          *parent;
+    char          *path;
+    int            type;
+};
+
+static struct list *dependencies;
+
 static char *wpp_lookup(const char *name, int type, const char *parent_name)
 {
     char *cpy;
@@ -329,6 +341,15 @@ void *pp_open_include(const char *name, int type, const char *parent_name, char
     {
         if (pp_status.debug)
             printf("Going to include <%s>\n", path);
+        if (dependencies)
+        {
+            struct dependency *dep = xmalloc( sizeof(*dep) );
+            dep->name   = xstrdup( name );
+            dep->parent = xstrdup( parent_name ? parent_name : "" );
+            dep->path   = xstrdup( path );
+            dep->type   = type && parent_name;
+            list_add_tail( dependencies, &dep->entry );
+        }
         if (newpath) *newpath = path;
         else free( path );
         return fp;
@@ -640,3 +661,263 @@ int wpp_parse( const char *input, FILE *output )
     pp_free_define_state();
     return ret;
 }
+
+
+/*
+ *-------------------------------------------------------------------------
+ * Output cache
+ *
+ * The preprocessed output of a file is stored in the cache directory,
+ * followed by the list of files it was built from with their content
+ * hashes, modification times and sizes, and the offset of that list on
+ * the last line.  The entry is named after a hash of the input name,
+ * include path and defines.  Files whose time and size are unchanged are
+ * not read again, the others must still have the same contents.
+ *-------------------------------------------------------------------------
+ */
+/* bump this when the preprocessor output or the cache format changes */
+static const char cache_signature[] = "#wpp cache 2";
+static const char *cache_dir;
+static time_t cache_min_time;
+
+static unsigned long long hash_data( unsigned long long hash, const void *data, size_t size )
+{
+    const unsigned char *p = data;
+
+    /* FNV-1a hash */
+    while (size--) hash = (hash ^ *p++) * 0x100000001b3ull;
+    return hash;
+}
+
+static unsigned long long hash_string( unsigned long long hash, const char *str )
+{
+    return hash_data( hash, str, strlen(str) + 1 );
+}
+
+static int hash_file( const char *path, unsigned long long *hash )
+{
+    size_t size;
+    void *data;
+
+    if (!(data = read_file( path, &size ))) return 0;
+    *hash = hash_data( 0xcbf29ce484222325ull, data, size );
+    free( data );
+    return 1;
+}
+
+/* write the hash, time and size of a file to a dependency record */
+static int write_file_info( FILE *cache, const char *path )
+{
+    unsigned long long hash;
+    struct stat st;
+
+    if (stat( path, &st ) == -1 || !hash_file( path, &hash )) return 0;
+    /* the file could still change within the same second, so make sure its contents get checked */
+    if (st.st_mtime >= time( NULL )) st.st_mtime = -1;
+    fprintf( cache, "%016llx %lld %lld ", hash, (long long)st.st_mtime, (long long)st.st_size );
+    return 1;
+}
+
+/* parse the hash, time and size of a dependency record, and check them against the file */
+static int check_file_info( char *info, char **end, const char *path )
+{
+    unsigned long long hash, cur_hash;
+    long long mtime, size;
+    struct stat st;
+
+    hash = strtoull( info, &info, 16 );
+    mtime = strtoll( info, &info, 10 );
+    size = strtoll( info, &info, 10 );
+    if (*info++ != ' ') return 0;
+    *end = info;
+    if (!path) return 1;
+    if (stat( path, &st ) == -1) return 0;
+    if (st.st_mtime == mtime && st.st_size == size) return 1;
+    return hash_file( path, &cur_hash ) && cur_hash == hash;
+}
+
+static char *get_cache_name( const char *input )
+{
+    unsigned long long hash = hash_string( 0xcbf29ce484222325ull, cache_signature );
+    struct define *def;
+    int i;
+
+    hash = hash_string( hash, input );
+    for (i = 0; i < includes.count; i++) hash = hash_string( hash, includes.str[i] );
+    LIST_FOR_EACH_ENTRY( def, &cmdline_defines, struct define, entry )
+    {
+        if (!def->value) continue;
+        hash = hash_string( hash, def->name );
+        hash = hash_string( hash, def->value );
+    }
+    return strmake( "%s/%016llx.pp", cache_dir, hash );
+}
+
+/* check that a dependency record still matches the file system */
+static int check_cached_dependency( char *line )
+{
+    char *info, *name, *parent, *path, *end, *found;
+    int type, ret;
+
+    if (line[0] == 'F' && line[1] == ' ')
+    {
+        if (!check_file_info( line + 2, &path, NULL )) return 0;
+        return check_file_info( line + 2, &end, path );
+    }
+    if (line[0] != 'I' || line[1] != ' ') return 0;
+
+    type = strtol( line + 2, &info, 10 );
+    if (*info++ != ' ') return 0;
+    if (!check_file_info( info, &name, NULL )) return 0;
+    if (!(parent = strchr( name, '\t' ))) return 0;
+    *parent++ = 0;
+    if (!(path = strchr( parent, '\t' ))) return 0;
+    *path++ = 0;
+
+    /* the include path lookup must still find the same file */
+    if (!(found = wpp_lookup( name, type, parent ))) return 0;
+    ret = !strcmp( found, path ) && check_file_info( info, &end, path );
+    free( found );
+    return ret;
+}
+
+static int load_cached_output( const char *cache_name, const char *input, FILE *output )
+{
+    char *data, *line, *next, *end;
+    size_t size, offset;
+    struct stat st;
+    int ret = 0;
+
+    /* ignore entries written before the preprocessor was last rebuilt */
+    if (stat( cache_name, &st ) == -1 || st.st_mtime <= cache_min_time) return 0;
+    if (!(data = read_file( cache_name, &size ))) return 0;
+    if (!size || data[size - 1] != '\n') goto done;
+    data[size - 1] = 0;
+
+    for (end = data + size - 1; end > data && end[-1] != '\n'; end--) ;
+    offset = strtoul( end, NULL, 10 );
+    if (offset >= (size_t)(end - data)) goto done;
+    end[-1] = 0;
+
+    line = data + offset;
+    if (!(next = strchr( line, '\n' ))) goto done;
+    *next++ = 0;
+    if (strncmp( line, cache_signature, strlen(cache_signature) )) goto done;
+    if (line[strlen(cache_signature)] != ' ' || strcmp( line + strlen(cache_signature) + 1, input )) goto done;
+
+    for (line = next; line < end; line = next)
+    {
+        if ((next = strchr( line, '\n' ))) *next++ = 0;
+        else next = end;
+        if (!check_cached_dependency( line )) goto done;
+    }
+
+    ret = fwrite( data, 1, offset, output ) == offset;
+
+done:
+    free( data );
+    return ret;
+}
+
+static void free_dependencies( struct list *deps )
+{
+    struct dependency *dep, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE( dep, next, deps, struct dependency, entry )
+    {
+        list_remove( &dep->entry );
+        free( dep->name );
+        free( dep->parent );
+        free( dep->path );
+        free( dep );
+    }
+}
+
+static int write_cache_trailer( FILE *cache, const char *input, struct list *deps )
+{
+    struct dependency *dep;
+    long offset = ftell( cache );
+
+    if (offset == -1) return 0;
+    fprintf( cache, "%s %s\n", cache_signature, input );
+    fprintf( cache, "F " );
+    if (!write_file_info( cache, input )) return 0;
+    fprintf( cache, "%s\n", input );
+    LIST_FOR_EACH_ENTRY( dep, deps, struct dependency, entry )
+    {
+        fprintf( cache, "I %d ", dep->type );
+        if (!write_file_info( cache, dep->path )) return 0;
+        fprintf( cache, "%s\t%s\t%s\n", dep->name, dep->parent, dep->path );
+    }
+    fprintf( cache, "%ld\n", offset );
+    return !ferror( cache );
+}
+
+/* set the directory used by wpp_parse_cached; prog is the path of the running binary */
+void wpp_set_cache_dir( const char *dir, const char *prog )
+{
+    struct stat st;
+
+    cache_dir = dir;
+    if (strchr( prog, '/' ) && !stat( prog, &st )) cache_min_time = st.st_mtime;
+    if (mkdir( dir, 0777 ) == -1 && errno != EEXIST) cache_dir = NULL;
+}
+
+/* preprocess a file, reusing the output of a previous run from the cache directory */
+int wpp_parse_cached( const char *input, FILE *output )
+{
+    struct list deps = LIST_INIT( deps );
+    char *cache_name, *temp_name, buffer[8192];
+    FILE *cache = NULL;
+    long size;
+    int ret, fd, valid;
+
+    if (!cache_dir || !input) return wpp_parse( input, output );
+
+    cache_name = get_cache_name( input );
+    if (load_cached_output( cache_name, input, output ))
+    {
+        free( cache_name );
+        return 0;
+    }
+
+    temp_name = strmake( "%s.tmp%08x", cache_name, getpid() );
+    if ((fd = open( temp_name, O_RDWR | O_CREAT | O_EXCL, 0666 )) != -1 && !(cache = fdopen( fd, "w+" )))
+        close( fd );
+    if (!cache)
+    {
+        free( cache_name );
+        free( temp_name );
+        return wpp_parse( input, output );
+    }
+
+    dependencies = &deps;
+    ret = wpp_parse( input, cache );
+    dependencies = NULL;
+
+    size = ftell( cache );
+    valid = !ret && size != -1 && write_cache_trailer( cache, input, &deps );
+    free_dependencies( &deps );
+
+    /* copy the preprocessed output to the caller */
+    if (!ret)
+    {
+        fseek( cache, 0, SEEK_SET );
+        while (size > 0)
+        {
+            size_t count = fread( buffer, 1, size < sizeof(buffer) ? size : sizeof(buffer), cache );
+            if (!count || fwrite( buffer, 1, count, output ) != count)
+            {
+                ret = 1;
+                break;
+            }
+            size -= count;
+        }
+    }
+
+    if (fclose( cache )) valid = 0;
+    if (!valid || rename( temp_name, cache_name ) == -1) unlink( temp_name );
+    free( cache_name );
+    free( temp_name );
+    return ret;
+}
@@ -31,6 +31,8 @@ extern void wpp_add_include_path( const char *path );
 extern char *wpp_find_include( const char *name, const char *parent_name );
 /* Return value == 0 means successful execution */
 extern int wpp_parse( const char *input, FILE *output );
+extern void wpp_set_cache_dir( const char *dir, const char *prog );
+extern int wpp_parse_cached( const char *input, FILE *output );
 
 struct pp_entry;	/* forward */
 /*